@@ -0,0 +1,557 @@
+#include "artifacts.h"
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "spin.h"
+#include "threads.h"
+#include "timer.h"
+
+// Allocator costs for the patterns hot paths actually produce, so arena and
+// pool replacements can be priced per host.
+//
+// Cases:
+//   alloc_size_sweep         per size class: kOpsPerSample allocations, then
+//                            their frees in allocation order. Sizes sweep
+//                            geometrically; --iters is split evenly across
+//                            them, smallest first.
+//   alloc_producer_consumer  the bench thread allocates `size` bytes and hands
+//                            each block over an SPSC ring to a consumer
+//                            thread that frees it (every free is remote)
+//   alloc_fragmentation      a live set of `live` blocks with random sizes in
+//                            [min_bytes, frag_max_bytes] (log-uniform); each
+//                            op frees a random block and allocates a new
+//                            random size in its place
+//
+// Samples are ns per op, timed over kOpsPerSample ops and rounded: an
+// alloc+free pair for alloc_size_sweep, one allocation for
+// alloc_producer_consumer (the ring push is untimed), one free+allocate
+// replacement for alloc_fragmentation. Every allocation writes its first
+// byte, as callers would.
+//
+// alloc_size_sweep writes sweep.csv:
+//   size_bytes,samples,alloc_p50_ns,free_p50_ns,p50_ns,mean_ns,p99_ns
+// (per op, 2dp; p50/mean/p99 are for the pair).
+//
+// Metrics: rss_growth_kib (resident set at teardown minus before setup, live
+// blocks still held), plus consumer_free_ns and frees_per_sec for
+// alloc_producer_consumer and live_kib (requested bytes in the live set) for
+// alloc_fragmentation.
+//
+// Params:
+//   allocator=malloc|new|pmr_pool|pmr_monotonic
+//                              malloc/free (default), ::operator new/delete,
+//                              std::pmr pool resource (synchronized for
+//                              alloc_producer_consumer, unsynchronized
+//                              otherwise), or a std::pmr monotonic buffer
+//                              released outside the samples every
+//                              kMonotonicReleaseBytes (alloc_size_sweep only)
+//   min_bytes=<n>              smallest size (default 8)
+//   max_kib=<n>                alloc_size_sweep largest size (default 1024,
+//                              past glibc's default mmap threshold)
+//   per_octave=<n>             alloc_size_sweep sizes per doubling (default 1)
+//   size=<n>                   alloc_producer_consumer block size (default 64)
+//   live=<n>                   alloc_fragmentation live blocks (default 65536)
+//   frag_max_bytes=<n>         alloc_fragmentation largest size (default 4096)
+//   cpus=<list>                producer/consumer CPUs, see thread_cpus()
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kOpsPerSample = 32;
+constexpr uint64_t kMonotonicReleaseBytes = 64u << 20;
+constexpr size_t kRingSlots = 4096;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "alloc: " << message << "\n";
+  std::exit(1);
+}
+
+enum class Pattern {
+  kSizeSweep,
+  kProducerConsumer,
+  kFragmentation,
+};
+
+class Allocator {
+ public:
+  virtual ~Allocator() = default;
+  virtual void* allocate(size_t bytes) = 0;
+  virtual void deallocate(void* p, size_t bytes) = 0;
+  // Untimed housekeeping between samples.
+  virtual void between_samples() {}
+};
+
+class MallocAllocator final : public Allocator {
+ public:
+  void* allocate(size_t bytes) override {
+    void* p = std::malloc(bytes);
+    if (p == nullptr) {
+      fail("malloc failed");
+    }
+    return p;
+  }
+  void deallocate(void* p, size_t) override { std::free(p); }
+};
+
+class NewAllocator final : public Allocator {
+ public:
+  void* allocate(size_t bytes) override { return ::operator new(bytes); }
+  void deallocate(void* p, size_t) override { ::operator delete(p); }
+};
+
+class ResourceAllocator final : public Allocator {
+ public:
+  explicit ResourceAllocator(std::unique_ptr<std::pmr::memory_resource> r)
+      : resource_(std::move(r)) {}
+  void* allocate(size_t bytes) override {
+    return resource_->allocate(bytes, alignof(std::max_align_t));
+  }
+  void deallocate(void* p, size_t bytes) override {
+    resource_->deallocate(p, bytes, alignof(std::max_align_t));
+  }
+
+ private:
+  std::unique_ptr<std::pmr::memory_resource> resource_;
+};
+
+class MonotonicAllocator final : public Allocator {
+ public:
+  void* allocate(size_t bytes) override {
+    used_ += bytes;
+    return resource_.allocate(bytes, alignof(std::max_align_t));
+  }
+  void deallocate(void*, size_t) override {}
+  void between_samples() override {
+    if (used_ >= kMonotonicReleaseBytes) {
+      resource_.release();
+      used_ = 0;
+    }
+  }
+
+ private:
+  std::pmr::monotonic_buffer_resource resource_;
+  uint64_t used_ = 0;
+};
+
+struct SizeResult {
+  uint64_t size = 0;
+  std::vector<double> alloc_ns;
+  std::vector<double> free_ns;
+  std::vector<double> pair_ns;
+};
+
+// Single-producer/single-consumer block handoff.
+struct Ring {
+  alignas(64) std::atomic<uint64_t> head{0};  // next slot to fill
+  alignas(64) std::atomic<uint64_t> tail{0};  // next slot to drain
+  alignas(64) void* slots[kRingSlots] = {};
+};
+
+struct AllocState {
+  Pattern pattern = Pattern::kSizeSweep;
+  std::unique_ptr<Allocator> allocator;
+  uint64_t rss_before = 0;
+  void* blocks[kOpsPerSample] = {};
+
+  // alloc_size_sweep
+  std::vector<SizeResult> sizes;
+  uint64_t per_size = 1;
+  uint64_t measured = 0;
+
+  // alloc_producer_consumer
+  size_t size = 64;
+  Ring ring;
+  std::thread consumer;
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> frees{0};
+  std::atomic<uint64_t> free_ns{0};
+  bool window_open = false;
+  uint64_t window_start_ns = 0;
+  uint64_t window_start_frees = 0;
+
+  // alloc_fragmentation
+  std::vector<void*> live;
+  std::vector<uint32_t> live_sizes;
+  uint64_t live_bytes = 0;
+  uint64_t min_bytes = 8;
+  uint64_t frag_max_bytes = 4096;
+  std::mt19937_64 rng{0xa110c};
+};
+
+std::unique_ptr<AllocState> g_state;
+void* volatile g_sink = nullptr;
+
+uint64_t resident_bytes() {
+#if defined(__linux__)
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  statm >> size >> resident;
+  return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 0;
+#endif
+}
+
+inline void* touch(void* p) {
+  *static_cast<volatile char*>(p) = 1;
+  return p;
+}
+
+size_t random_size(AllocState& state) {
+  const double low = std::log(static_cast<double>(state.min_bytes));
+  const double high = std::log(static_cast<double>(state.frag_max_bytes));
+  std::uniform_real_distribution<double> pick(low, high);
+  return static_cast<size_t>(std::exp(pick(state.rng)));
+}
+
+void consumer_loop(AllocState* state) {
+  Ring& ring = state->ring;
+  uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+  while (true) {
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    if (head == tail) {
+      if (state->stop.load(std::memory_order_relaxed)) {
+        return;
+      }
+      cpu_relax();
+      continue;
+    }
+    const uint64_t start = now_ns();
+    const uint64_t count = head - tail;
+    for (; tail != head; ++tail) {
+      state->allocator->deallocate(ring.slots[tail % kRingSlots],
+                                   state->size);
+    }
+    const uint64_t elapsed = now_ns() - start;
+    ring.tail.store(tail, std::memory_order_release);
+    state->free_ns.store(state->free_ns.load(std::memory_order_relaxed) +
+                             elapsed,
+                         std::memory_order_relaxed);
+    state->frees.store(state->frees.load(std::memory_order_relaxed) + count,
+                       std::memory_order_relaxed);
+  }
+}
+
+std::unique_ptr<Allocator> make_allocator(Ctx* ctx, Pattern pattern) {
+  const std::string choice =
+      param_choice(*ctx, "allocator",
+                   {"malloc", "new", "pmr_pool", "pmr_monotonic"}, "malloc");
+  if (choice == "malloc") {
+    return std::make_unique<MallocAllocator>();
+  }
+  if (choice == "new") {
+    return std::make_unique<NewAllocator>();
+  }
+  if (choice == "pmr_pool") {
+    if (pattern == Pattern::kProducerConsumer) {
+      return std::make_unique<ResourceAllocator>(
+          std::make_unique<std::pmr::synchronized_pool_resource>());
+    }
+    return std::make_unique<ResourceAllocator>(
+        std::make_unique<std::pmr::unsynchronized_pool_resource>());
+  }
+  if (pattern != Pattern::kSizeSweep) {
+    ctx->skip_reason =
+        "allocator=pmr_monotonic never frees; use it with alloc_size_sweep";
+    return nullptr;
+  }
+  return std::make_unique<MonotonicAllocator>();
+}
+
+void alloc_setup(Ctx* ctx, Pattern pattern) {
+  auto state = std::make_unique<AllocState>();
+  state->pattern = pattern;
+  state->rss_before = resident_bytes();
+  state->allocator = make_allocator(ctx, pattern);
+  if (!state->allocator) {
+    return;
+  }
+  state->min_bytes = std::max<uint64_t>(1, param_u64(*ctx, "min_bytes", 8));
+
+  if (pattern == Pattern::kSizeSweep) {
+    const uint64_t max_bytes =
+        std::max<uint64_t>(1, param_u64(*ctx, "max_kib", 1024)) << 10;
+    const uint64_t per_octave =
+        std::max<uint64_t>(1, param_u64(*ctx, "per_octave", 1));
+    for (double size = static_cast<double>(state->min_bytes);
+         size <= static_cast<double>(max_bytes) * 1.0001;
+         size *= std::pow(2.0, 1.0 / static_cast<double>(per_octave))) {
+      const uint64_t bytes = static_cast<uint64_t>(size);
+      if (state->sizes.empty() || state->sizes.back().size != bytes) {
+        state->sizes.push_back(SizeResult{bytes, {}, {}, {}});
+      }
+    }
+    if (state->sizes.empty()) {
+      fail("min_bytes exceeds max_kib");
+    }
+    state->per_size = std::max<uint64_t>(1, ctx->iters / state->sizes.size());
+  } else if (pattern == Pattern::kProducerConsumer) {
+    state->size = std::max<uint64_t>(1, param_u64(*ctx, "size", 64));
+    const std::vector<int> cpus = thread_cpus(*ctx, 2);
+    std::string error;
+    if (cpus[0] >= 0 && !pin_to_cpu(cpus[0], &error)) {
+      fail("failed to pin to cpu " + std::to_string(cpus[0]) + ": " + error);
+    }
+    AllocState* raw = state.get();
+    if (!start_pinned_thread(
+            cpus[1], [raw]() { consumer_loop(raw); }, &state->consumer,
+            &error)) {
+      fail("failed to start consumer: " + error);
+    }
+  } else {
+    const uint64_t live =
+        std::max<uint64_t>(1, param_u64(*ctx, "live", 65536));
+    state->frag_max_bytes = std::max<uint64_t>(
+        state->min_bytes, param_u64(*ctx, "frag_max_bytes", 4096));
+    state->live.resize(live);
+    state->live_sizes.resize(live);
+    for (size_t i = 0; i < live; ++i) {
+      const size_t bytes = random_size(*state);
+      state->live[i] = touch(state->allocator->allocate(bytes));
+      state->live_sizes[i] = static_cast<uint32_t>(bytes);
+      state->live_bytes += bytes;
+    }
+  }
+  g_state = std::move(state);
+}
+
+void sweep_run_once(Ctx* ctx, AllocState& state) {
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_size,
+                              state.sizes.size() - 1);
+  }
+  const size_t bytes = state.sizes[target].size;
+  Allocator& allocator = *state.allocator;
+
+  const uint64_t start = now_ns();
+  for (uint64_t i = 0; i < kOpsPerSample; ++i) {
+    state.blocks[i] = touch(allocator.allocate(bytes));
+  }
+  const uint64_t allocated = now_ns();
+  for (uint64_t i = 0; i < kOpsPerSample; ++i) {
+    allocator.deallocate(state.blocks[i], bytes);
+  }
+  const uint64_t end = now_ns();
+  g_sink = state.blocks[0];
+
+  const double per_pair =
+      static_cast<double>(end - start) / static_cast<double>(kOpsPerSample);
+  record_sample(ctx, static_cast<uint64_t>(std::llround(per_pair)));
+  if (ctx->warming_up) {
+    return;
+  }
+  SizeResult& result = state.sizes[target];
+  result.alloc_ns.push_back(static_cast<double>(allocated - start) /
+                            static_cast<double>(kOpsPerSample));
+  result.free_ns.push_back(static_cast<double>(end - allocated) /
+                           static_cast<double>(kOpsPerSample));
+  result.pair_ns.push_back(per_pair);
+  ++state.measured;
+}
+
+void producer_run_once(Ctx* ctx, AllocState& state) {
+  if (!ctx->warming_up && !state.window_open) {
+    state.window_open = true;
+    state.window_start_ns = now_ns();
+    state.window_start_frees = state.frees.load(std::memory_order_relaxed);
+  }
+  Allocator& allocator = *state.allocator;
+  const uint64_t start = now_ns();
+  for (uint64_t i = 0; i < kOpsPerSample; ++i) {
+    state.blocks[i] = touch(allocator.allocate(state.size));
+  }
+  const uint64_t elapsed = now_ns() - start;
+
+  Ring& ring = state.ring;
+  uint64_t head = ring.head.load(std::memory_order_relaxed);
+  for (uint64_t i = 0; i < kOpsPerSample; ++i) {
+    while (head - ring.tail.load(std::memory_order_acquire) >= kRingSlots) {
+      cpu_relax();
+    }
+    ring.slots[head % kRingSlots] = state.blocks[i];
+    ++head;
+    ring.head.store(head, std::memory_order_release);
+  }
+  record_sample(ctx, static_cast<uint64_t>(std::llround(
+                         static_cast<double>(elapsed) /
+                         static_cast<double>(kOpsPerSample))));
+}
+
+void fragmentation_run_once(Ctx* ctx, AllocState& state) {
+  // Victims and new sizes are drawn outside the timed region.
+  size_t victims[kOpsPerSample];
+  size_t sizes[kOpsPerSample];
+  std::uniform_int_distribution<size_t> pick(0, state.live.size() - 1);
+  for (uint64_t i = 0; i < kOpsPerSample; ++i) {
+    victims[i] = pick(state.rng);
+    sizes[i] = random_size(state);
+  }
+  Allocator& allocator = *state.allocator;
+  const uint64_t start = now_ns();
+  for (uint64_t i = 0; i < kOpsPerSample; ++i) {
+    const size_t slot = victims[i];
+    allocator.deallocate(state.live[slot], state.live_sizes[slot]);
+    state.live[slot] = touch(allocator.allocate(sizes[i]));
+  }
+  const uint64_t elapsed = now_ns() - start;
+  for (uint64_t i = 0; i < kOpsPerSample; ++i) {
+    const size_t slot = victims[i];
+    state.live_bytes += sizes[i];
+    state.live_bytes -= state.live_sizes[slot];
+    state.live_sizes[slot] = static_cast<uint32_t>(sizes[i]);
+  }
+  record_sample(ctx, static_cast<uint64_t>(std::llround(
+                         static_cast<double>(elapsed) /
+                         static_cast<double>(kOpsPerSample))));
+}
+
+void alloc_run_once(Ctx* ctx) {
+  AllocState& state = *g_state;
+  state.allocator->between_samples();
+  switch (state.pattern) {
+    case Pattern::kSizeSweep:
+      sweep_run_once(ctx, state);
+      break;
+    case Pattern::kProducerConsumer:
+      producer_run_once(ctx, state);
+      break;
+    case Pattern::kFragmentation:
+      fragmentation_run_once(ctx, state);
+      break;
+  }
+}
+
+double quantile(const std::vector<double>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return quantile(values, 0.50);
+}
+
+std::string format_sweep(const AllocState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "size_bytes,samples,alloc_p50_ns,free_p50_ns,p50_ns,mean_ns,"
+         "p99_ns\n";
+  for (const SizeResult& result : state.sizes) {
+    if (result.pair_ns.empty()) {
+      continue;
+    }
+    std::vector<double> sorted = result.pair_ns;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) {
+      sum += v;
+    }
+    out << result.size << "," << sorted.size() << ","
+        << median(result.alloc_ns) << "," << median(result.free_ns) << ","
+        << quantile(sorted, 0.50) << ","
+        << sum / static_cast<double>(sorted.size()) << ","
+        << quantile(sorted, 0.99) << "\n";
+  }
+  return out.str();
+}
+
+void alloc_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  AllocState& state = *g_state;
+  const uint64_t end_ns = now_ns();
+  const uint64_t rss_after = resident_bytes();
+  record_metric(ctx, "rss_growth_kib",
+                (static_cast<double>(rss_after) -
+                 static_cast<double>(state.rss_before)) /
+                    1024.0);
+
+  if (state.pattern == Pattern::kSizeSweep) {
+    std::string error;
+    if (state.measured > 0 &&
+        !write_artifact(ctx, "sweep.csv", format_sweep(state), &error)) {
+      std::cerr << "alloc: failed to write sweep.csv: " << error << "\n";
+    }
+  } else if (state.pattern == Pattern::kProducerConsumer) {
+    state.stop.store(true, std::memory_order_relaxed);
+    if (state.consumer.joinable()) {
+      state.consumer.join();
+    }
+    const uint64_t frees = state.frees.load(std::memory_order_relaxed);
+    if (frees > 0) {
+      record_metric(ctx, "consumer_free_ns",
+                    static_cast<double>(state.free_ns.load()) /
+                        static_cast<double>(frees));
+    }
+    if (state.window_open && end_ns > state.window_start_ns) {
+      record_metric(
+          ctx, "frees_per_sec",
+          static_cast<double>(frees - state.window_start_frees) /
+              (static_cast<double>(end_ns - state.window_start_ns) / 1e9));
+    }
+    restore_affinity(*ctx);
+  } else {
+    record_metric(ctx, "live_kib",
+                  static_cast<double>(state.live_bytes) / 1024.0);
+    for (size_t i = 0; i < state.live.size(); ++i) {
+      state.allocator->deallocate(state.live[i], state.live_sizes[i]);
+    }
+  }
+  g_state.reset();
+}
+
+template <Pattern P>
+void setup_for(Ctx* ctx) {
+  alloc_setup(ctx, P);
+}
+
+const Case kAllocSizeSweepCase{
+    "alloc_size_sweep",
+    setup_for<Pattern::kSizeSweep>,
+    alloc_run_once,
+    alloc_teardown,
+};
+
+const Case kAllocProducerConsumerCase{
+    "alloc_producer_consumer",
+    setup_for<Pattern::kProducerConsumer>,
+    alloc_run_once,
+    alloc_teardown,
+};
+
+const Case kAllocFragmentationCase{
+    "alloc_fragmentation",
+    setup_for<Pattern::kFragmentation>,
+    alloc_run_once,
+    alloc_teardown,
+};
+
+}  // namespace
+
+LATENCY_LAB_REGISTER_CASE(kAllocSizeSweepCase);
+LATENCY_LAB_REGISTER_CASE(kAllocProducerConsumerCase);
+LATENCY_LAB_REGISTER_CASE(kAllocFragmentationCase);
@@ -0,0 +1,237 @@
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "threads.h"
+#include "timer.h"
+
+// Atomic read-modify-write and store cost under contention. The bench thread
+// and `threads - 1` workers hammer the same operation on per-thread counters;
+// `layout` decides where those counters live:
+//   shared  counters packed next to each other, 8 per cache line, so threads
+//           only contend through false sharing (default)
+//   padded  one cache line per counter: no sharing at all
+//   same    every thread on one word: true sharing
+//
+// Cases: atomic_fetch_add, atomic_cas_loop, atomic_exchange,
+//        atomic_store_seq_cst, atomic_store_relaxed
+//
+// Params:
+//   threads=<n>                  threads including the bench thread (default 1)
+//   layout=shared|padded|same    see above
+//   cpus=<list>                  see thread_cpus() in placement.h
+//
+// Samples are batched (kAtomicBatch ops per sample, per-op average). The
+// ops_per_sec metric sums all threads over the timed window.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kAtomicBatch = 64;
+// Worker ops between publishing their progress counter.
+constexpr uint64_t kWorkerChunk = 256;
+
+enum class Op {
+  kFetchAdd,
+  kCasLoop,
+  kExchange,
+  kStoreSeqCst,
+  kStoreRelaxed,
+};
+
+template <Op O>
+inline void apply(std::atomic<uint64_t>* word, uint64_t value) {
+  if constexpr (O == Op::kFetchAdd) {
+    word->fetch_add(1, std::memory_order_relaxed);
+  } else if constexpr (O == Op::kCasLoop) {
+    uint64_t seen = word->load(std::memory_order_relaxed);
+    while (!word->compare_exchange_weak(seen, seen + 1,
+                                        std::memory_order_relaxed)) {
+    }
+  } else if constexpr (O == Op::kExchange) {
+    word->exchange(value, std::memory_order_relaxed);
+  } else if constexpr (O == Op::kStoreSeqCst) {
+    word->store(value, std::memory_order_seq_cst);
+  } else {
+    word->store(value, std::memory_order_relaxed);
+  }
+}
+
+struct alignas(64) Line {
+  std::atomic<uint64_t> words[8];
+};
+
+struct alignas(64) Progress {
+  std::atomic<uint64_t> ops{0};
+};
+
+struct AtomicsState {
+  std::vector<Line> lines;
+  std::vector<std::atomic<uint64_t>*> targets;  // per thread
+  std::vector<Progress> progress;               // per worker (index 0 unused)
+  std::vector<std::thread> workers;
+  std::atomic<bool> stop{false};
+  uint64_t bench_ops = 0;
+  bool window_open = false;
+  uint64_t window_start_ns = 0;
+  uint64_t window_start_ops = 0;
+};
+
+std::unique_ptr<AtomicsState> g_state;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "atomics: " << message << "\n";
+  std::exit(1);
+}
+
+template <Op O>
+void worker_loop(AtomicsState* state, size_t index) {
+  std::atomic<uint64_t>* word = state->targets[index];
+  uint64_t done = 0;
+  while (!state->stop.load(std::memory_order_relaxed)) {
+    for (uint64_t i = 0; i < kWorkerChunk; ++i) {
+      apply<O>(word, done + i);
+    }
+    done += kWorkerChunk;
+    state->progress[index].ops.store(done, std::memory_order_relaxed);
+  }
+}
+
+uint64_t total_ops(const AtomicsState& state) {
+  uint64_t total = state.bench_ops;
+  for (const Progress& progress : state.progress) {
+    total += progress.ops.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+template <Op O>
+void atomics_setup(Ctx* ctx) {
+  auto state = std::make_unique<AtomicsState>();
+  const uint64_t threads =
+      std::max<uint64_t>(1, param_u64(*ctx, "threads", 1));
+  const std::string layout =
+      param_choice(*ctx, "layout", {"shared", "padded", "same"}, "shared");
+
+  state->lines = std::vector<Line>(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    std::atomic<uint64_t>* word = &state->lines[0].words[0];
+    if (layout == "shared") {
+      word = &state->lines[i / 8].words[i % 8];
+    } else if (layout == "padded") {
+      word = &state->lines[i].words[0];
+    }
+    state->targets.push_back(word);
+  }
+  state->progress = std::vector<Progress>(threads);
+
+  const std::vector<int> cpus = thread_cpus(*ctx, threads);
+  std::string error;
+  if (cpus[0] >= 0 && !pin_to_cpu(cpus[0], &error)) {
+    fail("failed to pin to cpu " + std::to_string(cpus[0]) + ": " + error);
+  }
+  AtomicsState* raw = state.get();
+  state->workers.resize(threads - 1);
+  for (size_t i = 1; i < threads; ++i) {
+    if (!start_pinned_thread(
+            cpus[i], [raw, i]() { worker_loop<O>(raw, i); },
+            &state->workers[i - 1], &error)) {
+      fail("failed to start worker: " + error);
+    }
+  }
+  g_state = std::move(state);
+}
+
+template <Op O>
+void atomics_run_once(Ctx* ctx) {
+  AtomicsState& state = *g_state;
+  if (!ctx->warming_up && !state.window_open) {
+    state.window_open = true;
+    state.window_start_ns = now_ns();
+    state.window_start_ops = total_ops(state);
+  }
+  apply<O>(state.targets[0], state.bench_ops);
+  ++state.bench_ops;
+}
+
+void atomics_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  AtomicsState& state = *g_state;
+  const uint64_t end_ns = now_ns();
+  const uint64_t end_ops = total_ops(state);
+  state.stop.store(true, std::memory_order_relaxed);
+  for (std::thread& worker : state.workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  if (state.window_open && end_ns > state.window_start_ns) {
+    const double seconds =
+        static_cast<double>(end_ns - state.window_start_ns) / 1e9;
+    record_metric(ctx, "ops_per_sec",
+                  static_cast<double>(end_ops - state.window_start_ops) /
+                      seconds);
+  }
+  restore_affinity(*ctx);
+  g_state.reset();
+}
+
+const Case kAtomicFetchAddCase{
+    "atomic_fetch_add",
+    atomics_setup<Op::kFetchAdd>,
+    atomics_run_once<Op::kFetchAdd>,
+    atomics_teardown,
+    kAtomicBatch,
+};
+
+const Case kAtomicCasLoopCase{
+    "atomic_cas_loop",
+    atomics_setup<Op::kCasLoop>,
+    atomics_run_once<Op::kCasLoop>,
+    atomics_teardown,
+    kAtomicBatch,
+};
+
+const Case kAtomicExchangeCase{
+    "atomic_exchange",
+    atomics_setup<Op::kExchange>,
+    atomics_run_once<Op::kExchange>,
+    atomics_teardown,
+    kAtomicBatch,
+};
+
+const Case kAtomicStoreSeqCstCase{
+    "atomic_store_seq_cst",
+    atomics_setup<Op::kStoreSeqCst>,
+    atomics_run_once<Op::kStoreSeqCst>,
+    atomics_teardown,
+    kAtomicBatch,
+};
+
+const Case kAtomicStoreRelaxedCase{
+    "atomic_store_relaxed",
+    atomics_setup<Op::kStoreRelaxed>,
+    atomics_run_once<Op::kStoreRelaxed>,
+    atomics_teardown,
+    kAtomicBatch,
+};
+
+}  // namespace
+
+LATENCY_LAB_REGISTER_CASE(kAtomicFetchAddCase);
+LATENCY_LAB_REGISTER_CASE(kAtomicCasLoopCase);
+LATENCY_LAB_REGISTER_CASE(kAtomicExchangeCase);
+LATENCY_LAB_REGISTER_CASE(kAtomicStoreSeqCstCase);
+LATENCY_LAB_REGISTER_CASE(kAtomicStoreRelaxedCase);
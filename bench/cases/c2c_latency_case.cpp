@@ -0,0 +1,242 @@
+#include "artifacts.h"
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "spin.h"
+#include "stats.h"
+#include "threads.h"
+#include "timer.h"
+
+// Core-to-core cache-line handoff latency.
+//
+// For each pair of CPUs (a, b), the bench thread is pinned to a and a
+// responder thread to b; they bounce a sequence number through one atomic
+// cache line. Each sample is a full round trip (two line transfers).
+//
+// --iters is split evenly across pairs, in pair order, so raw.csv holds every
+// pair's samples back to back. Per-pair quantiles go to matrix.csv:
+//   cpu_a,cpu_b,samples,min,p50,p95,p99,p999,max,mean
+// with one row per measured pair (cpu_a < cpu_b); latency is symmetric, so
+// tools mirror it into an N x N matrix.
+//
+// Params:
+//   cpus=<list>   CPUs to include (default: the affinity mask before --pin)
+//   anchor=<cpu>  only measure pairs that include this CPU
+//
+// The case moves the bench thread between CPUs, so --pin only affects setup.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+#if defined(__linux__)
+
+// Untimed round trips after moving to a new pair, so the first samples do not
+// include cold caches or the responder thread starting up.
+constexpr uint64_t kPairWarmupRoundTrips = 256;
+constexpr uint64_t kStop = std::numeric_limits<uint64_t>::max();
+
+struct alignas(64) SharedLine {
+  std::atomic<uint64_t> seq{0};
+};
+
+struct C2cState {
+  std::vector<std::pair<int, int>> pairs;
+  std::vector<std::vector<uint64_t>> pair_samples;
+  uint64_t per_pair = 1;
+  uint64_t measured = 0;
+  size_t active_pair = 0;
+  bool pair_running = false;
+  uint64_t next_ping = 1;
+  SharedLine line;
+  std::thread responder;
+};
+
+std::unique_ptr<C2cState> g_state;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "c2c_latency: " << message << "\n";
+  std::exit(1);
+}
+
+// Responder: wait for an odd ping, answer with the next even value.
+void responder_loop(SharedLine* line) {
+  uint64_t expect = 1;
+  while (true) {
+    uint64_t value = line->seq.load(std::memory_order_acquire);
+    while (value != expect) {
+      if (value == kStop) {
+        return;
+      }
+      cpu_relax();
+      value = line->seq.load(std::memory_order_acquire);
+    }
+    line->seq.store(expect + 1, std::memory_order_release);
+    expect += 2;
+  }
+}
+
+uint64_t round_trip(C2cState& state) {
+  const uint64_t ping = state.next_ping;
+  const uint64_t start = now_ns();
+  state.line.seq.store(ping, std::memory_order_release);
+  while (state.line.seq.load(std::memory_order_acquire) != ping + 1) {
+    cpu_relax();
+  }
+  const uint64_t end = now_ns();
+  state.next_ping = ping + 2;
+  return end - start;
+}
+
+void stop_pair(C2cState& state) {
+  if (!state.pair_running) {
+    return;
+  }
+  state.line.seq.store(kStop, std::memory_order_release);
+  state.responder.join();
+  state.pair_running = false;
+}
+
+void start_pair(C2cState& state, size_t index) {
+  stop_pair(state);
+  const auto [cpu_a, cpu_b] = state.pairs[index];
+
+  std::string error;
+  if (!pin_to_cpu(cpu_a, &error)) {
+    fail("failed to pin to cpu " + std::to_string(cpu_a) + ": " + error);
+  }
+
+  state.line.seq.store(0, std::memory_order_relaxed);
+  state.next_ping = 1;
+
+  if (!start_pinned_thread(
+          cpu_b, [line = &state.line]() { responder_loop(line); },
+          &state.responder, &error)) {
+    fail("failed to start responder: " + error);
+  }
+
+  state.active_pair = index;
+  state.pair_running = true;
+  for (uint64_t i = 0; i < kPairWarmupRoundTrips; ++i) {
+    round_trip(state);
+  }
+}
+
+void c2c_setup(Ctx* ctx) {
+  auto state = std::make_unique<C2cState>();
+
+  std::vector<int> cpus = param_cpu_list(*ctx, "cpus");
+  if (cpus.empty()) {
+    cpus = ctx->allowed_cpus;
+  }
+  const uint64_t no_anchor = std::numeric_limits<uint64_t>::max();
+  const uint64_t anchor = param_u64(*ctx, "anchor", no_anchor);
+
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    for (size_t j = i + 1; j < cpus.size(); ++j) {
+      if (anchor != no_anchor && static_cast<uint64_t>(cpus[i]) != anchor &&
+          static_cast<uint64_t>(cpus[j]) != anchor) {
+        continue;
+      }
+      state->pairs.emplace_back(cpus[i], cpus[j]);
+    }
+  }
+  if (state->pairs.empty()) {
+    ctx->skip_reason = "needs at least two cpus to form a pair";
+    return;
+  }
+
+  state->pair_samples.resize(state->pairs.size());
+  state->per_pair = ctx->iters / state->pairs.size();
+  if (state->per_pair == 0) {
+    state->per_pair = 1;
+  }
+  for (auto& samples : state->pair_samples) {
+    samples.reserve(static_cast<size_t>(state->per_pair));
+  }
+  g_state = std::move(state);
+}
+
+void c2c_run_once(Ctx* ctx) {
+  C2cState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    // Leftover iterations (iters not divisible by pairs) go to the last pair.
+    target = static_cast<size_t>(state.measured / state.per_pair);
+    if (target >= state.pairs.size()) {
+      target = state.pairs.size() - 1;
+    }
+  }
+  if (!state.pair_running || target != state.active_pair) {
+    start_pair(state, target);
+  }
+
+  const uint64_t ns = round_trip(state);
+  if (ctx->warming_up) {
+    return;
+  }
+  state.pair_samples[target].push_back(ns);
+  ++state.measured;
+  record_sample(ctx, ns);
+}
+
+std::string format_matrix(const C2cState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "cpu_a,cpu_b,samples,min,p50,p95,p99,p999,max,mean\n";
+  for (size_t i = 0; i < state.pairs.size(); ++i) {
+    const auto& samples = state.pair_samples[i];
+    if (samples.empty()) {
+      continue;
+    }
+    const Quantiles q = compute_quantiles(samples);
+    out << state.pairs[i].first << "," << state.pairs[i].second << ","
+        << samples.size() << "," << q.min << "," << q.p50 << "," << q.p95
+        << "," << q.p99 << "," << q.p999 << "," << q.max << "," << q.mean
+        << "\n";
+  }
+  return out.str();
+}
+
+void c2c_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  C2cState& state = *g_state;
+  stop_pair(state);
+
+  restore_affinity(*ctx);
+  std::string error;
+  if (state.measured > 0 &&
+      !write_artifact(ctx, "matrix.csv", format_matrix(state), &error)) {
+    std::cerr << "c2c_latency: failed to write matrix.csv: " << error << "\n";
+  }
+  g_state.reset();
+}
+
+const Case kC2cLatencyCase{
+    "c2c_latency",
+    c2c_setup,
+    c2c_run_once,
+    c2c_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kC2cLatencyCase);
+#endif
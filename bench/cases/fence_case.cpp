@@ -0,0 +1,113 @@
+#include "case.h"
+#include "registry.h"
+
+// Memory fence cost on an otherwise idle core. Each call is one fence (plus a
+// store, so store-ordering fences have something to order); samples are
+// batched because a single fence is close to the clock-read cost.
+//
+// Cases: fence_seq_cst, fence_acq_rel, fence_signal, and on x86 fence_mfence,
+//        fence_lfence, fence_sfence
+//
+// On x86, atomic_thread_fence(seq_cst) is usually an mfence or a locked
+// instruction, acq_rel compiles to nothing, and fence_signal is a compiler
+// barrier only: the latter two show the loop floor.
+
+#include <atomic>
+#include <cstdint>
+
+namespace {
+
+constexpr uint32_t kFenceBatch = 64;
+
+volatile uint64_t g_sink = 0;
+
+void seq_cst_run_once(Ctx*) {
+  g_sink = 1;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void acq_rel_run_once(Ctx*) {
+  g_sink = 1;
+  std::atomic_thread_fence(std::memory_order_acq_rel);
+}
+
+void signal_run_once(Ctx*) {
+  g_sink = 1;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+const Case kFenceSeqCstCase{
+    "fence_seq_cst",
+    nullptr,
+    seq_cst_run_once,
+    nullptr,
+    kFenceBatch,
+};
+
+const Case kFenceAcqRelCase{
+    "fence_acq_rel",
+    nullptr,
+    acq_rel_run_once,
+    nullptr,
+    kFenceBatch,
+};
+
+const Case kFenceSignalCase{
+    "fence_signal",
+    nullptr,
+    signal_run_once,
+    nullptr,
+    kFenceBatch,
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+void mfence_run_once(Ctx*) {
+  g_sink = 1;
+  __builtin_ia32_mfence();
+}
+
+void lfence_run_once(Ctx*) {
+  g_sink = 1;
+  __builtin_ia32_lfence();
+}
+
+void sfence_run_once(Ctx*) {
+  g_sink = 1;
+  __builtin_ia32_sfence();
+}
+
+const Case kFenceMfenceCase{
+    "fence_mfence",
+    nullptr,
+    mfence_run_once,
+    nullptr,
+    kFenceBatch,
+};
+
+const Case kFenceLfenceCase{
+    "fence_lfence",
+    nullptr,
+    lfence_run_once,
+    nullptr,
+    kFenceBatch,
+};
+
+const Case kFenceSfenceCase{
+    "fence_sfence",
+    nullptr,
+    sfence_run_once,
+    nullptr,
+    kFenceBatch,
+};
+#endif
+
+}  // namespace
+
+LATENCY_LAB_REGISTER_CASE(kFenceSeqCstCase);
+LATENCY_LAB_REGISTER_CASE(kFenceAcqRelCase);
+LATENCY_LAB_REGISTER_CASE(kFenceSignalCase);
+#if defined(__x86_64__) || defined(__i386__)
+LATENCY_LAB_REGISTER_CASE(kFenceMfenceCase);
+LATENCY_LAB_REGISTER_CASE(kFenceLfenceCase);
+LATENCY_LAB_REGISTER_CASE(kFenceSfenceCase);
+#endif
@@ -0,0 +1,400 @@
+#include "artifacts.h"
+#include "case.h"
+#include "params.h"
+#include "registry.h"
+#include "timer.h"
+
+// File I/O latency, with durable writes as the main event (WAL-style: a
+// preallocated file written sequentially, wrapping at the end).
+//
+// Cases:
+//   fileio_pwrite_fsync      pwrite + fsync
+//   fileio_pwrite_fdatasync  pwrite + fdatasync
+//   fileio_odsync_write      pwrite on an O_DSYNC descriptor
+//   fileio_odirect_write     pwrite on an O_DIRECT descriptor (no sync: the
+//                            data reaches the device, not necessarily its
+//                            volatile cache)
+//   fileio_odirect_read      pread on an O_DIRECT descriptor
+//   fileio_pread_cached      pread of a file held in the page cache
+//
+// A sample is one op (write + sync where the case has one), in ns. Block
+// sizes sweep geometrically and --iters is split evenly across them,
+// smallest first; offsets advance by one block and wrap at file_mib, so
+// writes overwrite already-allocated blocks, as a recycled WAL segment does.
+// The file is created in `dir`, unlinked immediately (nothing is left behind
+// on a crash), filled and fsynced in setup. Per-size tails go to sweep.csv:
+//   size_bytes,samples,p50_ns,mean_ns,p99_ns,p999_ns,max_ns,mib_per_sec
+// and the filesystem behind `dir` to target.csv:
+//   dir,fs_type,fs_block_bytes
+// O_DIRECT cases skip when the filesystem refuses O_DIRECT (e.g. tmpfs
+// before Linux 6.6).
+//
+// Params:
+//   dir=<path>        directory for the test file (default /var/tmp; compare
+//                     a disk against /dev/shm for the tmpfs floor)
+//   min_kib=<n>       smallest block (default 4)
+//   max_kib=<n>       largest block (default 1024)
+//   per_octave=<n>    sizes per doubling (default 1)
+//   file_mib=<n>      file size (default 64; raised to the largest block)
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/statfs.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+// O_DIRECT buffers, offsets and lengths are kept to this alignment.
+constexpr size_t kDirectAlign = 4096;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "fileio: " << message << ": " << std::strerror(errno) << "\n";
+  std::exit(1);
+}
+
+enum class Op {
+  kPwriteFsync,
+  kPwriteFdatasync,
+  kOdsyncWrite,
+  kOdirectWrite,
+  kOdirectRead,
+  kPreadCached,
+};
+
+struct SizeResult {
+  uint64_t size = 0;
+  std::vector<uint64_t> ns;
+};
+
+struct FileState {
+  Op op = Op::kPwriteFsync;
+  int fd = -1;
+  uint64_t file_bytes = 0;
+  uint64_t offset = 0;
+  char* buffer = nullptr;
+  std::vector<SizeResult> sizes;
+  uint64_t per_size = 1;
+  uint64_t measured = 0;
+  std::string dir;
+};
+
+std::unique_ptr<FileState> g_state;
+
+bool is_write(Op op) {
+  return op != Op::kOdirectRead && op != Op::kPreadCached;
+}
+
+bool is_direct(Op op) {
+  return op == Op::kOdirectWrite || op == Op::kOdirectRead;
+}
+
+int open_flags(Op op) {
+  int flags = O_RDWR;
+  if (op == Op::kOdsyncWrite) {
+    flags |= O_DSYNC;
+  }
+  if (is_direct(op)) {
+    flags |= O_DIRECT;
+  }
+  return flags;
+}
+
+std::string fs_type_name(const struct statfs& fs) {
+  switch (static_cast<uint64_t>(fs.f_type)) {
+    case 0xef53:
+      return "ext4";
+    case 0x58465342:
+      return "xfs";
+    case 0x9123683e:
+      return "btrfs";
+    case 0x01021994:
+      return "tmpfs";
+    case 0x794c7630:
+      return "overlayfs";
+    default:
+      break;
+  }
+  std::ostringstream out;
+  out << "0x" << std::hex << static_cast<uint64_t>(fs.f_type);
+  return out.str();
+}
+
+void write_full_at(int fd, const char* data, size_t len, uint64_t offset) {
+  while (len > 0) {
+    const ssize_t n = pwrite(fd, data, len, static_cast<off_t>(offset));
+    if (n <= 0) {
+      fail("pwrite failed");
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+// Creates, fills and fsyncs the file through a buffered descriptor, then
+// reopens it with the case's flags. Returns false with ctx->skip_reason set
+// when the target cannot host the case.
+bool prepare_file(Ctx* ctx, FileState& state) {
+  const std::string path = state.dir + "/latency_lab_fileio_" +
+                           std::to_string(getpid()) + ".dat";
+  const int fill_fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fill_fd < 0) {
+    ctx->skip_reason = "cannot create a file in " + state.dir + ": " +
+                       std::strerror(errno);
+    return false;
+  }
+  const int fd = open(path.c_str(), open_flags(state.op));
+  const int open_errno = errno;
+  unlink(path.c_str());
+  if (fd < 0) {
+    close(fill_fd);
+    if (is_direct(state.op) && open_errno == EINVAL) {
+      ctx->skip_reason = "O_DIRECT is not supported in " + state.dir;
+      return false;
+    }
+    errno = open_errno;
+    fail("open failed");
+  }
+
+  const uint64_t chunk = state.sizes.back().size;
+  std::memset(state.buffer, 0x5a, chunk);
+  for (uint64_t off = 0; off < state.file_bytes; off += chunk) {
+    write_full_at(fill_fd, state.buffer, chunk, off);
+  }
+  if (fsync(fill_fd) != 0) {
+    fail("fsync failed");
+  }
+  close(fill_fd);
+  if (state.op == Op::kPreadCached) {
+    for (uint64_t off = 0; off < state.file_bytes; off += chunk) {
+      if (pread(fd, state.buffer, chunk, static_cast<off_t>(off)) < 0) {
+        fail("pread failed");
+      }
+    }
+  }
+  state.fd = fd;
+  return true;
+}
+
+std::string format_target(const FileState& state) {
+  struct statfs fs;
+  std::ostringstream out;
+  out << "dir,fs_type,fs_block_bytes\n";
+  if (fstatfs(state.fd, &fs) == 0) {
+    out << state.dir << "," << fs_type_name(fs) << "," << fs.f_bsize << "\n";
+  }
+  return out.str();
+}
+
+void fileio_setup(Ctx* ctx, Op op) {
+  auto state = std::make_unique<FileState>();
+  state->op = op;
+  state->dir = param_string(*ctx, "dir", "/var/tmp");
+  const uint64_t min_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "min_kib", 4)) << 10;
+  const uint64_t max_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "max_kib", 1024)) << 10;
+  const uint64_t per_octave =
+      std::max<uint64_t>(1, param_u64(*ctx, "per_octave", 1));
+
+  // Geometric sweep, rounded up to the O_DIRECT alignment for every case so
+  // results line up across cases.
+  for (double size = static_cast<double>(min_bytes);
+       size <= static_cast<double>(max_bytes) * 1.0001;
+       size *= std::pow(2.0, 1.0 / static_cast<double>(per_octave))) {
+    const uint64_t bytes = (static_cast<uint64_t>(size) + kDirectAlign - 1) /
+                           kDirectAlign * kDirectAlign;
+    if (state->sizes.empty() || state->sizes.back().size != bytes) {
+      state->sizes.push_back(SizeResult{bytes, {}});
+    }
+  }
+  if (state->sizes.empty()) {
+    std::cerr << "fileio: min_kib exceeds max_kib\n";
+    std::exit(1);
+  }
+  const uint64_t largest = state->sizes.back().size;
+  state->file_bytes = std::max<uint64_t>(
+      param_u64(*ctx, "file_mib", 64) << 20, largest);
+  state->file_bytes = (state->file_bytes + largest - 1) / largest * largest;
+  state->buffer =
+      static_cast<char*>(std::aligned_alloc(kDirectAlign, largest));
+  if (state->buffer == nullptr) {
+    fail("aligned_alloc failed");
+  }
+  state->per_size = std::max<uint64_t>(1, ctx->iters / state->sizes.size());
+
+  if (!prepare_file(ctx, *state)) {
+    std::free(state->buffer);
+    return;
+  }
+  g_state = std::move(state);
+}
+
+// The measured op at the current offset.
+void timed_op(FileState& state, size_t bytes) {
+  const off_t offset = static_cast<off_t>(state.offset);
+  ssize_t n = 0;
+  if (is_write(state.op)) {
+    n = pwrite(state.fd, state.buffer, bytes, offset);
+  } else {
+    n = pread(state.fd, state.buffer, bytes, offset);
+  }
+  if (n != static_cast<ssize_t>(bytes)) {
+    fail(is_write(state.op) ? "pwrite failed" : "pread failed");
+  }
+  if (state.op == Op::kPwriteFsync && fsync(state.fd) != 0) {
+    fail("fsync failed");
+  }
+  if (state.op == Op::kPwriteFdatasync && fdatasync(state.fd) != 0) {
+    fail("fdatasync failed");
+  }
+}
+
+void fileio_run_once(Ctx* ctx) {
+  FileState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_size,
+                              state.sizes.size() - 1);
+  }
+  const size_t bytes = state.sizes[target].size;
+  if (state.offset + bytes > state.file_bytes) {
+    state.offset = 0;
+  }
+  if (is_write(state.op)) {
+    // Fresh contents each op, so no layer can skip an identical write.
+    std::memcpy(state.buffer, &state.offset, sizeof(state.offset));
+  }
+
+  const uint64_t start = now_ns();
+  timed_op(state, bytes);
+  const uint64_t elapsed = now_ns() - start;
+  state.offset += bytes;
+
+  record_sample(ctx, elapsed);
+  if (!ctx->warming_up) {
+    state.sizes[target].ns.push_back(elapsed);
+    ++state.measured;
+  }
+}
+
+uint64_t quantile(const std::vector<uint64_t>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+std::string format_sweep(const FileState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "size_bytes,samples,p50_ns,mean_ns,p99_ns,p999_ns,max_ns,"
+         "mib_per_sec\n";
+  for (const SizeResult& result : state.sizes) {
+    if (result.ns.empty()) {
+      continue;
+    }
+    std::vector<uint64_t> sorted = result.ns;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (uint64_t v : sorted) {
+      sum += static_cast<double>(v);
+    }
+    const double mean = sum / static_cast<double>(sorted.size());
+    out << result.size << "," << sorted.size() << ","
+        << quantile(sorted, 0.50) << "," << mean << ","
+        << quantile(sorted, 0.99) << "," << quantile(sorted, 0.999) << ","
+        << sorted.back() << ","
+        << static_cast<double>(result.size) / (1 << 20) / (mean / 1e9)
+        << "\n";
+  }
+  return out.str();
+}
+
+void fileio_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  FileState& state = *g_state;
+  std::string error;
+  if (!write_artifact(ctx, "target.csv", format_target(state), &error) ||
+      (state.measured > 0 &&
+       !write_artifact(ctx, "sweep.csv", format_sweep(state), &error))) {
+    std::cerr << "fileio: failed to write artifact: " << error << "\n";
+  }
+  close(state.fd);
+  std::free(state.buffer);
+  g_state.reset();
+}
+
+template <Op O>
+void setup_for(Ctx* ctx) {
+  fileio_setup(ctx, O);
+}
+
+const Case kFileioPwriteFsyncCase{
+    "fileio_pwrite_fsync",
+    setup_for<Op::kPwriteFsync>,
+    fileio_run_once,
+    fileio_teardown,
+};
+
+const Case kFileioPwriteFdatasyncCase{
+    "fileio_pwrite_fdatasync",
+    setup_for<Op::kPwriteFdatasync>,
+    fileio_run_once,
+    fileio_teardown,
+};
+
+const Case kFileioOdsyncWriteCase{
+    "fileio_odsync_write",
+    setup_for<Op::kOdsyncWrite>,
+    fileio_run_once,
+    fileio_teardown,
+};
+
+const Case kFileioOdirectWriteCase{
+    "fileio_odirect_write",
+    setup_for<Op::kOdirectWrite>,
+    fileio_run_once,
+    fileio_teardown,
+};
+
+const Case kFileioOdirectReadCase{
+    "fileio_odirect_read",
+    setup_for<Op::kOdirectRead>,
+    fileio_run_once,
+    fileio_teardown,
+};
+
+const Case kFileioPreadCachedCase{
+    "fileio_pread_cached",
+    setup_for<Op::kPreadCached>,
+    fileio_run_once,
+    fileio_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kFileioPwriteFsyncCase);
+LATENCY_LAB_REGISTER_CASE(kFileioPwriteFdatasyncCase);
+LATENCY_LAB_REGISTER_CASE(kFileioOdsyncWriteCase);
+LATENCY_LAB_REGISTER_CASE(kFileioOdirectWriteCase);
+LATENCY_LAB_REGISTER_CASE(kFileioOdirectReadCase);
+LATENCY_LAB_REGISTER_CASE(kFileioPreadCachedCase);
+#endif
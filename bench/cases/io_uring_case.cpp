@@ -0,0 +1,745 @@
+#include "artifacts.h"
+#include "case.h"
+#include "params.h"
+#include "registry.h"
+#include "spin.h"
+#include "timer.h"
+
+// io_uring against blocking syscalls and epoll, on a page-cached file and on
+// a pipe. The ring is set up with raw io_uring_setup/io_uring_enter and
+// mmap, so there is no liburing dependency.
+//
+// Cases:
+//   io_uring_file_read, io_uring_file_write   IORING_OP_READ/WRITE
+//   io_uring_pipe                             qd writes then qd reads
+//   io_sync_file_read, io_sync_file_write     blocking pread/pwrite
+//   io_sync_pipe                              blocking write/read
+//   io_epoll_pipe                             non-blocking writes, then
+//                                             epoll_wait + read until the
+//                                             pipe is drained
+// epoll has no file variant: regular files are always ready, and
+// epoll_ctl refuses them.
+//
+// A sample issues `qd` ops and waits for all of them; it is recorded as ns
+// per op (rounded). Queue depths sweep in the order given and --iters is
+// split evenly across them. File ops walk the file in `size` steps and wrap
+// at file_mib. Per-depth results go to sweep.csv:
+//   qd,samples,p50_ns,mean_ns,p99_ns,ops_per_sec      (per op, 2dp)
+// where ops_per_sec is ops over the summed sample time.
+//
+// io_uring submission modes (submit=):
+//   batch    one io_uring_enter submits all qd SQEs and waits for all CQEs
+//            (default)
+//   single   one io_uring_enter per SQE, then one to wait for the CQEs
+//   sqpoll   IORING_SETUP_SQPOLL: a kernel thread picks up SQEs and CQEs are
+//            polled from the ring, so the steady state makes no syscalls.
+//            After kSqpollSpins empty polls the bench thread waits in
+//            io_uring_enter instead, so a poller sharing its CPU (see
+//            sq_cpu) still gets to run.
+// The io_uring cases skip with the kernel's reason when io_uring_setup
+// fails (e.g. kernel.io_uring_disabled) and sqpoll skips on kernels that
+// need registered files for it.
+//
+// Params:
+//   qd=<list>            queue depths to sweep (default 1,4,16,64)
+//   submit=batch|single|sqpoll   see above
+//   sq_cpu=<cpu>         sqpoll: pin the kernel poller (IORING_SETUP_SQ_AFF;
+//                        default unpinned)
+//   size=<n>             bytes per op (default 4096); a pipe must hold
+//                        qd * size bytes, at most 1 MiB
+//   dir=<path>           directory for the file (default /var/tmp)
+//   file_mib=<n>         file size (default 64)
+//   direct=true|false    file cases: O_DIRECT (size must then be a multiple
+//                        of 4096; skips where unsupported; default false)
+
+#if defined(__linux__)
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <linux/io_uring.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+constexpr size_t kDirectAlign = 4096;
+constexpr uint64_t kMaxPipeBytes = 1u << 20;
+constexpr uint64_t kSqpollSpins = 1u << 14;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "io: " << message << ": " << std::strerror(errno) << "\n";
+  std::exit(1);
+}
+
+enum class Engine {
+  kUring,
+  kSync,
+  kEpoll,
+};
+
+enum class Target {
+  kFileRead,
+  kFileWrite,
+  kPipe,
+};
+
+enum class Submit {
+  kBatch,
+  kSingle,
+  kSqpoll,
+};
+
+// Minimal io_uring: the three shared mappings and the ring indices in them.
+class Uring {
+ public:
+  ~Uring() {
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_bytes_);
+    }
+    if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+      munmap(cq_ptr_, cq_bytes_);
+    }
+    if (sq_ptr_ != nullptr) {
+      munmap(sq_ptr_, sq_bytes_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  // Returns false with *error set when the kernel will not give us a ring.
+  // sq_cpu < 0 leaves the SQPOLL thread unpinned.
+  bool init(unsigned entries, bool sqpoll, int sq_cpu, std::string* error) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    if (sqpoll) {
+      params.flags |= IORING_SETUP_SQPOLL;
+      params.sq_thread_idle = 1000;
+      if (sq_cpu >= 0) {
+        params.flags |= IORING_SETUP_SQ_AFF;
+        params.sq_thread_cpu = static_cast<uint32_t>(sq_cpu);
+      }
+    }
+    const long fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      *error = std::string("io_uring_setup failed: ") + std::strerror(errno);
+      return false;
+    }
+    fd_ = static_cast<int>(fd);
+    if (sqpoll && (params.features & IORING_FEAT_SQPOLL_NONFIXED) == 0) {
+      *error = "SQPOLL needs registered files on this kernel";
+      return false;
+    }
+    sqpoll_ = sqpoll;
+
+    sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+    }
+    sq_ptr_ = map(sq_bytes_, IORING_OFF_SQ_RING);
+    cq_ptr_ = single_mmap ? sq_ptr_ : map(cq_bytes_, IORING_OFF_CQ_RING);
+    sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+
+    char* sq = static_cast<char*>(sq_ptr_);
+    sq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(sq +
+                                                        params.sq_off.tail);
+    sq_flags_ = reinterpret_cast<std::atomic<unsigned>*>(sq +
+                                                         params.sq_off.flags);
+    sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    char* cq = static_cast<char*>(cq_ptr_);
+    cq_head_ = reinterpret_cast<std::atomic<unsigned>*>(cq +
+                                                        params.cq_off.head);
+    cq_tail_ = reinterpret_cast<std::atomic<unsigned>*>(cq +
+                                                        params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  // Queue one read or write; it is not visible to the kernel until publish().
+  void prepare(uint8_t opcode, int fd, void* buf, unsigned len,
+               uint64_t offset) {
+    const unsigned index = local_tail_ & sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buf);
+    sqe->len = len;
+    sqe->off = offset;
+    sq_array_[index] = index;
+    ++local_tail_;
+  }
+
+  void publish() {
+    sq_tail_->store(local_tail_, std::memory_order_release);
+    if (needs_wakeup()) {
+      enter(0, 0, IORING_ENTER_SQ_WAKEUP);
+    }
+  }
+
+  // The full fence orders the tail store before the flags load (as liburing
+  // does); otherwise the poller can go to sleep after our load without
+  // having seen the new tail, and the wakeup is lost.
+  bool needs_wakeup() const {
+    if (!sqpoll_) {
+      return false;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return sq_flags_->load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP;
+  }
+
+  void enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+    while (syscall(__NR_io_uring_enter, fd_, to_submit, min_complete, flags,
+                   nullptr, 0) < 0) {
+      if (errno != EINTR) {
+        fail("io_uring_enter failed");
+      }
+    }
+  }
+
+  // Pops one CQE if present and returns its result through *res.
+  bool pop(int* res) {
+    const unsigned head = cq_head_->load(std::memory_order_relaxed);
+    if (head == cq_tail_->load(std::memory_order_acquire)) {
+      return false;
+    }
+    *res = cqes_[head & cq_mask_].res;
+    cq_head_->store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool sqpoll() const { return sqpoll_; }
+
+ private:
+  void* map(size_t bytes, off_t offset) {
+    void* addr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd_, offset);
+    if (addr == MAP_FAILED) {
+      fail("io_uring mmap failed");
+    }
+    return addr;
+  }
+
+  int fd_ = -1;
+  bool sqpoll_ = false;
+  void* sq_ptr_ = nullptr;
+  void* cq_ptr_ = nullptr;
+  size_t sq_bytes_ = 0;
+  size_t cq_bytes_ = 0;
+  size_t sqes_bytes_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  std::atomic<unsigned>* sq_tail_ = nullptr;
+  std::atomic<unsigned>* sq_flags_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned local_tail_ = 0;
+  std::atomic<unsigned>* cq_head_ = nullptr;
+  std::atomic<unsigned>* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+};
+
+struct DepthResult {
+  uint64_t qd = 1;
+  std::vector<double> ns_per_op;
+  uint64_t ops = 0;
+  uint64_t timed_ns = 0;
+};
+
+struct IoState {
+  Engine engine = Engine::kSync;
+  Target target = Target::kFileRead;
+  Submit submit = Submit::kBatch;
+  size_t size = 4096;
+  std::vector<DepthResult> depths;
+  uint64_t per_depth = 1;
+  uint64_t measured = 0;
+
+  int file_fd = -1;
+  uint64_t file_bytes = 0;
+  uint64_t offset = 0;
+  int pipe_read = -1;
+  int pipe_write = -1;
+  int epoll_fd = -1;
+  char* buffers = nullptr;  // max qd * size, kDirectAlign aligned
+  std::unique_ptr<Uring> ring;
+};
+
+std::unique_ptr<IoState> g_state;
+
+void write_full_at(int fd, const char* data, size_t len, uint64_t offset) {
+  while (len > 0) {
+    const ssize_t n = pwrite(fd, data, len, static_cast<off_t>(offset));
+    if (n <= 0) {
+      fail("pwrite failed");
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+}
+
+// Blocking read of exactly `len` bytes from the pipe.
+void read_exact(int fd, char* data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = ::read(fd, data, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      fail("pipe read failed");
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+  }
+}
+
+// Unlinked, filled file, read once so buffered reads hit the page cache.
+bool open_file(Ctx* ctx, IoState& state, bool direct) {
+  const std::string dir = param_string(*ctx, "dir", "/var/tmp");
+  const std::string path =
+      dir + "/latency_lab_io_" + std::to_string(getpid()) + ".dat";
+  const int fill_fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fill_fd < 0) {
+    ctx->skip_reason =
+        "cannot create a file in " + dir + ": " + std::strerror(errno);
+    return false;
+  }
+  const int fd = open(path.c_str(), O_RDWR | (direct ? O_DIRECT : 0));
+  const int open_errno = errno;
+  unlink(path.c_str());
+  if (fd < 0) {
+    close(fill_fd);
+    if (direct && open_errno == EINVAL) {
+      ctx->skip_reason = "O_DIRECT is not supported in " + dir;
+      return false;
+    }
+    errno = open_errno;
+    fail("open failed");
+  }
+  std::vector<char> chunk(1 << 20, 0x5a);
+  for (uint64_t off = 0; off < state.file_bytes; off += chunk.size()) {
+    write_full_at(fill_fd, chunk.data(), chunk.size(), off);
+  }
+  for (uint64_t off = 0; off < state.file_bytes; off += chunk.size()) {
+    if (pread(fill_fd, chunk.data(), chunk.size(), static_cast<off_t>(off)) <
+        0) {
+      fail("pread failed");
+    }
+  }
+  close(fill_fd);
+  state.file_fd = fd;
+  return true;
+}
+
+void open_pipe(IoState& state, uint64_t max_qd) {
+  int fds[2];
+  if (pipe2(fds, state.engine == Engine::kEpoll ? O_NONBLOCK : 0) != 0) {
+    fail("pipe2 failed");
+  }
+  state.pipe_read = fds[0];
+  state.pipe_write = fds[1];
+  const uint64_t needed = max_qd * state.size;
+  if (needed > kMaxPipeBytes) {
+    std::cerr << "io: qd * size exceeds " << kMaxPipeBytes
+              << " bytes of pipe capacity\n";
+    std::exit(1);
+  }
+  if (fcntl(state.pipe_write, F_SETPIPE_SZ, static_cast<int>(needed)) < 0 &&
+      needed > 65536) {
+    fail("F_SETPIPE_SZ failed (see /proc/sys/fs/pipe-max-size)");
+  }
+  if (state.engine == Engine::kEpoll) {
+    state.epoll_fd = epoll_create1(0);
+    if (state.epoll_fd < 0) {
+      fail("epoll_create1 failed");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    if (epoll_ctl(state.epoll_fd, EPOLL_CTL_ADD, state.pipe_read, &event) !=
+        0) {
+      fail("epoll_ctl failed");
+    }
+  }
+}
+
+void io_setup(Ctx* ctx, Engine engine, Target target) {
+  auto state = std::make_unique<IoState>();
+  state->engine = engine;
+  state->target = target;
+  state->size = std::max<uint64_t>(1, param_u64(*ctx, "size", 4096));
+  const std::string submit =
+      param_choice(*ctx, "submit", {"batch", "single", "sqpoll"}, "batch");
+  state->submit = submit == "single"   ? Submit::kSingle
+                  : submit == "sqpoll" ? Submit::kSqpoll
+                                       : Submit::kBatch;
+  const bool direct = param_bool(*ctx, "direct", false);
+  if (direct && state->size % kDirectAlign != 0) {
+    std::cerr << "io: direct=true needs size to be a multiple of "
+              << kDirectAlign << "\n";
+    std::exit(1);
+  }
+
+  std::vector<uint64_t> depths = param_u64_list(*ctx, "qd");
+  if (depths.empty()) {
+    depths = {1, 4, 16, 64};
+  }
+  uint64_t max_qd = 1;
+  for (uint64_t qd : depths) {
+    if (qd == 0) {
+      std::cerr << "io: qd must be positive\n";
+      std::exit(1);
+    }
+    state->depths.push_back(DepthResult{qd, {}, 0, 0});
+    max_qd = std::max(max_qd, qd);
+  }
+  state->per_depth = std::max<uint64_t>(1, ctx->iters / state->depths.size());
+
+  const size_t buffer_bytes =
+      (max_qd * state->size + kDirectAlign - 1) / kDirectAlign * kDirectAlign;
+  state->buffers =
+      static_cast<char*>(std::aligned_alloc(kDirectAlign, buffer_bytes));
+  if (state->buffers == nullptr) {
+    fail("aligned_alloc failed");
+  }
+  std::memset(state->buffers, 0x5a, buffer_bytes);
+
+  if (engine == Engine::kUring) {
+    // Pipe samples queue a write and a read per op.
+    const uint64_t entries = (target == Target::kPipe ? 2 : 1) * max_qd;
+    auto ring = std::make_unique<Uring>();
+    std::string error;
+    const std::vector<int> sq_cpu = param_cpu_list(*ctx, "sq_cpu");
+    if (!ring->init(static_cast<unsigned>(entries),
+                    state->submit == Submit::kSqpoll,
+                    sq_cpu.empty() ? -1 : sq_cpu.front(), &error)) {
+      ctx->skip_reason = error;
+      std::free(state->buffers);
+      return;
+    }
+    state->ring = std::move(ring);
+  }
+
+  if (target == Target::kPipe) {
+    open_pipe(*state, max_qd);
+  } else {
+    state->file_bytes = std::max<uint64_t>(
+        1, param_u64(*ctx, "file_mib", 64)) << 20;
+    state->file_bytes =
+        std::max<uint64_t>(state->file_bytes, max_qd * state->size);
+    if (!open_file(ctx, *state, direct)) {
+      std::free(state->buffers);
+      return;
+    }
+  }
+  g_state = std::move(state);
+}
+
+// Next file offset for one op, wrapping at the end of the file.
+uint64_t next_offset(IoState& state) {
+  if (state.offset + state.size > state.file_bytes) {
+    state.offset = 0;
+  }
+  const uint64_t offset = state.offset;
+  state.offset += state.size;
+  return offset;
+}
+
+// Submits `count` prepared SQEs and waits for their CQEs. Returns the bytes
+// transferred across all of them.
+uint64_t uring_complete(IoState& state, uint64_t count) {
+  Uring& ring = *state.ring;
+  if (state.submit == Submit::kSqpoll) {
+    ring.publish();
+  } else if (state.submit == Submit::kSingle) {
+    ring.publish();
+    for (uint64_t i = 0; i < count; ++i) {
+      ring.enter(1, 0, 0);
+    }
+  } else {
+    ring.publish();
+    ring.enter(static_cast<unsigned>(count), static_cast<unsigned>(count),
+               IORING_ENTER_GETEVENTS);
+  }
+
+  uint64_t reaped = 0;
+  uint64_t total_bytes = 0;
+  uint64_t empty_polls = 0;
+  while (reaped < count) {
+    int res = 0;
+    if (!ring.pop(&res)) {
+      if (!ring.sqpoll() || ++empty_polls >= kSqpollSpins) {
+        ring.enter(0, 1,
+                   IORING_ENTER_GETEVENTS |
+                       (ring.needs_wakeup() ? IORING_ENTER_SQ_WAKEUP : 0));
+        empty_polls = 0;
+      } else {
+        cpu_relax();
+      }
+      continue;
+    }
+    if (res < 0) {
+      errno = -res;
+      fail("io_uring op failed");
+    }
+    total_bytes += static_cast<uint64_t>(res);
+    ++reaped;
+  }
+  return total_bytes;
+}
+
+void run_uring(IoState& state, uint64_t qd) {
+  Uring& ring = *state.ring;
+  const unsigned len = static_cast<unsigned>(state.size);
+  if (state.target == Target::kPipe) {
+    for (uint64_t i = 0; i < qd; ++i) {
+      ring.prepare(IORING_OP_WRITE, state.pipe_write,
+                   state.buffers + i * state.size, len, 0);
+    }
+    for (uint64_t i = 0; i < qd; ++i) {
+      ring.prepare(IORING_OP_READ, state.pipe_read,
+                   state.buffers + i * state.size, len, 0);
+    }
+    // Writes are never short (the pipe holds qd * size), so the rest of the
+    // total is what the reads got.
+    const uint64_t read = uring_complete(state, 2 * qd) - qd * state.size;
+    // A read can come back short when it raced the writes; drain the rest
+    // so the next sample starts with an empty pipe.
+    const uint64_t missing = qd * state.size - read;
+    if (missing > 0) {
+      read_exact(state.pipe_read, state.buffers, missing);
+    }
+    return;
+  }
+  const uint8_t opcode = state.target == Target::kFileRead ? IORING_OP_READ
+                                                           : IORING_OP_WRITE;
+  for (uint64_t i = 0; i < qd; ++i) {
+    ring.prepare(opcode, state.file_fd, state.buffers + i * state.size, len,
+                 next_offset(state));
+  }
+  uring_complete(state, qd);
+}
+
+void run_sync(IoState& state, uint64_t qd) {
+  if (state.target == Target::kPipe) {
+    for (uint64_t i = 0; i < qd; ++i) {
+      if (::write(state.pipe_write, state.buffers + i * state.size,
+                  state.size) != static_cast<ssize_t>(state.size)) {
+        fail("pipe write failed");
+      }
+    }
+    read_exact(state.pipe_read, state.buffers, qd * state.size);
+    return;
+  }
+  for (uint64_t i = 0; i < qd; ++i) {
+    char* buf = state.buffers + i * state.size;
+    const off_t offset = static_cast<off_t>(next_offset(state));
+    const ssize_t n = state.target == Target::kFileRead
+                          ? pread(state.file_fd, buf, state.size, offset)
+                          : pwrite(state.file_fd, buf, state.size, offset);
+    if (n != static_cast<ssize_t>(state.size)) {
+      fail("file op failed");
+    }
+  }
+}
+
+void run_epoll(IoState& state, uint64_t qd) {
+  for (uint64_t i = 0; i < qd; ++i) {
+    if (::write(state.pipe_write, state.buffers + i * state.size,
+                state.size) != static_cast<ssize_t>(state.size)) {
+      fail("pipe write failed");
+    }
+  }
+  uint64_t remaining = qd * state.size;
+  while (remaining > 0) {
+    epoll_event event;
+    const int ready = epoll_wait(state.epoll_fd, &event, 1, -1);
+    if (ready < 0 && errno != EINTR) {
+      fail("epoll_wait failed");
+    }
+    if (ready <= 0) {
+      continue;
+    }
+    const ssize_t n = ::read(state.pipe_read, state.buffers,
+                             std::min<uint64_t>(remaining, state.size));
+    if (n < 0 && errno != EAGAIN) {
+      fail("pipe read failed");
+    }
+    if (n > 0) {
+      remaining -= static_cast<uint64_t>(n);
+    }
+  }
+}
+
+void io_run_once(Ctx* ctx) {
+  IoState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_depth,
+                              state.depths.size() - 1);
+  }
+  DepthResult& depth = state.depths[target];
+
+  const uint64_t start = now_ns();
+  switch (state.engine) {
+    case Engine::kUring:
+      run_uring(state, depth.qd);
+      break;
+    case Engine::kSync:
+      run_sync(state, depth.qd);
+      break;
+    case Engine::kEpoll:
+      run_epoll(state, depth.qd);
+      break;
+  }
+  const uint64_t elapsed = now_ns() - start;
+
+  const double per_op =
+      static_cast<double>(elapsed) / static_cast<double>(depth.qd);
+  record_sample(ctx, static_cast<uint64_t>(std::llround(per_op)));
+  if (ctx->warming_up) {
+    return;
+  }
+  depth.ns_per_op.push_back(per_op);
+  depth.ops += depth.qd;
+  depth.timed_ns += elapsed;
+  ++state.measured;
+}
+
+double quantile(const std::vector<double>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+std::string format_sweep(const IoState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "qd,samples,p50_ns,mean_ns,p99_ns,ops_per_sec\n";
+  for (const DepthResult& depth : state.depths) {
+    if (depth.ns_per_op.empty()) {
+      continue;
+    }
+    std::vector<double> sorted = depth.ns_per_op;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) {
+      sum += v;
+    }
+    out << depth.qd << "," << sorted.size() << "," << quantile(sorted, 0.50)
+        << "," << sum / static_cast<double>(sorted.size()) << ","
+        << quantile(sorted, 0.99) << ","
+        << static_cast<double>(depth.ops) /
+               (static_cast<double>(depth.timed_ns) / 1e9)
+        << "\n";
+  }
+  return out.str();
+}
+
+void io_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  IoState& state = *g_state;
+  std::string error;
+  if (state.measured > 0 &&
+      !write_artifact(ctx, "sweep.csv", format_sweep(state), &error)) {
+    std::cerr << "io: failed to write sweep.csv: " << error << "\n";
+  }
+  state.ring.reset();
+  for (int fd : {state.file_fd, state.pipe_read, state.pipe_write,
+                 state.epoll_fd}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  std::free(state.buffers);
+  g_state.reset();
+}
+
+template <Engine E, Target T>
+void setup_for(Ctx* ctx) {
+  io_setup(ctx, E, T);
+}
+
+const Case kIoUringFileReadCase{
+    "io_uring_file_read",
+    setup_for<Engine::kUring, Target::kFileRead>,
+    io_run_once,
+    io_teardown,
+};
+
+const Case kIoUringFileWriteCase{
+    "io_uring_file_write",
+    setup_for<Engine::kUring, Target::kFileWrite>,
+    io_run_once,
+    io_teardown,
+};
+
+const Case kIoUringPipeCase{
+    "io_uring_pipe",
+    setup_for<Engine::kUring, Target::kPipe>,
+    io_run_once,
+    io_teardown,
+};
+
+const Case kIoSyncFileReadCase{
+    "io_sync_file_read",
+    setup_for<Engine::kSync, Target::kFileRead>,
+    io_run_once,
+    io_teardown,
+};
+
+const Case kIoSyncFileWriteCase{
+    "io_sync_file_write",
+    setup_for<Engine::kSync, Target::kFileWrite>,
+    io_run_once,
+    io_teardown,
+};
+
+const Case kIoSyncPipeCase{
+    "io_sync_pipe",
+    setup_for<Engine::kSync, Target::kPipe>,
+    io_run_once,
+    io_teardown,
+};
+
+const Case kIoEpollPipeCase{
+    "io_epoll_pipe",
+    setup_for<Engine::kEpoll, Target::kPipe>,
+    io_run_once,
+    io_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kIoUringFileReadCase);
+LATENCY_LAB_REGISTER_CASE(kIoUringFileWriteCase);
+LATENCY_LAB_REGISTER_CASE(kIoUringPipeCase);
+LATENCY_LAB_REGISTER_CASE(kIoSyncFileReadCase);
+LATENCY_LAB_REGISTER_CASE(kIoSyncFileWriteCase);
+LATENCY_LAB_REGISTER_CASE(kIoSyncPipeCase);
+LATENCY_LAB_REGISTER_CASE(kIoEpollPipeCase);
+#endif
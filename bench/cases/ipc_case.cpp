@@ -0,0 +1,737 @@
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "spin.h"
+#include "timer.h"
+
+// Inter-process communication between the bench process and a forked peer.
+// The peer is forked in setup() and reaped in teardown(), so only the
+// message exchange is timed.
+//
+// Cases: ipc_pipe, ipc_unix_stream, ipc_unix_dgram, ipc_socketpair, ipc_mq,
+//        ipc_shm_ring
+//
+// Params:
+//   size=<bytes>            message size (default 64)
+//   mode=pingpong|stream    pingpong (default): each sample is one echo round
+//                           trip. stream: each sample sends `burst` messages
+//                           one way and waits for a single ack; the sample is
+//                           the per-message cost.
+//   burst=<n>               messages per stream sample (default 32)
+//   spin=<n>                ipc_shm_ring: polls before sleeping on the futex
+//                           doorbell (default 1000)
+//   slots=<n>               ipc_shm_ring: ring capacity (default 64)
+//   placement/peer_cpu      see placement.h; the peer process is pinned
+//
+// Throughput (msgs_per_sec, mib_per_sec) is reported as run metrics.
+
+#if defined(__linux__)
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <linux/futex.h>
+#include <memory>
+#include <mqueue.h>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "ipc: " << message << ": " << std::strerror(errno) << "\n";
+  std::exit(1);
+}
+
+// One bidirectional channel. The parent creates it before fork(); each side
+// then drops the other side's resources. send/recv move exactly one message
+// of `len` bytes; recv returns false once the other side has shut down.
+class Transport {
+ public:
+  virtual ~Transport() = default;
+  virtual void become_parent() {}
+  virtual void become_child() {}
+  virtual bool send(const char* data, size_t len) = 0;
+  virtual bool recv(char* data, size_t len) = 0;
+  // Parent only: tell the child to exit its loop.
+  virtual void shutdown() = 0;
+};
+
+bool write_full(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = ::write(fd, data, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+bool read_full(int fd, char* data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = ::read(fd, data, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+void close_fd(int* fd) {
+  if (*fd >= 0) {
+    ::close(*fd);
+    *fd = -1;
+  }
+}
+
+// Byte-stream transports: pipes, Unix stream sockets, socketpair. The parent
+// uses (parent_rx, parent_tx), the child (child_rx, child_tx); for sockets a
+// side's rx and tx are the same fd.
+class StreamTransport final : public Transport {
+ public:
+  StreamTransport(int parent_rx, int parent_tx, int child_rx, int child_tx)
+      : parent_rx_(parent_rx),
+        parent_tx_(parent_tx),
+        child_rx_(child_rx),
+        child_tx_(child_tx) {}
+  ~StreamTransport() override {
+    close_fd(&rx_);
+    if (tx_ != rx_) {
+      close_fd(&tx_);
+    }
+  }
+  void become_parent() override { keep(parent_rx_, parent_tx_); }
+  void become_child() override { keep(child_rx_, child_tx_); }
+  bool send(const char* data, size_t len) override {
+    return write_full(tx_, data, len);
+  }
+  bool recv(char* data, size_t len) override {
+    return read_full(rx_, data, len);
+  }
+  void shutdown() override {
+    // EOF on the child's read side ends its loop.
+    if (tx_ == rx_) {
+      ::shutdown(tx_, SHUT_WR);
+    } else {
+      close_fd(&tx_);
+    }
+  }
+
+ private:
+  void keep(int rx, int tx) {
+    for (int fd : {parent_rx_, parent_tx_, child_rx_, child_tx_}) {
+      if (fd != rx && fd != tx) {
+        ::close(fd);
+      }
+    }
+    rx_ = rx;
+    tx_ = tx;
+  }
+
+  int parent_rx_;
+  int parent_tx_;
+  int child_rx_;
+  int child_tx_;
+  int rx_ = -1;
+  int tx_ = -1;
+};
+
+// Connected datagram sockets; a zero-length datagram is the stop message.
+class DgramTransport final : public Transport {
+ public:
+  DgramTransport(int parent_fd, int child_fd)
+      : parent_fd_(parent_fd), child_fd_(child_fd) {}
+  ~DgramTransport() override { close_fd(&fd_); }
+  void become_parent() override {
+    ::close(child_fd_);
+    fd_ = parent_fd_;
+  }
+  void become_child() override {
+    ::close(parent_fd_);
+    fd_ = child_fd_;
+  }
+  bool send(const char* data, size_t len) override {
+    while (true) {
+      const ssize_t n = ::send(fd_, data, len, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      return n == static_cast<ssize_t>(len);
+    }
+  }
+  bool recv(char* data, size_t len) override {
+    while (true) {
+      const ssize_t n = ::recv(fd_, data, len, 0);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      return n == static_cast<ssize_t>(len) && n > 0;
+    }
+  }
+  void shutdown() override {
+    const char stop = 0;
+    send(&stop, 0);
+  }
+
+ private:
+  int parent_fd_;
+  int child_fd_;
+  int fd_ = -1;
+};
+
+// POSIX message queues, one per direction; a zero-length message stops.
+class MqTransport final : public Transport {
+ public:
+  MqTransport(mqd_t to_child, mqd_t to_parent)
+      : to_child_(to_child), to_parent_(to_parent) {}
+  ~MqTransport() override {
+    mq_close(to_child_);
+    mq_close(to_parent_);
+  }
+  void become_parent() override {
+    tx_ = to_child_;
+    rx_ = to_parent_;
+  }
+  void become_child() override {
+    tx_ = to_parent_;
+    rx_ = to_child_;
+  }
+  bool send(const char* data, size_t len) override {
+    while (mq_send(tx_, data, len, 0) != 0) {
+      if (errno != EINTR) {
+        return false;
+      }
+    }
+    return true;
+  }
+  bool recv(char* data, size_t len) override {
+    while (true) {
+      const ssize_t n = mq_receive(rx_, data, max_len_, nullptr);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      return n == static_cast<ssize_t>(len) && n > 0;
+    }
+  }
+  void shutdown() override {
+    const char stop = 0;
+    send(&stop, 0);
+  }
+  void set_max_len(size_t len) { max_len_ = len; }
+
+ private:
+  mqd_t to_child_;
+  mqd_t to_parent_;
+  mqd_t tx_ = -1;
+  mqd_t rx_ = -1;
+  size_t max_len_ = 0;
+};
+
+// --- Shared-memory SPSC ring with futex doorbells --------------------------
+
+long futex_shared(std::atomic<uint32_t>* word, int op, uint32_t value) {
+  // Not FUTEX_PRIVATE: the word lives in a MAP_SHARED mapping across fork.
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value,
+                 nullptr, nullptr, 0);
+}
+
+// Lets one side sleep until the other makes progress. The producer only pays
+// for FUTEX_WAKE when the consumer has announced that it is going to sleep.
+struct alignas(64) Doorbell {
+  std::atomic<uint32_t> seq{0};
+  std::atomic<uint32_t> sleeping{0};
+
+  template <typename Ready>
+  void wait(Ready ready, uint64_t spin) {
+    for (uint64_t i = 0; i < spin; ++i) {
+      if (ready()) {
+        return;
+      }
+      cpu_relax();
+    }
+    while (!ready()) {
+      const uint32_t seen = seq.load(std::memory_order_seq_cst);
+      sleeping.store(1, std::memory_order_seq_cst);
+      if (ready()) {
+        sleeping.store(0, std::memory_order_relaxed);
+        return;
+      }
+      futex_shared(&seq, FUTEX_WAIT, seen);
+      sleeping.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void ring() {
+    seq.fetch_add(1, std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_seq_cst)) {
+      futex_shared(&seq, FUTEX_WAKE, 1);
+    }
+  }
+};
+
+struct alignas(64) RingHeader {
+  alignas(64) std::atomic<uint64_t> head{0};  // consumer position
+  alignas(64) std::atomic<uint64_t> tail{0};  // producer position
+  Doorbell data;                              // producer -> consumer
+  Doorbell space;                             // consumer -> producer
+};
+
+// Slot layout: uint32 length (0 = stop), then the payload.
+class SpscRing {
+ public:
+  SpscRing(char* base, size_t slots, size_t slot_bytes, uint64_t spin)
+      : header_(new (base) RingHeader()),
+        slots_(base + sizeof(RingHeader)),
+        slot_count_(slots),
+        slot_bytes_(slot_bytes),
+        spin_(spin) {}
+
+  static size_t bytes_for(size_t slots, size_t slot_bytes) {
+    return sizeof(RingHeader) + slots * slot_bytes;
+  }
+
+  void push(const char* data, uint32_t len) {
+    const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+    header_->space.wait(
+        [&] {
+          return tail - header_->head.load(std::memory_order_acquire) <
+                 slot_count_;
+        },
+        spin_);
+    char* slot = slots_ + (tail % slot_count_) * slot_bytes_;
+    std::memcpy(slot, &len, sizeof(len));
+    if (len > 0) {
+      std::memcpy(slot + sizeof(len), data, len);
+    }
+    header_->tail.store(tail + 1, std::memory_order_release);
+    header_->data.ring();
+  }
+
+  // Returns the message length (0 = stop).
+  uint32_t pop(char* data, size_t capacity) {
+    const uint64_t head = header_->head.load(std::memory_order_relaxed);
+    header_->data.wait(
+        [&] { return header_->tail.load(std::memory_order_acquire) != head; },
+        spin_);
+    const char* slot = slots_ + (head % slot_count_) * slot_bytes_;
+    uint32_t len = 0;
+    std::memcpy(&len, slot, sizeof(len));
+    std::memcpy(data, slot + sizeof(len), std::min<size_t>(len, capacity));
+    header_->head.store(head + 1, std::memory_order_release);
+    header_->space.ring();
+    return len;
+  }
+
+ private:
+  RingHeader* header_;
+  char* slots_;
+  size_t slot_count_;
+  size_t slot_bytes_;
+  uint64_t spin_;
+};
+
+class ShmRingTransport final : public Transport {
+ public:
+  ShmRingTransport(size_t slots, size_t msg_size, uint64_t spin) {
+    const size_t slot_bytes = (sizeof(uint32_t) + msg_size + 63) / 64 * 64;
+    const size_t ring_bytes = SpscRing::bytes_for(slots, slot_bytes);
+    map_bytes_ = 2 * ring_bytes;
+    void* base = mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      fail("mmap shared ring");
+    }
+    base_ = static_cast<char*>(base);
+    to_child_ = std::make_unique<SpscRing>(base_, slots, slot_bytes, spin);
+    to_parent_ =
+        std::make_unique<SpscRing>(base_ + ring_bytes, slots, slot_bytes, spin);
+  }
+  ~ShmRingTransport() override { munmap(base_, map_bytes_); }
+  void become_parent() override {
+    tx_ = to_child_.get();
+    rx_ = to_parent_.get();
+  }
+  void become_child() override {
+    tx_ = to_parent_.get();
+    rx_ = to_child_.get();
+  }
+  bool send(const char* data, size_t len) override {
+    tx_->push(data, static_cast<uint32_t>(len));
+    return true;
+  }
+  bool recv(char* data, size_t len) override {
+    return rx_->pop(data, len) == len && len > 0;
+  }
+  void shutdown() override { tx_->push(nullptr, 0); }
+
+ private:
+  char* base_ = nullptr;
+  size_t map_bytes_ = 0;
+  std::unique_ptr<SpscRing> to_child_;
+  std::unique_ptr<SpscRing> to_parent_;
+  SpscRing* tx_ = nullptr;
+  SpscRing* rx_ = nullptr;
+};
+
+// --- Transport factories ----------------------------------------------------
+
+enum class Mechanism {
+  kPipe,
+  kUnixStream,
+  kUnixDgram,
+  kSocketpair,
+  kMq,
+  kShmRing,
+};
+
+// Abstract-namespace address unique to this process.
+sockaddr_un abstract_addr(const char* tag, socklen_t* len) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  const std::string name = std::string("latency_lab_") + tag + "_" +
+                           std::to_string(static_cast<long>(getpid()));
+  std::memcpy(addr.sun_path + 1, name.data(), name.size());
+  *len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 +
+                                name.size());
+  return addr;
+}
+
+std::unique_ptr<Transport> make_pipe() {
+  int down[2];
+  int up[2];
+  if (pipe2(down, O_CLOEXEC) != 0 || pipe2(up, O_CLOEXEC) != 0) {
+    fail("pipe2");
+  }
+  return std::make_unique<StreamTransport>(up[0], down[1], down[0], up[1]);
+}
+
+std::unique_ptr<Transport> make_socketpair() {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+    fail("socketpair");
+  }
+  return std::make_unique<StreamTransport>(fds[0], fds[0], fds[1], fds[1]);
+}
+
+// Same data path as socketpair, but established through listen/connect on a
+// named (abstract) socket, as a sidecar would.
+std::unique_ptr<Transport> make_unix_stream() {
+  socklen_t len = 0;
+  const sockaddr_un addr = abstract_addr("stream", &len);
+  const int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listener < 0 ||
+      bind(listener, reinterpret_cast<const sockaddr*>(&addr), len) != 0 ||
+      listen(listener, 1) != 0) {
+    fail("unix stream listen");
+  }
+  const int client = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (client < 0 ||
+      connect(client, reinterpret_cast<const sockaddr*>(&addr), len) != 0) {
+    fail("unix stream connect");
+  }
+  const int server = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+  if (server < 0) {
+    fail("unix stream accept");
+  }
+  ::close(listener);
+  return std::make_unique<StreamTransport>(client, client, server, server);
+}
+
+std::unique_ptr<Transport> make_unix_dgram(size_t size) {
+  socklen_t len_a = 0;
+  socklen_t len_b = 0;
+  const sockaddr_un addr_a = abstract_addr("dgram_a", &len_a);
+  const sockaddr_un addr_b = abstract_addr("dgram_b", &len_b);
+  const int a = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  const int b = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (a < 0 || b < 0 ||
+      bind(a, reinterpret_cast<const sockaddr*>(&addr_a), len_a) != 0 ||
+      bind(b, reinterpret_cast<const sockaddr*>(&addr_b), len_b) != 0 ||
+      connect(a, reinterpret_cast<const sockaddr*>(&addr_b), len_b) != 0 ||
+      connect(b, reinterpret_cast<const sockaddr*>(&addr_a), len_a) != 0) {
+    fail("unix dgram setup");
+  }
+  // Room for a full stream burst of datagrams; the kernel caps this at
+  // net.core.wmem_max.
+  const int buf = static_cast<int>(std::min<size_t>(size * 256, 1 << 24));
+  setsockopt(a, SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+  setsockopt(b, SOL_SOCKET, SO_SNDBUF, &buf, sizeof(buf));
+  return std::make_unique<DgramTransport>(a, b);
+}
+
+// Returns nullptr (with *skip set) when POSIX mqueues are unusable here.
+std::unique_ptr<Transport> make_mq(size_t size, std::string* skip) {
+  mq_attr attr{};
+  attr.mq_maxmsg = 10;  // default fs.mqueue.msg_max
+  attr.mq_msgsize = static_cast<long>(size);
+  const std::string base =
+      "/latency_lab_" + std::to_string(static_cast<long>(getpid()));
+  const std::string down_name = base + "_down";
+  const std::string up_name = base + "_up";
+  const mqd_t down =
+      mq_open(down_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600,
+              &attr);
+  const int down_errno = errno;
+  const mqd_t up =
+      mq_open(up_name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600,
+              &attr);
+  const int up_errno = errno;
+  // Descriptors survive unlink and fork; nothing is left behind on exit.
+  mq_unlink(down_name.c_str());
+  mq_unlink(up_name.c_str());
+  if (down == static_cast<mqd_t>(-1) || up == static_cast<mqd_t>(-1)) {
+    *skip = std::string("mq_open failed: ") +
+            std::strerror(down == static_cast<mqd_t>(-1) ? down_errno
+                                                         : up_errno) +
+            " (check /dev/mqueue and fs.mqueue.msgsize_max)";
+    if (down != static_cast<mqd_t>(-1)) {
+      mq_close(down);
+    }
+    if (up != static_cast<mqd_t>(-1)) {
+      mq_close(up);
+    }
+    return nullptr;
+  }
+  auto transport = std::make_unique<MqTransport>(down, up);
+  transport->set_max_len(size);
+  return transport;
+}
+
+// --- Case plumbing ----------------------------------------------------------
+
+struct IpcState {
+  Placement placement;
+  std::unique_ptr<Transport> transport;
+  std::vector<char> buffer;
+  size_t size = 64;
+  bool stream = false;
+  uint64_t burst = 32;
+  pid_t child = -1;
+  uint64_t measured_ns = 0;
+  uint64_t measured_msgs = 0;
+};
+
+std::unique_ptr<IpcState> g_state;
+
+// Child: echo every message (pingpong) or ack every `burst` (stream).
+[[noreturn]] void child_main(IpcState* state) {
+  if (state->placement.peer_cpu >= 0) {
+    std::string error;
+    if (!pin_to_cpu(state->placement.peer_cpu, &error)) {
+      std::cerr << "ipc peer: failed to pin to cpu "
+                << state->placement.peer_cpu << ": " << error << "\n";
+      _exit(2);
+    }
+  }
+  Transport& transport = *state->transport;
+  char* data = state->buffer.data();
+  uint64_t received = 0;
+  while (transport.recv(data, state->size)) {
+    ++received;
+    if (state->stream && received % state->burst != 0) {
+      continue;
+    }
+    if (!transport.send(data, state->size)) {
+      _exit(3);
+    }
+  }
+  _exit(0);
+}
+
+void ipc_setup(Ctx* ctx, Mechanism mechanism) {
+  auto state = std::make_unique<IpcState>();
+  state->size = param_u64(*ctx, "size", 64);
+  if (state->size == 0) {
+    std::cerr << "ipc: size must be > 0\n";
+    std::exit(1);
+  }
+  state->stream =
+      param_choice(*ctx, "mode", {"pingpong", "stream"}, "pingpong") ==
+      "stream";
+  state->burst = std::max<uint64_t>(1, param_u64(*ctx, "burst", 32));
+  state->buffer.assign(state->size, 'x');
+
+  if (!setup_placement(ctx, &state->placement)) {
+    return;
+  }
+
+  switch (mechanism) {
+    case Mechanism::kPipe:
+      state->transport = make_pipe();
+      break;
+    case Mechanism::kUnixStream:
+      state->transport = make_unix_stream();
+      break;
+    case Mechanism::kUnixDgram:
+      state->transport = make_unix_dgram(state->size);
+      break;
+    case Mechanism::kSocketpair:
+      state->transport = make_socketpair();
+      break;
+    case Mechanism::kMq:
+      state->transport = make_mq(state->size, &ctx->skip_reason);
+      if (!state->transport) {
+        restore_placement(*ctx, state->placement);
+        return;
+      }
+      break;
+    case Mechanism::kShmRing:
+      state->transport = std::make_unique<ShmRingTransport>(
+          std::max<uint64_t>(2, param_u64(*ctx, "slots", 64)), state->size,
+          param_u64(*ctx, "spin", 1000));
+      break;
+  }
+
+  // A dead peer should surface as a failed send, not kill the bench.
+  std::signal(SIGPIPE, SIG_IGN);
+
+  const pid_t pid = fork();
+  if (pid < 0) {
+    fail("fork");
+  }
+  if (pid == 0) {
+    state->transport->become_child();
+    child_main(state.get());
+  }
+  state->child = pid;
+  state->transport->become_parent();
+  g_state = std::move(state);
+}
+
+void ipc_run_once(Ctx* ctx) {
+  IpcState& state = *g_state;
+  char* data = state.buffer.data();
+  const uint64_t messages = state.stream ? state.burst : 1;
+
+  const uint64_t start = now_ns();
+  for (uint64_t i = 0; i < messages; ++i) {
+    if (!state.transport->send(data, state.size)) {
+      fail("send to peer");
+    }
+  }
+  if (!state.transport->recv(data, state.size)) {
+    fail("recv from peer");
+  }
+  const uint64_t elapsed = now_ns() - start;
+
+  record_sample(ctx, elapsed / messages);
+  if (!ctx->warming_up) {
+    state.measured_ns += elapsed;
+    state.measured_msgs += messages;
+  }
+}
+
+void ipc_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  IpcState& state = *g_state;
+  if (state.child > 0) {
+    state.transport->shutdown();
+    int status = 0;
+    while (waitpid(state.child, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      std::cerr << "ipc: peer exited abnormally (status " << status << ")\n";
+    }
+  }
+  if (state.measured_ns > 0) {
+    // Pingpong counts one-way messages from the bench side (the echo is
+    // not counted), so both modes report the bench->peer rate.
+    const double seconds = static_cast<double>(state.measured_ns) / 1e9;
+    const double msgs = static_cast<double>(state.measured_msgs);
+    record_metric(ctx, "msgs_per_sec", msgs / seconds);
+    record_metric(ctx, "mib_per_sec",
+                  msgs * static_cast<double>(state.size) / seconds /
+                      (1024.0 * 1024.0));
+  }
+  restore_placement(*ctx, state.placement);
+  g_state.reset();
+}
+
+template <Mechanism M>
+void setup_for(Ctx* ctx) {
+  ipc_setup(ctx, M);
+}
+
+const Case kIpcPipeCase{
+    "ipc_pipe",
+    setup_for<Mechanism::kPipe>,
+    ipc_run_once,
+    ipc_teardown,
+};
+
+const Case kIpcUnixStreamCase{
+    "ipc_unix_stream",
+    setup_for<Mechanism::kUnixStream>,
+    ipc_run_once,
+    ipc_teardown,
+};
+
+const Case kIpcUnixDgramCase{
+    "ipc_unix_dgram",
+    setup_for<Mechanism::kUnixDgram>,
+    ipc_run_once,
+    ipc_teardown,
+};
+
+const Case kIpcSocketpairCase{
+    "ipc_socketpair",
+    setup_for<Mechanism::kSocketpair>,
+    ipc_run_once,
+    ipc_teardown,
+};
+
+const Case kIpcMqCase{
+    "ipc_mq",
+    setup_for<Mechanism::kMq>,
+    ipc_run_once,
+    ipc_teardown,
+};
+
+const Case kIpcShmRingCase{
+    "ipc_shm_ring",
+    setup_for<Mechanism::kShmRing>,
+    ipc_run_once,
+    ipc_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kIpcPipeCase);
+LATENCY_LAB_REGISTER_CASE(kIpcUnixStreamCase);
+LATENCY_LAB_REGISTER_CASE(kIpcUnixDgramCase);
+LATENCY_LAB_REGISTER_CASE(kIpcSocketpairCase);
+LATENCY_LAB_REGISTER_CASE(kIpcMqCase);
+LATENCY_LAB_REGISTER_CASE(kIpcShmRingCase);
+#endif
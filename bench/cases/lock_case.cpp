@@ -0,0 +1,474 @@
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "spin.h"
+#include "threads.h"
+#include "timer.h"
+
+// Lock contention: the bench thread and `threads - 1` workers repeatedly take
+// the same lock. Each sample is the bench thread's acquire latency (time from
+// calling lock() to owning the lock); the critical section and think time
+// are not timed.
+//
+// Cases: lock_std_mutex, lock_pthread_spin, lock_ttas, lock_ticket, lock_mcs,
+//        lock_clh, lock_shared_mutex
+//
+// Params:
+//   threads=<n>     contending threads including the bench thread (default 4)
+//   cs_ns=<ns>      busy work while holding the lock (default 0)
+//   think_ns=<ns>   busy work between releases and the next acquire (default 0)
+//   read_pct=<0-100> lock_shared_mutex only: share of acquisitions taken in
+//                   shared mode (default 0 = all exclusive)
+//   cpus=<list>     CPUs for the threads, see thread_cpus() in placement.h;
+//                   spinning locks degrade sharply when oversubscribed
+//
+// Metrics: acquires_per_sec (all threads, timed window only) and fairness
+// (fewest / most acquisitions of any thread; 1.0 = perfectly even).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "lock: " << message << "\n";
+  std::exit(1);
+}
+
+struct alignas(64) McsNode {
+  std::atomic<McsNode*> next{nullptr};
+  std::atomic<bool> locked{false};
+};
+
+struct alignas(64) ClhNode {
+  std::atomic<bool> locked{false};
+};
+
+// Per-thread lock bookkeeping: queue-lock nodes, the shared/exclusive choice
+// and the acquisition counter. Each slot is owned by one thread.
+struct alignas(64) LockSlot {
+  McsNode mcs;
+  ClhNode* clh_node = nullptr;
+  ClhNode* clh_pred = nullptr;
+  bool shared = false;
+  uint64_t rng = 0;
+  std::atomic<uint64_t> acquires{0};
+};
+
+class Lock {
+ public:
+  virtual ~Lock() = default;
+  // Called once per slot before any thread starts.
+  virtual void attach(LockSlot*) {}
+  virtual void lock(LockSlot* slot) = 0;
+  virtual void unlock(LockSlot* slot) = 0;
+};
+
+class StdMutexLock final : public Lock {
+ public:
+  void lock(LockSlot*) override { mutex_.lock(); }
+  void unlock(LockSlot*) override { mutex_.unlock(); }
+
+ private:
+  std::mutex mutex_;
+};
+
+#if defined(__linux__)
+class PthreadSpinLock final : public Lock {
+ public:
+  PthreadSpinLock() {
+    if (pthread_spin_init(&lock_, PTHREAD_PROCESS_PRIVATE) != 0) {
+      fail("pthread_spin_init failed");
+    }
+  }
+  ~PthreadSpinLock() override { pthread_spin_destroy(&lock_); }
+  void lock(LockSlot*) override { pthread_spin_lock(&lock_); }
+  void unlock(LockSlot*) override { pthread_spin_unlock(&lock_); }
+
+ private:
+  pthread_spinlock_t lock_;
+};
+#endif
+
+// Test-and-test-and-set: spin on a plain load so waiters share the line
+// until it is released, then race with one exchange.
+class TtasLock final : public Lock {
+ public:
+  void lock(LockSlot*) override {
+    while (true) {
+      while (held_.load(std::memory_order_relaxed)) {
+        cpu_relax();
+      }
+      if (!held_.exchange(true, std::memory_order_acquire)) {
+        return;
+      }
+    }
+  }
+  void unlock(LockSlot*) override {
+    held_.store(false, std::memory_order_release);
+  }
+
+ private:
+  alignas(64) std::atomic<bool> held_{false};
+};
+
+// FIFO, but every waiter spins on the same `serving_` line.
+class TicketLock final : public Lock {
+ public:
+  void lock(LockSlot*) override {
+    const uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    while (serving_.load(std::memory_order_acquire) != ticket) {
+      cpu_relax();
+    }
+  }
+  void unlock(LockSlot*) override {
+    serving_.store(serving_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+  }
+
+ private:
+  alignas(64) std::atomic<uint32_t> next_{0};
+  alignas(64) std::atomic<uint32_t> serving_{0};
+};
+
+// MCS: each waiter spins on its own node; the owner hands off directly.
+class McsLock final : public Lock {
+ public:
+  void lock(LockSlot* slot) override {
+    McsNode* node = &slot->mcs;
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->locked.store(true, std::memory_order_relaxed);
+    McsNode* prev = tail_.exchange(node, std::memory_order_acq_rel);
+    if (prev == nullptr) {
+      return;
+    }
+    prev->next.store(node, std::memory_order_release);
+    while (node->locked.load(std::memory_order_acquire)) {
+      cpu_relax();
+    }
+  }
+  void unlock(LockSlot* slot) override {
+    McsNode* node = &slot->mcs;
+    McsNode* next = node->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      McsNode* expected = node;
+      if (tail_.compare_exchange_strong(expected, nullptr,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+        return;
+      }
+      // A successor swapped the tail but has not linked itself yet.
+      while ((next = node->next.load(std::memory_order_acquire)) == nullptr) {
+        cpu_relax();
+      }
+    }
+    next->locked.store(false, std::memory_order_release);
+  }
+
+ private:
+  alignas(64) std::atomic<McsNode*> tail_{nullptr};
+};
+
+// CLH: each waiter spins on its predecessor's node and recycles it on
+// unlock, so nodes migrate between threads.
+class ClhLock final : public Lock {
+ public:
+  ClhLock() {
+    nodes_.push_back(std::make_unique<ClhNode>());
+    tail_.store(nodes_.back().get(), std::memory_order_relaxed);
+  }
+  void attach(LockSlot* slot) override {
+    nodes_.push_back(std::make_unique<ClhNode>());
+    slot->clh_node = nodes_.back().get();
+  }
+  void lock(LockSlot* slot) override {
+    ClhNode* node = slot->clh_node;
+    node->locked.store(true, std::memory_order_relaxed);
+    ClhNode* pred = tail_.exchange(node, std::memory_order_acq_rel);
+    while (pred->locked.load(std::memory_order_acquire)) {
+      cpu_relax();
+    }
+    slot->clh_pred = pred;
+  }
+  void unlock(LockSlot* slot) override {
+    slot->clh_node->locked.store(false, std::memory_order_release);
+    slot->clh_node = slot->clh_pred;
+  }
+
+ private:
+  alignas(64) std::atomic<ClhNode*> tail_{nullptr};
+  std::vector<std::unique_ptr<ClhNode>> nodes_;
+};
+
+class SharedMutexLock final : public Lock {
+ public:
+  explicit SharedMutexLock(uint64_t read_pct) : read_pct_(read_pct) {}
+  void lock(LockSlot* slot) override {
+    // xorshift64: cheap enough to keep out of the measured latency's noise.
+    slot->rng ^= slot->rng << 13;
+    slot->rng ^= slot->rng >> 7;
+    slot->rng ^= slot->rng << 17;
+    slot->shared = slot->rng % 100 < read_pct_;
+    if (slot->shared) {
+      mutex_.lock_shared();
+    } else {
+      mutex_.lock();
+    }
+  }
+  void unlock(LockSlot* slot) override {
+    if (slot->shared) {
+      mutex_.unlock_shared();
+    } else {
+      mutex_.unlock();
+    }
+  }
+
+ private:
+  std::shared_mutex mutex_;
+  uint64_t read_pct_;
+};
+
+enum class LockKind {
+  kStdMutex,
+  kPthreadSpin,
+  kTtas,
+  kTicket,
+  kMcs,
+  kClh,
+  kSharedMutex,
+};
+
+std::unique_ptr<Lock> make_lock(LockKind kind, uint64_t read_pct) {
+  switch (kind) {
+    case LockKind::kStdMutex:
+      return std::make_unique<StdMutexLock>();
+    case LockKind::kPthreadSpin:
+#if defined(__linux__)
+      return std::make_unique<PthreadSpinLock>();
+#else
+      fail("pthread spinlocks are not available on this platform");
+#endif
+    case LockKind::kTtas:
+      return std::make_unique<TtasLock>();
+    case LockKind::kTicket:
+      return std::make_unique<TicketLock>();
+    case LockKind::kMcs:
+      return std::make_unique<McsLock>();
+    case LockKind::kClh:
+      return std::make_unique<ClhLock>();
+    case LockKind::kSharedMutex:
+      return std::make_unique<SharedMutexLock>(read_pct);
+  }
+  return nullptr;
+}
+
+struct LockState {
+  std::unique_ptr<Lock> lock;
+  std::vector<LockSlot> slots;  // slot 0 is the bench thread
+  std::vector<std::thread> workers;
+  uint64_t cs_ns = 0;
+  uint64_t think_ns = 0;
+  std::atomic<bool> stop{false};
+  // Data "protected" by the lock, so the critical section touches a line
+  // that moves with lock ownership.
+  alignas(64) uint64_t protected_counter = 0;
+  bool window_open = false;
+  uint64_t window_start_ns = 0;
+  std::vector<uint64_t> window_start_acquires;
+};
+
+std::unique_ptr<LockState> g_state;
+
+void critical_section(LockState* state, LockSlot* slot) {
+  if (!slot->shared) {
+    ++state->protected_counter;
+  }
+  spin_for_ns(state->cs_ns);
+  slot->acquires.store(slot->acquires.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+}
+
+void worker_loop(LockState* state, LockSlot* slot) {
+  while (!state->stop.load(std::memory_order_relaxed)) {
+    spin_for_ns(state->think_ns);
+    state->lock->lock(slot);
+    critical_section(state, slot);
+    state->lock->unlock(slot);
+  }
+}
+
+void lock_setup(Ctx* ctx, LockKind kind) {
+  auto state = std::make_unique<LockState>();
+  const uint64_t threads = std::max<uint64_t>(1, param_u64(*ctx, "threads", 4));
+  state->cs_ns = param_u64(*ctx, "cs_ns", 0);
+  state->think_ns = param_u64(*ctx, "think_ns", 0);
+  const uint64_t read_pct =
+      std::min<uint64_t>(100, param_u64(*ctx, "read_pct", 0));
+  state->lock = make_lock(kind, read_pct);
+
+  state->slots = std::vector<LockSlot>(threads);
+  for (size_t i = 0; i < state->slots.size(); ++i) {
+    state->slots[i].rng = 0x9e3779b97f4a7c15ull * (i + 1);
+    state->lock->attach(&state->slots[i]);
+  }
+
+  const std::vector<int> cpus = thread_cpus(*ctx, threads);
+  std::string error;
+  if (cpus[0] >= 0 && !pin_to_cpu(cpus[0], &error)) {
+    fail("failed to pin to cpu " + std::to_string(cpus[0]) + ": " + error);
+  }
+  LockState* raw = state.get();
+  state->workers.resize(threads - 1);
+  for (size_t i = 1; i < threads; ++i) {
+    LockSlot* slot = &state->slots[i];
+    if (!start_pinned_thread(
+            cpus[i], [raw, slot]() { worker_loop(raw, slot); },
+            &state->workers[i - 1], &error)) {
+      fail("failed to start worker: " + error);
+    }
+  }
+  g_state = std::move(state);
+}
+
+void lock_run_once(Ctx* ctx) {
+  LockState& state = *g_state;
+  if (!ctx->warming_up && !state.window_open) {
+    state.window_open = true;
+    state.window_start_ns = now_ns();
+    for (const LockSlot& slot : state.slots) {
+      state.window_start_acquires.push_back(
+          slot.acquires.load(std::memory_order_relaxed));
+    }
+  }
+  LockSlot* slot = &state.slots[0];
+  spin_for_ns(state.think_ns);
+  const uint64_t start = now_ns();
+  state.lock->lock(slot);
+  const uint64_t acquired = now_ns();
+  critical_section(&state, slot);
+  state.lock->unlock(slot);
+  record_sample(ctx, acquired - start);
+}
+
+void lock_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  LockState& state = *g_state;
+  const uint64_t end_ns = now_ns();
+  std::vector<uint64_t> window_acquires;
+  for (size_t i = 0; i < state.slots.size(); ++i) {
+    const uint64_t start =
+        state.window_open ? state.window_start_acquires[i] : 0;
+    window_acquires.push_back(
+        state.slots[i].acquires.load(std::memory_order_relaxed) - start);
+  }
+  state.stop.store(true, std::memory_order_relaxed);
+  for (std::thread& worker : state.workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  if (state.window_open && end_ns > state.window_start_ns) {
+    uint64_t total = 0;
+    for (uint64_t count : window_acquires) {
+      total += count;
+    }
+    const auto [least, most] =
+        std::minmax_element(window_acquires.begin(), window_acquires.end());
+    const double seconds =
+        static_cast<double>(end_ns - state.window_start_ns) / 1e9;
+    record_metric(ctx, "acquires_per_sec",
+                  static_cast<double>(total) / seconds);
+    record_metric(ctx, "fairness",
+                  *most == 0 ? 0.0
+                             : static_cast<double>(*least) /
+                                   static_cast<double>(*most));
+  }
+
+  restore_affinity(*ctx);
+  g_state.reset();
+}
+
+template <LockKind K>
+void setup_for(Ctx* ctx) {
+  lock_setup(ctx, K);
+}
+
+const Case kLockStdMutexCase{
+    "lock_std_mutex",
+    setup_for<LockKind::kStdMutex>,
+    lock_run_once,
+    lock_teardown,
+};
+
+#if defined(__linux__)
+const Case kLockPthreadSpinCase{
+    "lock_pthread_spin",
+    setup_for<LockKind::kPthreadSpin>,
+    lock_run_once,
+    lock_teardown,
+};
+#endif
+
+const Case kLockTtasCase{
+    "lock_ttas",
+    setup_for<LockKind::kTtas>,
+    lock_run_once,
+    lock_teardown,
+};
+
+const Case kLockTicketCase{
+    "lock_ticket",
+    setup_for<LockKind::kTicket>,
+    lock_run_once,
+    lock_teardown,
+};
+
+const Case kLockMcsCase{
+    "lock_mcs",
+    setup_for<LockKind::kMcs>,
+    lock_run_once,
+    lock_teardown,
+};
+
+const Case kLockClhCase{
+    "lock_clh",
+    setup_for<LockKind::kClh>,
+    lock_run_once,
+    lock_teardown,
+};
+
+const Case kLockSharedMutexCase{
+    "lock_shared_mutex",
+    setup_for<LockKind::kSharedMutex>,
+    lock_run_once,
+    lock_teardown,
+};
+
+}  // namespace
+
+LATENCY_LAB_REGISTER_CASE(kLockStdMutexCase);
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kLockPthreadSpinCase);
+#endif
+LATENCY_LAB_REGISTER_CASE(kLockTtasCase);
+LATENCY_LAB_REGISTER_CASE(kLockTicketCase);
+LATENCY_LAB_REGISTER_CASE(kLockMcsCase);
+LATENCY_LAB_REGISTER_CASE(kLockClhCase);
+LATENCY_LAB_REGISTER_CASE(kLockSharedMutexCase);
@@ -0,0 +1,558 @@
+#include "case.h"
+#include "params.h"
+#include "placement.h"
+#include "registry.h"
+#include "spin.h"
+#include "threads.h"
+#include "timer.h"
+
+// Loopback (127.0.0.1) networking baseline: the bench thread is the client,
+// a pinned server thread answers. No external network is involved, so this
+// measures the kernel stack, socket layer and wakeup path only.
+//
+// Cases:
+//   net_tcp_rr       TCP request/response of `size` bytes each way on one
+//                    long-lived connection (TCP_NODELAY)
+//   net_tcp_connect  socket + connect + server accept + server close + client
+//                    sees EOF + close, per sample
+//   net_udp_pingpong UDP echo of one `size`-byte datagram
+//
+// Params:
+//   size=<bytes>           payload size (default 64; UDP max 65507)
+//   wait=block|epoll|spin  how both sides wait for data:
+//                            block (default): blocking syscalls
+//                            epoll: non-blocking sockets, EPOLLET, drain
+//                                   until EAGAIN before epoll_wait
+//                            spin:  non-blocking sockets polled in a loop,
+//                                   with SO_BUSY_POLL requested
+//   busy_poll_us=<n>       SO_BUSY_POLL value in spin mode (default 50).
+//                          Raising it needs CAP_NET_ADMIN; the value actually
+//                          applied is reported as the busy_poll_us metric.
+//                          Loopback has no NAPI context, so spin mode mostly
+//                          measures plain non-blocking polling.
+//   placement/peer_cpu     see placement.h; the server thread is the peer.
+//                          wait=spin with placement=same only progresses on
+//                          preemption and is not meaningful.
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "loopback: " << message << ": " << std::strerror(errno) << "\n";
+  std::exit(1);
+}
+
+enum class WaitMode {
+  kBlock,
+  kEpoll,
+  kSpin,
+};
+
+// A socket plus whatever its wait mode needs (an edge-triggered epoll set).
+struct Endpoint {
+  int fd = -1;
+  int epfd = -1;
+  WaitMode mode = WaitMode::kBlock;
+};
+
+void close_endpoint(Endpoint* endpoint) {
+  if (endpoint->epfd >= 0) {
+    close(endpoint->epfd);
+    endpoint->epfd = -1;
+  }
+  if (endpoint->fd >= 0) {
+    close(endpoint->fd);
+    endpoint->fd = -1;
+  }
+}
+
+// Returns the SO_BUSY_POLL value in effect (0 if the request was refused).
+int make_endpoint(int fd, WaitMode mode, int busy_poll_us, Endpoint* out) {
+  out->fd = fd;
+  out->mode = mode;
+  if (mode == WaitMode::kBlock) {
+    return 0;
+  }
+  const int flags = fcntl(fd, F_GETFL);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+    fail("fcntl O_NONBLOCK");
+  }
+  if (mode == WaitMode::kEpoll) {
+    out->epfd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = fd;
+    if (out->epfd < 0 || epoll_ctl(out->epfd, EPOLL_CTL_ADD, fd, &event) != 0) {
+      fail("epoll setup");
+    }
+    return 0;
+  }
+  if (busy_poll_us > 0 &&
+      setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us,
+                 sizeof(busy_poll_us)) != 0) {
+    return 0;
+  }
+  return busy_poll_us;
+}
+
+// Called after a non-blocking call returned EAGAIN.
+void wait_readable(const Endpoint& endpoint) {
+  if (endpoint.mode == WaitMode::kSpin) {
+    cpu_relax();
+    return;
+  }
+  epoll_event event{};
+  while (epoll_wait(endpoint.epfd, &event, 1, -1) < 0 && errno == EINTR) {
+  }
+}
+
+// Send buffers are far larger than one payload, so this rarely waits; when
+// it does, poll() is good enough in every mode.
+void wait_writable(const Endpoint& endpoint) {
+  pollfd pfd{endpoint.fd, POLLOUT, 0};
+  while (poll(&pfd, 1, -1) < 0 && errno == EINTR) {
+  }
+}
+
+bool again(int err) {
+  return err == EAGAIN || err == EWOULDBLOCK;
+}
+
+// Stream receive of exactly `len` bytes; false on EOF.
+bool recv_full(const Endpoint& endpoint, char* data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = recv(endpoint.fd, data, len, 0);
+    if (n > 0) {
+      data += n;
+      len -= static_cast<size_t>(n);
+      continue;
+    }
+    if (n == 0) {
+      return false;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (!again(errno)) {
+      return false;
+    }
+    wait_readable(endpoint);
+  }
+  return true;
+}
+
+bool send_full(const Endpoint& endpoint, const char* data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = send(endpoint.fd, data, len, MSG_NOSIGNAL);
+    if (n > 0) {
+      data += n;
+      len -= static_cast<size_t>(n);
+      continue;
+    }
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && again(errno)) {
+      wait_writable(endpoint);
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+// One datagram; returns its length or -1 on error.
+ssize_t recv_datagram(const Endpoint& endpoint, char* data, size_t len) {
+  while (true) {
+    const ssize_t n = recv(endpoint.fd, data, len, 0);
+    if (n >= 0) {
+      return n;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (!again(errno)) {
+      return -1;
+    }
+    wait_readable(endpoint);
+  }
+}
+
+bool send_datagram(const Endpoint& endpoint, const char* data, size_t len) {
+  while (true) {
+    const ssize_t n = send(endpoint.fd, data, len, 0);
+    if (n >= 0) {
+      return static_cast<size_t>(n) == len;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (!again(errno)) {
+      return false;
+    }
+    wait_writable(endpoint);
+  }
+}
+
+sockaddr_in loopback_addr(uint16_t port) {
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  return addr;
+}
+
+// Bind to an ephemeral loopback port and return the bound address.
+sockaddr_in bind_loopback(int fd) {
+  sockaddr_in addr = loopback_addr(0);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+    fail("bind 127.0.0.1");
+  }
+  return addr;
+}
+
+void set_nodelay(int fd) {
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+enum class Protocol {
+  kTcpRr,
+  kTcpConnect,
+  kUdpPingpong,
+};
+
+struct LoopbackState {
+  Placement placement;
+  Protocol protocol = Protocol::kTcpRr;
+  WaitMode mode = WaitMode::kBlock;
+  int busy_poll_us = 0;
+  int applied_busy_poll_us = 0;
+  size_t size = 64;
+  std::vector<char> client_buffer;
+  std::vector<char> server_buffer;
+  Endpoint client;
+  Endpoint server;
+  // net_tcp_connect: the listener is the server endpoint; the client epoll
+  // set is reused across connections.
+  sockaddr_in listen_addr{};
+  std::atomic<bool> stop{false};
+  std::thread server_thread;
+};
+
+std::unique_ptr<LoopbackState> g_state;
+
+// --- Server loops -------------------------------------------------------------
+
+void echo_stream(LoopbackState* state) {
+  char* data = state->server_buffer.data();
+  while (recv_full(state->server, data, state->size)) {
+    if (!send_full(state->server, data, state->size)) {
+      return;
+    }
+  }
+}
+
+void echo_datagrams(LoopbackState* state) {
+  char* data = state->server_buffer.data();
+  while (true) {
+    // A zero-length datagram is the stop message.
+    const ssize_t n = recv_datagram(state->server, data, state->size);
+    if (n <= 0 || !send_datagram(state->server, data, static_cast<size_t>(n))) {
+      return;
+    }
+  }
+}
+
+void accept_and_close(LoopbackState* state) {
+  while (!state->stop.load(std::memory_order_acquire)) {
+    const int fd = accept4(state->server.fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+      close(fd);
+      continue;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    if (!again(errno)) {
+      return;
+    }
+    wait_readable(state->server);
+  }
+}
+
+// --- Setup ------------------------------------------------------------------
+
+void setup_tcp_rr(LoopbackState* state) {
+  const int listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listener < 0) {
+    fail("socket");
+  }
+  const sockaddr_in addr = bind_loopback(listener);
+  if (listen(listener, 1) != 0) {
+    fail("listen");
+  }
+  const int client = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (client < 0 ||
+      connect(client, reinterpret_cast<const sockaddr*>(&addr),
+              sizeof(addr)) != 0) {
+    fail("connect");
+  }
+  const int server = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+  if (server < 0) {
+    fail("accept");
+  }
+  close(listener);
+  set_nodelay(client);
+  set_nodelay(server);
+  state->applied_busy_poll_us =
+      make_endpoint(client, state->mode, state->busy_poll_us, &state->client);
+  make_endpoint(server, state->mode, state->busy_poll_us, &state->server);
+}
+
+void setup_udp(LoopbackState* state) {
+  const int client = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  const int server = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (client < 0 || server < 0) {
+    fail("socket");
+  }
+  const sockaddr_in client_addr = bind_loopback(client);
+  const sockaddr_in server_addr = bind_loopback(server);
+  if (connect(client, reinterpret_cast<const sockaddr*>(&server_addr),
+              sizeof(server_addr)) != 0 ||
+      connect(server, reinterpret_cast<const sockaddr*>(&client_addr),
+              sizeof(client_addr)) != 0) {
+    fail("connect udp");
+  }
+  state->applied_busy_poll_us =
+      make_endpoint(client, state->mode, state->busy_poll_us, &state->client);
+  make_endpoint(server, state->mode, state->busy_poll_us, &state->server);
+}
+
+void setup_tcp_connect(LoopbackState* state) {
+  const int listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listener < 0) {
+    fail("socket");
+  }
+  const int one = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  state->listen_addr = bind_loopback(listener);
+  if (listen(listener, 128) != 0) {
+    fail("listen");
+  }
+  make_endpoint(listener, state->mode, 0, &state->server);
+  if (state->mode == WaitMode::kEpoll) {
+    state->client.epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (state->client.epfd < 0) {
+      fail("epoll_create1");
+    }
+  }
+  state->client.mode = state->mode;
+}
+
+void loopback_setup(Ctx* ctx, Protocol protocol) {
+  auto state = std::make_unique<LoopbackState>();
+  state->protocol = protocol;
+  const std::string wait =
+      param_choice(*ctx, "wait", {"block", "epoll", "spin"}, "block");
+  state->mode = wait == "epoll"  ? WaitMode::kEpoll
+                : wait == "spin" ? WaitMode::kSpin
+                                 : WaitMode::kBlock;
+  state->busy_poll_us = static_cast<int>(param_u64(*ctx, "busy_poll_us", 50));
+  state->size = param_u64(*ctx, "size", 64);
+  if (state->size == 0 ||
+      (protocol == Protocol::kUdpPingpong && state->size > 65507)) {
+    std::cerr << "loopback: size must be in [1, 65507] for UDP and > 0 for "
+                 "TCP\n";
+    std::exit(1);
+  }
+  state->client_buffer.assign(state->size, 'x');
+  state->server_buffer.assign(state->size, 0);
+
+  if (!setup_placement(ctx, &state->placement)) {
+    return;
+  }
+
+  void (*server_loop)(LoopbackState*) = nullptr;
+  switch (protocol) {
+    case Protocol::kTcpRr:
+      setup_tcp_rr(state.get());
+      server_loop = echo_stream;
+      break;
+    case Protocol::kTcpConnect:
+      setup_tcp_connect(state.get());
+      server_loop = accept_and_close;
+      break;
+    case Protocol::kUdpPingpong:
+      setup_udp(state.get());
+      server_loop = echo_datagrams;
+      break;
+  }
+
+  std::string error;
+  LoopbackState* raw = state.get();
+  if (!start_pinned_thread(state->placement.peer_cpu,
+                           [raw, server_loop]() { server_loop(raw); },
+                           &state->server_thread, &error)) {
+    std::cerr << "loopback: failed to start server: " << error << "\n";
+    std::exit(1);
+  }
+  g_state = std::move(state);
+}
+
+// --- Timed operations -------------------------------------------------------
+
+void tcp_rr_run_once(Ctx* ctx) {
+  LoopbackState& state = *g_state;
+  char* data = state.client_buffer.data();
+  const uint64_t start = now_ns();
+  if (!send_full(state.client, data, state.size) ||
+      !recv_full(state.client, data, state.size)) {
+    fail("tcp round trip");
+  }
+  record_sample(ctx, now_ns() - start);
+}
+
+void udp_run_once(Ctx* ctx) {
+  LoopbackState& state = *g_state;
+  char* data = state.client_buffer.data();
+  const uint64_t start = now_ns();
+  if (!send_datagram(state.client, data, state.size) ||
+      recv_datagram(state.client, data, state.size) !=
+          static_cast<ssize_t>(state.size)) {
+    fail("udp round trip");
+  }
+  record_sample(ctx, now_ns() - start);
+}
+
+void tcp_connect_run_once(Ctx* ctx) {
+  LoopbackState& state = *g_state;
+  const uint64_t start = now_ns();
+  // connect() stays blocking (the handshake completes in-kernel on
+  // loopback); the wait mode applies to waiting for the server's close.
+  const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 ||
+      connect(fd, reinterpret_cast<const sockaddr*>(&state.listen_addr),
+              sizeof(state.listen_addr)) != 0) {
+    fail("connect");
+  }
+  Endpoint conn;
+  conn.fd = fd;
+  conn.mode = state.mode;
+  if (state.mode != WaitMode::kBlock &&
+      fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) {
+    fail("fcntl O_NONBLOCK");
+  }
+  if (state.mode == WaitMode::kEpoll) {
+    // Closing the socket drops it from the shared epoll set again.
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.fd = fd;
+    if (epoll_ctl(state.client.epfd, EPOLL_CTL_ADD, fd, &event) != 0) {
+      fail("epoll_ctl");
+    }
+    conn.epfd = state.client.epfd;
+  }
+  char byte = 0;
+  if (recv_full(conn, &byte, 1)) {
+    std::cerr << "loopback: server sent data on a connect probe\n";
+    std::exit(1);
+  }
+  close(fd);
+  record_sample(ctx, now_ns() - start);
+}
+
+void loopback_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  LoopbackState& state = *g_state;
+  if (state.server_thread.joinable()) {
+    switch (state.protocol) {
+      case Protocol::kTcpRr:
+        shutdown(state.client.fd, SHUT_WR);
+        break;
+      case Protocol::kUdpPingpong:
+        send_datagram(state.client, nullptr, 0);
+        break;
+      case Protocol::kTcpConnect: {
+        // Wake a blocked accept() with one last connection.
+        state.stop.store(true, std::memory_order_release);
+        const int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0) {
+          connect(fd, reinterpret_cast<const sockaddr*>(&state.listen_addr),
+                  sizeof(state.listen_addr));
+          close(fd);
+        }
+        break;
+      }
+    }
+    state.server_thread.join();
+  }
+  if (state.mode == WaitMode::kSpin && state.protocol != Protocol::kTcpConnect) {
+    record_metric(ctx, "busy_poll_us", state.applied_busy_poll_us);
+  }
+  close_endpoint(&state.client);
+  close_endpoint(&state.server);
+  restore_placement(*ctx, state.placement);
+  g_state.reset();
+}
+
+template <Protocol P>
+void setup_for(Ctx* ctx) {
+  loopback_setup(ctx, P);
+}
+
+const Case kNetTcpRrCase{
+    "net_tcp_rr",
+    setup_for<Protocol::kTcpRr>,
+    tcp_rr_run_once,
+    loopback_teardown,
+};
+
+const Case kNetTcpConnectCase{
+    "net_tcp_connect",
+    setup_for<Protocol::kTcpConnect>,
+    tcp_connect_run_once,
+    loopback_teardown,
+};
+
+const Case kNetUdpPingpongCase{
+    "net_udp_pingpong",
+    setup_for<Protocol::kUdpPingpong>,
+    udp_run_once,
+    loopback_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kNetTcpRrCase);
+LATENCY_LAB_REGISTER_CASE(kNetTcpConnectCase);
+LATENCY_LAB_REGISTER_CASE(kNetUdpPingpongCase);
+#endif
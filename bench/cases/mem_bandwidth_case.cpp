@@ -0,0 +1,710 @@
+#include "artifacts.h"
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "threads.h"
+#include "timer.h"
+
+// Memory bandwidth, STREAM-style. Every thread streams one kernel over its
+// own slice of the arrays, one chunk at a time. Each sample is one chunk on
+// the bench thread, so raw.csv holds per-chunk latency. Bandwidth counts
+// every thread's chunks over the timed window.
+//
+// Cases (bytes counted per element, STREAM convention, no write-allocate):
+//   mem_bw_copy   c = a            16
+//   mem_bw_scale  b = s * c        16
+//   mem_bw_add    c = a + b        24
+//   mem_bw_triad  a = b + s * c    24
+//   mem_bw_read   sum += a          8
+//   mem_bw_write  a = s             8
+//
+// Params:
+//   isa=auto|scalar|sse2|avx2|avx512  kernel implementation (default auto =
+//                           widest the CPU supports; checked via cpuid at
+//                           runtime, unsupported choices skip)
+//   nt=true|false           non-temporal (streaming) stores; SIMD isa only
+//   threads=<list>          thread counts to sweep in the order given, e.g.
+//                           4,1,2 or 1-8 (default 1). --iters is split
+//                           evenly across them.
+//   array_mib=<n>           size of each array (default 128)
+//   chunk_kib=<n>           per-array bytes per chunk (default 256)
+//   cpus=<list>             see thread_cpus() in placement.h
+//
+// Results per thread count go to sweep.csv:
+//   threads,chunks,gb_per_sec,p50_chunk_ns,p99_chunk_ns
+// and to metrics as gb_per_sec_t<threads>. GB = 1e9 bytes.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+enum class Kernel {
+  kCopy,
+  kScale,
+  kAdd,
+  kTriad,
+  kRead,
+  kWrite,
+};
+
+enum class Isa {
+  kScalar,
+  kSse2,
+  kAvx2,
+  kAvx512,
+};
+
+struct KernelArgs {
+  Kernel kernel = Kernel::kCopy;
+  bool nt = false;
+  double* a = nullptr;
+  double* b = nullptr;
+  double* c = nullptr;
+  size_t n = 0;  // elements; a multiple of 32
+  double scalar = 3.0;
+};
+
+volatile double g_sink = 0.0;
+
+uint64_t bytes_per_element(Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kCopy:
+    case Kernel::kScale:
+      return 16;
+    case Kernel::kAdd:
+    case Kernel::kTriad:
+      return 24;
+    case Kernel::kRead:
+    case Kernel::kWrite:
+      return 8;
+  }
+  return 0;
+}
+
+// One loop nest per kernel, shared by every ISA: `Ops` supplies the register
+// type and load/store/arithmetic for one ISA, kStream picks streaming or
+// normal stores. The templates are only ever inlined into the per-ISA entry
+// points below, so GCC's warning that vectors crossing a call outside their
+// target change the ABI does not apply.
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+template <typename Ops, bool kStream>
+inline void put(double* p, const typename Ops::Reg& v) {
+  if constexpr (kStream) {
+    Ops::stream(p, v);
+  } else {
+    Ops::store(p, v);
+  }
+}
+
+template <typename Ops, Kernel K, bool kStream>
+inline void bw_kernel(const KernelArgs& args) {
+  using Reg = typename Ops::Reg;
+  constexpr size_t W = Ops::kWidth;
+  const Reg s = Ops::set1(args.scalar);
+  double* a = args.a;
+  double* b = args.b;
+  double* c = args.c;
+  const size_t n = args.n;
+  if constexpr (K == Kernel::kCopy) {
+    for (size_t i = 0; i < n; i += W) {
+      put<Ops, kStream>(c + i, Ops::load(a + i));
+    }
+  } else if constexpr (K == Kernel::kScale) {
+    for (size_t i = 0; i < n; i += W) {
+      put<Ops, kStream>(b + i, Ops::mul(s, Ops::load(c + i)));
+    }
+  } else if constexpr (K == Kernel::kAdd) {
+    for (size_t i = 0; i < n; i += W) {
+      put<Ops, kStream>(c + i, Ops::add(Ops::load(a + i), Ops::load(b + i)));
+    }
+  } else if constexpr (K == Kernel::kTriad) {
+    for (size_t i = 0; i < n; i += W) {
+      put<Ops, kStream>(
+          a + i, Ops::add(Ops::load(b + i), Ops::mul(s, Ops::load(c + i))));
+    }
+  } else if constexpr (K == Kernel::kRead) {
+    // Four accumulators hide the add latency.
+    Reg acc0 = Ops::set1(0.0);
+    Reg acc1 = Ops::set1(0.0);
+    Reg acc2 = Ops::set1(0.0);
+    Reg acc3 = Ops::set1(0.0);
+    for (size_t i = 0; i < n; i += 4 * W) {
+      acc0 = Ops::add(acc0, Ops::load(a + i));
+      acc1 = Ops::add(acc1, Ops::load(a + i + W));
+      acc2 = Ops::add(acc2, Ops::load(a + i + 2 * W));
+      acc3 = Ops::add(acc3, Ops::load(a + i + 3 * W));
+    }
+    alignas(64) double lanes[8] = {};
+    Ops::store(lanes, Ops::add(Ops::add(acc0, acc1), Ops::add(acc2, acc3)));
+    double sum = 0.0;
+    for (size_t i = 0; i < W; ++i) {
+      sum += lanes[i];
+    }
+    g_sink = sum;
+  } else {
+    for (size_t i = 0; i < n; i += W) {
+      put<Ops, kStream>(a + i, s);
+    }
+  }
+  if constexpr (kStream) {
+    Ops::fence();
+  }
+}
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+// Scalar: keep the compiler from auto-vectorizing, or "scalar" would just
+// be SSE2 again.
+#if defined(__GNUC__) && !defined(__clang__)
+#define LATENCY_LAB_NO_VECTORIZE __attribute__((optimize("no-tree-vectorize")))
+#else
+#define LATENCY_LAB_NO_VECTORIZE
+#endif
+
+// Each ISA's `run` is the dispatch entry point. It carries the ISA's target
+// attribute and is flattened, so the kernel template and the ops are
+// inlined into code built for that ISA.
+struct ScalarOps {
+  using Reg = double;
+  static constexpr size_t kWidth = 1;
+  static Reg load(const double* p) { return *p; }
+  static void store(double* p, Reg v) { *p = v; }
+  static void stream(double* p, Reg v) { *p = v; }
+  static Reg add(Reg x, Reg y) { return x + y; }
+  static Reg mul(Reg x, Reg y) { return x * y; }
+  static Reg set1(double x) { return x; }
+  static void fence() {}
+  template <Kernel K, bool kStream>
+  LATENCY_LAB_NO_VECTORIZE __attribute__((flatten)) static void run(
+      const KernelArgs& args) {
+    bw_kernel<ScalarOps, K, kStream>(args);
+  }
+};
+
+#if defined(__x86_64__)
+#define LATENCY_LAB_SSE2 __attribute__((target("sse2")))
+#define LATENCY_LAB_AVX2 __attribute__((target("avx2")))
+#define LATENCY_LAB_AVX512 __attribute__((target("avx512f")))
+
+struct Sse2Ops {
+  using Reg = __m128d;
+  static constexpr size_t kWidth = 2;
+  LATENCY_LAB_SSE2 static Reg load(const double* p) { return _mm_load_pd(p); }
+  LATENCY_LAB_SSE2 static void store(double* p, Reg v) { _mm_store_pd(p, v); }
+  LATENCY_LAB_SSE2 static void stream(double* p, Reg v) {
+    _mm_stream_pd(p, v);
+  }
+  LATENCY_LAB_SSE2 static Reg add(Reg x, Reg y) { return _mm_add_pd(x, y); }
+  LATENCY_LAB_SSE2 static Reg mul(Reg x, Reg y) { return _mm_mul_pd(x, y); }
+  LATENCY_LAB_SSE2 static Reg set1(double x) { return _mm_set1_pd(x); }
+  LATENCY_LAB_SSE2 static void fence() { _mm_sfence(); }
+  template <Kernel K, bool kStream>
+  LATENCY_LAB_SSE2 __attribute__((flatten)) static void run(
+      const KernelArgs& args) {
+    bw_kernel<Sse2Ops, K, kStream>(args);
+  }
+};
+
+struct Avx2Ops {
+  using Reg = __m256d;
+  static constexpr size_t kWidth = 4;
+  LATENCY_LAB_AVX2 static Reg load(const double* p) {
+    return _mm256_load_pd(p);
+  }
+  LATENCY_LAB_AVX2 static void store(double* p, Reg v) {
+    _mm256_store_pd(p, v);
+  }
+  LATENCY_LAB_AVX2 static void stream(double* p, Reg v) {
+    _mm256_stream_pd(p, v);
+  }
+  LATENCY_LAB_AVX2 static Reg add(Reg x, Reg y) { return _mm256_add_pd(x, y); }
+  LATENCY_LAB_AVX2 static Reg mul(Reg x, Reg y) { return _mm256_mul_pd(x, y); }
+  LATENCY_LAB_AVX2 static Reg set1(double x) { return _mm256_set1_pd(x); }
+  LATENCY_LAB_AVX2 static void fence() { _mm_sfence(); }
+  template <Kernel K, bool kStream>
+  LATENCY_LAB_AVX2 __attribute__((flatten)) static void run(
+      const KernelArgs& args) {
+    bw_kernel<Avx2Ops, K, kStream>(args);
+  }
+};
+
+struct Avx512Ops {
+  using Reg = __m512d;
+  static constexpr size_t kWidth = 8;
+  LATENCY_LAB_AVX512 static Reg load(const double* p) {
+    return _mm512_load_pd(p);
+  }
+  LATENCY_LAB_AVX512 static void store(double* p, Reg v) {
+    _mm512_store_pd(p, v);
+  }
+  LATENCY_LAB_AVX512 static void stream(double* p, Reg v) {
+    _mm512_stream_pd(p, v);
+  }
+  LATENCY_LAB_AVX512 static Reg add(Reg x, Reg y) {
+    return _mm512_add_pd(x, y);
+  }
+  LATENCY_LAB_AVX512 static Reg mul(Reg x, Reg y) {
+    return _mm512_mul_pd(x, y);
+  }
+  LATENCY_LAB_AVX512 static Reg set1(double x) { return _mm512_set1_pd(x); }
+  LATENCY_LAB_AVX512 static void fence() { _mm_sfence(); }
+  template <Kernel K, bool kStream>
+  LATENCY_LAB_AVX512 __attribute__((flatten)) static void run(
+      const KernelArgs& args) {
+    bw_kernel<Avx512Ops, K, kStream>(args);
+  }
+};
+#endif
+
+// Dispatch table: one row per ISA (in Isa order), indexed by
+// kernel_slot(kernel, nt).
+using KernelFn = void (*)(const KernelArgs&);
+constexpr size_t kKernelCount = static_cast<size_t>(Kernel::kWrite) + 1;
+using KernelRow = std::array<KernelFn, 2 * kKernelCount>;
+
+constexpr size_t kernel_slot(Kernel kernel, bool nt) {
+  return 2 * static_cast<size_t>(kernel) + (nt ? 1 : 0);
+}
+
+template <typename Ops, size_t... I>
+constexpr KernelRow kernel_row(std::index_sequence<I...>) {
+  return {&Ops::template run<static_cast<Kernel>(I / 2), I % 2 != 0>...};
+}
+
+template <typename Ops>
+constexpr KernelRow kernel_row() {
+  return kernel_row<Ops>(std::make_index_sequence<2 * kKernelCount>());
+}
+
+const KernelRow kKernels[] = {
+    kernel_row<ScalarOps>(),
+#if defined(__x86_64__)
+    kernel_row<Sse2Ops>(),
+    kernel_row<Avx2Ops>(),
+    kernel_row<Avx512Ops>(),
+#endif
+};
+
+bool isa_supported(Isa isa) {
+  switch (isa) {
+    case Isa::kScalar:
+      return true;
+#if defined(__x86_64__)
+    case Isa::kSse2:
+      return __builtin_cpu_supports("sse2");
+    case Isa::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case Isa::kAvx512:
+      return __builtin_cpu_supports("avx512f");
+#else
+    default:
+      return false;
+#endif
+  }
+  return false;
+}
+
+// Only ISAs that isa_supported() accepts reach here, so the row exists.
+void run_kernel(Isa isa, const KernelArgs& args) {
+  kKernels[static_cast<size_t>(isa)][kernel_slot(args.kernel, args.nt)](args);
+}
+
+// --- Case plumbing ----------------------------------------------------------
+
+// Untimed chunks on the bench thread after (re)starting a thread count.
+constexpr uint64_t kSegmentWarmupChunks = 16;
+
+struct alignas(64) Progress {
+  std::atomic<uint64_t> chunks{0};
+};
+
+struct Segment {
+  uint64_t threads = 1;
+  std::vector<uint64_t> chunk_ns;
+  uint64_t chunks = 0;  // all threads, timed window
+  double seconds = 0.0;
+};
+
+struct BandwidthState {
+  Kernel kernel = Kernel::kCopy;
+  Isa isa = Isa::kScalar;
+  bool nt = false;
+  double* arrays = nullptr;  // a, b, c back to back
+  size_t array_elems = 0;
+  size_t map_bytes = 0;
+  size_t chunk_elems = 0;
+  std::vector<int> cpus;
+  std::vector<Segment> segments;
+  uint64_t per_segment = 1;
+  uint64_t measured = 0;
+
+  // Active segment.
+  size_t active = 0;
+  bool running = false;
+  size_t slice_elems = 0;
+  size_t bench_chunk = 0;
+  std::vector<std::thread> workers;
+  std::vector<Progress> progress;
+  std::atomic<bool> stop{false};
+  uint64_t bench_chunks = 0;
+  bool window_open = false;
+  uint64_t window_start_ns = 0;
+  uint64_t window_start_chunks = 0;
+};
+
+std::unique_ptr<BandwidthState> g_state;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "mem_bandwidth: " << message << "\n";
+  std::exit(1);
+}
+
+KernelArgs chunk_args(const BandwidthState& state,
+                      size_t thread,
+                      size_t chunk) {
+  const size_t offset = thread * state.slice_elems + chunk * state.chunk_elems;
+  KernelArgs args;
+  args.kernel = state.kernel;
+  args.nt = state.nt;
+  args.a = state.arrays + offset;
+  args.b = state.arrays + state.array_elems + offset;
+  args.c = state.arrays + 2 * state.array_elems + offset;
+  args.n = state.chunk_elems;
+  return args;
+}
+
+size_t chunks_per_slice(const BandwidthState& state) {
+  return std::max<size_t>(1, state.slice_elems / state.chunk_elems);
+}
+
+void worker_loop(BandwidthState* state, size_t thread) {
+  const size_t chunks = chunks_per_slice(*state);
+  size_t chunk = 0;
+  uint64_t done = 0;
+  while (!state->stop.load(std::memory_order_relaxed)) {
+    run_kernel(state->isa, chunk_args(*state, thread, chunk));
+    chunk = chunk + 1 == chunks ? 0 : chunk + 1;
+    state->progress[thread].chunks.store(++done, std::memory_order_relaxed);
+  }
+}
+
+uint64_t total_chunks(const BandwidthState& state) {
+  uint64_t total = state.bench_chunks;
+  for (const Progress& progress : state.progress) {
+    total += progress.chunks.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void close_window(BandwidthState& state) {
+  if (!state.window_open) {
+    return;
+  }
+  Segment& segment = state.segments[state.active];
+  const uint64_t now = now_ns();
+  segment.chunks += total_chunks(state) - state.window_start_chunks;
+  segment.seconds +=
+      static_cast<double>(now - state.window_start_ns) / 1e9;
+  state.window_open = false;
+}
+
+void stop_segment(BandwidthState& state) {
+  if (!state.running) {
+    return;
+  }
+  close_window(state);
+  state.stop.store(true, std::memory_order_relaxed);
+  for (std::thread& worker : state.workers) {
+    worker.join();
+  }
+  state.workers.clear();
+  state.running = false;
+}
+
+void start_segment(BandwidthState& state, size_t index) {
+  stop_segment(state);
+  const uint64_t threads = state.segments[index].threads;
+  state.slice_elems =
+      state.array_elems / threads / state.chunk_elems * state.chunk_elems;
+  state.progress = std::vector<Progress>(threads);
+  state.bench_chunks = 0;
+  state.bench_chunk = 0;
+  state.stop.store(false, std::memory_order_relaxed);
+  state.workers.resize(threads - 1);
+  std::string error;
+  BandwidthState* raw = &state;
+  for (size_t i = 1; i < threads; ++i) {
+    if (!start_pinned_thread(
+            state.cpus[i], [raw, i]() { worker_loop(raw, i); },
+            &state.workers[i - 1], &error)) {
+      fail("failed to start worker: " + error);
+    }
+  }
+  state.active = index;
+  state.running = true;
+  for (uint64_t i = 0; i < kSegmentWarmupChunks; ++i) {
+    run_kernel(state.isa, chunk_args(state, 0, i % chunks_per_slice(state)));
+  }
+}
+
+bool parse_isa(Ctx* ctx, Isa* isa) {
+  const std::string name = param_choice(
+      *ctx, "isa", {"auto", "scalar", "sse2", "avx2", "avx512"}, "auto");
+  if (name == "auto") {
+    for (Isa candidate : {Isa::kAvx512, Isa::kAvx2, Isa::kSse2}) {
+      if (isa_supported(candidate)) {
+        *isa = candidate;
+        return true;
+      }
+    }
+    *isa = Isa::kScalar;
+    return true;
+  }
+  *isa = name == "scalar" ? Isa::kScalar
+         : name == "sse2" ? Isa::kSse2
+         : name == "avx2" ? Isa::kAvx2
+                          : Isa::kAvx512;
+  if (!isa_supported(*isa)) {
+    ctx->skip_reason = "isa=" + name + " not supported by this cpu";
+    return false;
+  }
+  return true;
+}
+
+template <Kernel K>
+void bandwidth_setup(Ctx* ctx) {
+  auto state = std::make_unique<BandwidthState>();
+  state->kernel = K;
+  if (!parse_isa(ctx, &state->isa)) {
+    return;
+  }
+  state->nt = param_bool(*ctx, "nt", false);
+  if (state->nt && state->isa == Isa::kScalar) {
+    ctx->skip_reason = "nt=true needs a SIMD isa";
+    return;
+  }
+  if (state->nt && K == Kernel::kRead) {
+    ctx->skip_reason = "nt=true has no stores to stream in mem_bw_read";
+    return;
+  }
+
+  std::vector<uint64_t> counts = param_u64_list(*ctx, "threads");
+  if (counts.empty()) {
+    counts.push_back(1);
+  }
+  uint64_t max_threads = 1;
+  for (uint64_t count : counts) {
+    if (count == 0) {
+      fail("threads must be positive");
+    }
+    Segment segment;
+    segment.threads = count;
+    state->segments.push_back(segment);
+    max_threads = std::max<uint64_t>(max_threads, segment.threads);
+  }
+
+  // Chunks hold a multiple of 32 doubles (one unrolled AVX-512 read step).
+  state->chunk_elems =
+      std::max<uint64_t>(1, param_u64(*ctx, "chunk_kib", 256) * 1024 / 256) *
+      32;
+  state->array_elems =
+      std::max<uint64_t>(1, param_u64(*ctx, "array_mib", 128)) << 17;
+  if (state->array_elems / max_threads < state->chunk_elems) {
+    fail("array_mib too small for chunk_kib at " +
+         std::to_string(max_threads) + " threads");
+  }
+
+  state->map_bytes = 3 * state->array_elems * sizeof(double);
+#if defined(__linux__)
+  void* arrays = mmap(nullptr, state->map_bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (arrays == MAP_FAILED) {
+    fail("mmap arrays failed");
+  }
+#else
+  void* arrays = std::aligned_alloc(4096, state->map_bytes);
+  if (arrays == nullptr) {
+    fail("allocating arrays failed");
+  }
+#endif
+  state->arrays = static_cast<double*>(arrays);
+  for (size_t i = 0; i < 3 * state->array_elems; ++i) {
+    state->arrays[i] = 1.0;
+  }
+
+  state->cpus = thread_cpus(*ctx, max_threads);
+  std::string error;
+  if (state->cpus[0] >= 0 && !pin_to_cpu(state->cpus[0], &error)) {
+    fail("failed to pin to cpu " + std::to_string(state->cpus[0]) + ": " +
+         error);
+  }
+  state->per_segment =
+      std::max<uint64_t>(1, ctx->iters / state->segments.size());
+  g_state = std::move(state);
+}
+
+void bandwidth_run_once(Ctx* ctx) {
+  BandwidthState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_segment,
+                              state.segments.size() - 1);
+  }
+  if (!state.running || target != state.active) {
+    start_segment(state, target);
+  }
+  if (!ctx->warming_up && !state.window_open) {
+    state.window_open = true;
+    state.window_start_ns = now_ns();
+    state.window_start_chunks = total_chunks(state);
+  }
+
+  const KernelArgs args = chunk_args(state, 0, state.bench_chunk);
+  const uint64_t start = now_ns();
+  run_kernel(state.isa, args);
+  const uint64_t elapsed = now_ns() - start;
+  state.bench_chunk =
+      state.bench_chunk + 1 == chunks_per_slice(state) ? 0
+                                                       : state.bench_chunk + 1;
+  ++state.bench_chunks;
+  if (ctx->warming_up) {
+    return;
+  }
+  state.segments[target].chunk_ns.push_back(elapsed);
+  ++state.measured;
+  record_sample(ctx, elapsed);
+}
+
+double gb_per_sec(const BandwidthState& state, const Segment& segment) {
+  if (segment.seconds <= 0.0) {
+    return 0.0;
+  }
+  const double bytes = static_cast<double>(segment.chunks) *
+                       static_cast<double>(state.chunk_elems) *
+                       static_cast<double>(bytes_per_element(state.kernel));
+  return bytes / segment.seconds / 1e9;
+}
+
+std::string format_sweep(const BandwidthState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "threads,chunks,gb_per_sec,p50_chunk_ns,p99_chunk_ns\n";
+  for (const Segment& segment : state.segments) {
+    if (segment.chunk_ns.empty()) {
+      continue;
+    }
+    std::vector<uint64_t> sorted = segment.chunk_ns;
+    std::sort(sorted.begin(), sorted.end());
+    out << segment.threads << "," << segment.chunks << ","
+        << gb_per_sec(state, segment) << ","
+        << sorted[(sorted.size() - 1) / 2] << ","
+        << sorted[static_cast<size_t>(0.99 *
+                                      static_cast<double>(sorted.size() - 1))]
+        << "\n";
+  }
+  return out.str();
+}
+
+void bandwidth_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  BandwidthState& state = *g_state;
+  stop_segment(state);
+  for (const Segment& segment : state.segments) {
+    if (!segment.chunk_ns.empty()) {
+      record_metric(ctx, "gb_per_sec_t" + std::to_string(segment.threads),
+                    gb_per_sec(state, segment));
+    }
+  }
+  std::string error;
+  if (state.measured > 0 &&
+      !write_artifact(ctx, "sweep.csv", format_sweep(state), &error)) {
+    std::cerr << "mem_bandwidth: failed to write sweep.csv: " << error
+              << "\n";
+  }
+#if defined(__linux__)
+  munmap(state.arrays, state.map_bytes);
+#else
+  std::free(state.arrays);
+#endif
+  restore_affinity(*ctx);
+  g_state.reset();
+}
+
+const Case kMemBwCopyCase{
+    "mem_bw_copy",
+    bandwidth_setup<Kernel::kCopy>,
+    bandwidth_run_once,
+    bandwidth_teardown,
+};
+
+const Case kMemBwScaleCase{
+    "mem_bw_scale",
+    bandwidth_setup<Kernel::kScale>,
+    bandwidth_run_once,
+    bandwidth_teardown,
+};
+
+const Case kMemBwAddCase{
+    "mem_bw_add",
+    bandwidth_setup<Kernel::kAdd>,
+    bandwidth_run_once,
+    bandwidth_teardown,
+};
+
+const Case kMemBwTriadCase{
+    "mem_bw_triad",
+    bandwidth_setup<Kernel::kTriad>,
+    bandwidth_run_once,
+    bandwidth_teardown,
+};
+
+const Case kMemBwReadCase{
+    "mem_bw_read",
+    bandwidth_setup<Kernel::kRead>,
+    bandwidth_run_once,
+    bandwidth_teardown,
+};
+
+const Case kMemBwWriteCase{
+    "mem_bw_write",
+    bandwidth_setup<Kernel::kWrite>,
+    bandwidth_run_once,
+    bandwidth_teardown,
+};
+
+}  // namespace
+
+LATENCY_LAB_REGISTER_CASE(kMemBwCopyCase);
+LATENCY_LAB_REGISTER_CASE(kMemBwScaleCase);
+LATENCY_LAB_REGISTER_CASE(kMemBwAddCase);
+LATENCY_LAB_REGISTER_CASE(kMemBwTriadCase);
+LATENCY_LAB_REGISTER_CASE(kMemBwReadCase);
+LATENCY_LAB_REGISTER_CASE(kMemBwWriteCase);
@@ -0,0 +1,333 @@
+#include "artifacts.h"
+#include "case.h"
+#include "chase.h"
+#include "pages.h"
+#include "params.h"
+#include "registry.h"
+#include "timer.h"
+
+// Load-to-use latency across the memory hierarchy (lmbench-style pointer
+// chase). For each working-set size a random cyclic permutation of nodes is
+// built, so every load depends on the previous one and prefetchers cannot
+// guess the next address.
+//
+// --iters is split evenly across sizes, smallest first; raw.csv holds each
+// size's samples back to back. A sample is one chain of kStepsPerSample
+// loads, recorded as whole ns per load. Precise per-size figures go to
+// sweep.csv:
+//   size_bytes,samples,p50_ns,mean_ns,p99_ns      (ns per load, 2dp)
+// and the per-level plateaus to plateaus.csv:
+//   level,cache_bytes,first_size_bytes,last_size_bytes,ns_per_load
+// Levels come from the pinned CPU's sysfs cache sizes (cpu0 when unpinned).
+// A level's plateau is the median of sizes that fit comfortably in it,
+// meaning above the previous level and at most half its own size. DRAM
+// uses sizes of at least 4x the last-level cache; the default sweep extends
+// past 512 MiB when needed to reach that, and an explicit max_mib below it
+// leaves plateaus.csv without a DRAM row (noted on stderr).
+//
+// Params:
+//   min_kib=<n>               smallest working set (default 4)
+//   max_mib=<n>               largest working set (default 512, or 4x the
+//                             last-level cache if larger)
+//   per_octave=<n>            sizes per doubling (default 4)
+//   stride=line|page          one node per 64-byte line (default) or per
+//                             4 KiB page (adds a TLB miss to every load)
+//   hugepages=<mode>          page size (see pages.h)
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+constexpr uint64_t kStepsPerSample = 512;
+constexpr size_t kLineBytes = 64;
+constexpr size_t kPageBytes = 4096;
+// Untimed loads after building a chain, capped so huge sets stay cheap.
+constexpr uint64_t kMaxWarmupSteps = 1u << 20;
+
+struct CacheLevel {
+  int level = 0;
+  uint64_t bytes = 0;
+};
+
+struct SizeResult {
+  uint64_t size = 0;
+  std::vector<double> ns_per_load;
+};
+
+struct ChaseState {
+  PageMode mode = PageMode::kSmall;
+  char* buffer = nullptr;
+  size_t buffer_bytes = 0;
+  size_t stride = kLineBytes;
+  std::vector<SizeResult> sizes;
+  uint64_t per_size = 1;
+  uint64_t measured = 0;
+  size_t active = 0;
+  bool built = false;
+  void** cursor = nullptr;
+  std::vector<CacheLevel> caches;
+};
+
+std::unique_ptr<ChaseState> g_state;
+void* volatile g_sink = nullptr;
+
+uint64_t parse_cache_size(const std::string& text) {
+  char* end = nullptr;
+  const uint64_t value = std::strtoull(text.c_str(), &end, 10);
+  if (end != nullptr && (*end == 'K' || *end == 'k')) {
+    return value << 10;
+  }
+  if (end != nullptr && (*end == 'M' || *end == 'm')) {
+    return value << 20;
+  }
+  return value;
+}
+
+// Data/unified caches visible to `cpu`, ascending by level.
+std::vector<CacheLevel> read_cache_levels(int cpu) {
+  std::vector<CacheLevel> levels;
+  const std::string base = "/sys/devices/system/cpu/cpu" +
+                           std::to_string(cpu < 0 ? 0 : cpu) + "/cache/index";
+  for (int index = 0;; ++index) {
+    std::ifstream level_file(base + std::to_string(index) + "/level");
+    if (!level_file) {
+      break;
+    }
+    std::ifstream type_file(base + std::to_string(index) + "/type");
+    std::ifstream size_file(base + std::to_string(index) + "/size");
+    CacheLevel level;
+    std::string type;
+    std::string size;
+    level_file >> level.level;
+    type_file >> type;
+    size_file >> size;
+    if (type == "Instruction") {
+      continue;
+    }
+    level.bytes = parse_cache_size(size);
+    levels.push_back(level);
+  }
+  std::sort(levels.begin(), levels.end(),
+            [](const CacheLevel& a, const CacheLevel& b) {
+              return a.level < b.level;
+            });
+  return levels;
+}
+
+void start_size(ChaseState& state, size_t index) {
+  const uint64_t size = state.sizes[index].size;
+  const uint64_t nodes = size / state.stride;
+  state.cursor = build_chase(state.buffer, nodes, ChaseLayout{state.stride},
+                             0x5eed ^ size);
+  state.cursor = chase(state.cursor, std::min(nodes, kMaxWarmupSteps));
+  state.active = index;
+  state.built = true;
+}
+
+void chase_setup(Ctx* ctx) {
+  auto state = std::make_unique<ChaseState>();
+  if (!page_mode_param(ctx, &state->mode)) {
+    return;
+  }
+  state->caches = read_cache_levels(ctx->pin_cpu);
+  const uint64_t dram_bytes =
+      state->caches.empty() ? 0 : state->caches.back().bytes * 4;
+  const uint64_t min_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "min_kib", 4)) << 10;
+  const uint64_t max_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "max_mib", 512)) << 20;
+  const bool default_max = find_param(*ctx, "max_mib") == nullptr;
+  if (!default_max && max_bytes < dram_bytes) {
+    std::cerr << "mem_pointer_chase: note: max_mib is below 4x the last-level "
+                 "cache ("
+              << (dram_bytes >> 20) << " MiB); no DRAM plateau\n";
+  }
+  const uint64_t per_octave =
+      std::max<uint64_t>(1, param_u64(*ctx, "per_octave", 4));
+  state->stride =
+      param_choice(*ctx, "stride", {"line", "page"}, "line") == "page"
+          ? kPageBytes
+          : kLineBytes;
+
+  for (uint64_t bytes :
+       chase_sizes(min_bytes, max_bytes, per_octave, state->stride)) {
+    state->sizes.push_back(SizeResult{bytes, {}});
+  }
+  if (state->sizes.empty()) {
+    std::cerr << "mem_pointer_chase: min_kib exceeds max_mib\n";
+    std::exit(1);
+  }
+  if (default_max && state->sizes.back().size < dram_bytes) {
+    state->sizes.push_back(SizeResult{
+        (dram_bytes + state->stride - 1) / state->stride * state->stride, {}});
+  }
+
+  state->buffer_bytes = page_round_up(state->sizes.back().size, state->mode);
+  std::string error;
+  void* buffer = map_pages(state->buffer_bytes, state->mode, false, &error);
+  if (buffer == nullptr) {
+    std::cerr << "mem_pointer_chase: " << error << "\n";
+    std::exit(1);
+  }
+  state->buffer = static_cast<char*>(buffer);
+
+  state->per_size = std::max<uint64_t>(1, ctx->iters / state->sizes.size());
+  g_state = std::move(state);
+}
+
+void chase_run_once(Ctx* ctx) {
+  ChaseState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_size,
+                              state.sizes.size() - 1);
+  }
+  if (!state.built || target != state.active) {
+    start_size(state, target);
+  }
+
+  const uint64_t start = now_ns();
+  state.cursor = chase(state.cursor, kStepsPerSample);
+  const uint64_t elapsed = now_ns() - start;
+  g_sink = state.cursor;
+  if (ctx->warming_up) {
+    return;
+  }
+  const double per_load =
+      static_cast<double>(elapsed) / static_cast<double>(kStepsPerSample);
+  state.sizes[target].ns_per_load.push_back(per_load);
+  ++state.measured;
+  record_sample(ctx, static_cast<uint64_t>(std::llround(per_load)));
+}
+
+double median(std::vector<double> values) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+double quantile(const std::vector<double>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+std::string format_sweep(const ChaseState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "size_bytes,samples,p50_ns,mean_ns,p99_ns\n";
+  for (const SizeResult& result : state.sizes) {
+    if (result.ns_per_load.empty()) {
+      continue;
+    }
+    std::vector<double> sorted = result.ns_per_load;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) {
+      sum += v;
+    }
+    out << result.size << "," << sorted.size() << ","
+        << quantile(sorted, 0.50) << ","
+        << sum / static_cast<double>(sorted.size()) << ","
+        << quantile(sorted, 0.99) << "\n";
+  }
+  return out.str();
+}
+
+// One plateau row from the measured sizes in (low, high].
+void add_plateau(std::ostringstream& out,
+                 const ChaseState& state,
+                 const std::string& level,
+                 uint64_t cache_bytes,
+                 uint64_t low,
+                 uint64_t high) {
+  std::vector<double> medians;
+  uint64_t first = 0;
+  uint64_t last = 0;
+  for (const SizeResult& result : state.sizes) {
+    if (result.ns_per_load.empty() || result.size <= low ||
+        result.size > high) {
+      continue;
+    }
+    if (medians.empty()) {
+      first = result.size;
+    }
+    last = result.size;
+    medians.push_back(median(result.ns_per_load));
+  }
+  if (medians.empty()) {
+    return;
+  }
+  out << level << ",";
+  if (cache_bytes > 0) {
+    out << cache_bytes;
+  }
+  out << "," << first << "," << last << "," << median(medians) << "\n";
+}
+
+std::string format_plateaus(const ChaseState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "level,cache_bytes,first_size_bytes,last_size_bytes,ns_per_load\n";
+  uint64_t previous = 0;
+  for (const CacheLevel& cache : state.caches) {
+    add_plateau(out, state, "L" + std::to_string(cache.level), cache.bytes,
+                previous, cache.bytes / 2);
+    previous = cache.bytes;
+  }
+  if (state.caches.empty()) {
+    // No topology: report the smallest set as L1 and leave the rest to DRAM.
+    add_plateau(out, state, "L1", 0, 0, state.sizes.front().size);
+  }
+  add_plateau(out, state, "DRAM", 0,
+              state.caches.empty() ? state.sizes.back().size - 1
+                                   : state.caches.back().bytes * 4 - 1,
+              UINT64_MAX);
+  return out.str();
+}
+
+void chase_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  ChaseState& state = *g_state;
+  std::string error;
+  if (state.measured > 0) {
+    if (!write_artifact(ctx, "sweep.csv", format_sweep(state), &error) ||
+        !write_artifact(ctx, "plateaus.csv", format_plateaus(state), &error)) {
+      std::cerr << "mem_pointer_chase: failed to write artifact: " << error
+                << "\n";
+    }
+  }
+  unmap_pages(state.buffer, state.buffer_bytes, state.mode);
+  g_state.reset();
+}
+
+const Case kMemPointerChaseCase{
+    "mem_pointer_chase",
+    chase_setup,
+    chase_run_once,
+    chase_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kMemPointerChaseCase);
+#endif
@@ -0,0 +1,434 @@
+#include "artifacts.h"
+#include "case.h"
+#include "params.h"
+#include "registry.h"
+#include "timer.h"
+
+// memcpy/memmove/memset implementations across a size sweep (1 B .. 64 MiB
+// by default). --iters is split evenly across sizes, smallest first.
+//
+// Cases:
+//   memcpy_glibc, memmove_glibc, memset_glibc   libc entry points
+//   memcpy_rep_movsb, memset_rep_stosb          x86 string instructions
+//   memcpy_avx2, memcpy_avx512                  32/64-byte unaligned vector
+//                                               loops, 4x unrolled, with an
+//                                               overlapping final vector;
+//                                               skip if the CPU lacks the ISA
+//
+// A sample is the time per call in ns. In hot mode each sample repeats the
+// call until about kHotBytesPerSample bytes have moved, so tiny sizes are not
+// lost in clock-read noise. In cold mode src and dst are flushed with clflush
+// before every (single) call. Per-size results go to sweep.csv:
+//   size_bytes,samples,p50_ns,mean_ns,p99_ns,gb_per_sec
+// where gb_per_sec = size / mean (bytes copied or set, 1e9 bytes).
+//
+// Params:
+//   min_bytes=<n>     smallest size (default 1)
+//   max_mib=<n>       largest size (default 64)
+//   per_octave=<n>    sizes per doubling (default 1)
+//   src_offset=<n>    bytes past a page boundary for the source (default 0)
+//   dst_offset=<n>    same for the destination (default 0)
+//   cache=hot|cold    see above (cold: x86 only)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kHotBytesPerSample = 64 * 1024;
+constexpr uint64_t kMaxRepsPerSample = 1024;
+constexpr uint64_t kSizeWarmupCalls = 8;
+
+enum class Impl {
+  kMemcpy,
+  kMemmove,
+  kMemset,
+  kRepMovsb,
+  kRepStosb,
+  kAvx2,
+  kAvx512,
+};
+
+// Keeps the compiler from treating copies into an unread buffer as dead.
+inline void clobber_memory() {
+  asm volatile("" ::: "memory");
+}
+
+#if defined(__x86_64__)
+void rep_movsb(char* dst, const char* src, size_t n) {
+  asm volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(n) : : "memory");
+}
+
+void rep_stosb(char* dst, int value, size_t n) {
+  asm volatile("rep stosb" : "+D"(dst), "+c"(n) : "a"(value) : "memory");
+}
+
+__attribute__((target("avx2"))) void copy_avx2(char* dst,
+                                               const char* src,
+                                               size_t n) {
+  if (n < 32) {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = src[i];
+    }
+    return;
+  }
+  size_t i = 0;
+  for (; i + 128 <= n; i += 128) {
+    const __m256i v0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i v1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    const __m256i v2 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 64));
+    const __m256i v3 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 96));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), v1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 64), v2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 96), v3);
+  }
+  for (; i + 32 <= n; i += 32) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+  }
+  if (i < n) {
+    // Overlapping final vector instead of a byte tail.
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + n - 32),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + n - 32)));
+  }
+}
+
+__attribute__((target("avx512f"))) void copy_avx512(char* dst,
+                                                    const char* src,
+                                                    size_t n) {
+  if (n < 64) {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = src[i];
+    }
+    return;
+  }
+  size_t i = 0;
+  for (; i + 256 <= n; i += 256) {
+    const __m512i v0 = _mm512_loadu_si512(src + i);
+    const __m512i v1 = _mm512_loadu_si512(src + i + 64);
+    const __m512i v2 = _mm512_loadu_si512(src + i + 128);
+    const __m512i v3 = _mm512_loadu_si512(src + i + 192);
+    _mm512_storeu_si512(dst + i, v0);
+    _mm512_storeu_si512(dst + i + 64, v1);
+    _mm512_storeu_si512(dst + i + 128, v2);
+    _mm512_storeu_si512(dst + i + 192, v3);
+  }
+  for (; i + 64 <= n; i += 64) {
+    _mm512_storeu_si512(dst + i, _mm512_loadu_si512(src + i));
+  }
+  if (i < n) {
+    _mm512_storeu_si512(dst + n - 64, _mm512_loadu_si512(src + n - 64));
+  }
+}
+
+void flush_range(const char* p, size_t n) {
+  const uintptr_t start = reinterpret_cast<uintptr_t>(p) & ~uintptr_t{63};
+  const uintptr_t end = reinterpret_cast<uintptr_t>(p) + n;
+  for (uintptr_t line = start; line < end; line += 64) {
+    _mm_clflush(reinterpret_cast<const void*>(line));
+  }
+}
+#endif
+
+struct SizeResult {
+  uint64_t size = 0;
+  std::vector<double> ns_per_call;
+};
+
+struct MemcpyState {
+  Impl impl = Impl::kMemcpy;
+  bool cold = false;
+  char* src_base = nullptr;
+  char* dst_base = nullptr;
+  char* src = nullptr;
+  char* dst = nullptr;
+  std::vector<SizeResult> sizes;
+  uint64_t per_size = 1;
+  uint64_t measured = 0;
+  size_t active = 0;
+  bool started = false;
+};
+
+std::unique_ptr<MemcpyState> g_state;
+
+void call_once(const MemcpyState& state, size_t n) {
+  switch (state.impl) {
+    case Impl::kMemcpy:
+      std::memcpy(state.dst, state.src, n);
+      break;
+    case Impl::kMemmove:
+      std::memmove(state.dst, state.src, n);
+      break;
+    case Impl::kMemset:
+      std::memset(state.dst, 0x5a, n);
+      break;
+#if defined(__x86_64__)
+    case Impl::kRepMovsb:
+      rep_movsb(state.dst, state.src, n);
+      break;
+    case Impl::kRepStosb:
+      rep_stosb(state.dst, 0x5a, n);
+      break;
+    case Impl::kAvx2:
+      copy_avx2(state.dst, state.src, n);
+      break;
+    case Impl::kAvx512:
+      copy_avx512(state.dst, state.src, n);
+      break;
+#else
+    default:
+      break;
+#endif
+  }
+  clobber_memory();
+}
+
+bool impl_supported(Impl impl) {
+  switch (impl) {
+    case Impl::kMemcpy:
+    case Impl::kMemmove:
+    case Impl::kMemset:
+      return true;
+#if defined(__x86_64__)
+    case Impl::kRepMovsb:
+    case Impl::kRepStosb:
+      return true;
+    case Impl::kAvx2:
+      return __builtin_cpu_supports("avx2");
+    case Impl::kAvx512:
+      return __builtin_cpu_supports("avx512f");
+#else
+    default:
+      return false;
+#endif
+  }
+  return false;
+}
+
+void memcpy_setup(Ctx* ctx, Impl impl) {
+  auto state = std::make_unique<MemcpyState>();
+  state->impl = impl;
+  if (!impl_supported(impl)) {
+    ctx->skip_reason = "implementation not supported on this cpu";
+    return;
+  }
+  state->cold = param_choice(*ctx, "cache", {"hot", "cold"}, "hot") == "cold";
+#if !defined(__x86_64__)
+  if (state->cold) {
+    ctx->skip_reason = "cache=cold needs clflush (x86-64 only)";
+    return;
+  }
+#endif
+  const uint64_t min_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "min_bytes", 1));
+  const uint64_t max_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "max_mib", 64)) << 20;
+  const uint64_t per_octave =
+      std::max<uint64_t>(1, param_u64(*ctx, "per_octave", 1));
+  const uint64_t src_offset = param_u64(*ctx, "src_offset", 0) % 4096;
+  const uint64_t dst_offset = param_u64(*ctx, "dst_offset", 0) % 4096;
+
+  for (double size = static_cast<double>(min_bytes);
+       size <= static_cast<double>(max_bytes) * 1.0001;
+       size *= std::pow(2.0, 1.0 / static_cast<double>(per_octave))) {
+    const uint64_t bytes = static_cast<uint64_t>(std::llround(size));
+    if (state->sizes.empty() || state->sizes.back().size != bytes) {
+      state->sizes.push_back(SizeResult{bytes, {}});
+    }
+  }
+  if (state->sizes.empty()) {
+    std::cerr << "memcpy: min_bytes exceeds max_mib\n";
+    std::exit(1);
+  }
+
+  const size_t buffer_bytes = state->sizes.back().size + 8192;
+  state->src_base = static_cast<char*>(std::aligned_alloc(4096, buffer_bytes));
+  state->dst_base = static_cast<char*>(std::aligned_alloc(4096, buffer_bytes));
+  if (state->src_base == nullptr || state->dst_base == nullptr) {
+    std::cerr << "memcpy: failed to allocate buffers\n";
+    std::exit(1);
+  }
+  // Touch everything up front so page faults stay out of the samples.
+  std::memset(state->src_base, 0xa5, buffer_bytes);
+  std::memset(state->dst_base, 0, buffer_bytes);
+  state->src = state->src_base + src_offset;
+  state->dst = state->dst_base + dst_offset;
+  state->per_size = std::max<uint64_t>(1, ctx->iters / state->sizes.size());
+  g_state = std::move(state);
+}
+
+void memcpy_run_once(Ctx* ctx) {
+  MemcpyState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_size,
+                              state.sizes.size() - 1);
+  }
+  const size_t n = state.sizes[target].size;
+  if (!state.started || target != state.active) {
+    for (uint64_t i = 0; i < kSizeWarmupCalls; ++i) {
+      call_once(state, n);
+    }
+    state.active = target;
+    state.started = true;
+  }
+
+  uint64_t reps = 1;
+#if defined(__x86_64__)
+  if (state.cold) {
+    flush_range(state.src, n);
+    flush_range(state.dst, n);
+    _mm_mfence();
+  } else {
+    reps = std::clamp<uint64_t>(kHotBytesPerSample / n, 1, kMaxRepsPerSample);
+  }
+#else
+  reps = std::clamp<uint64_t>(kHotBytesPerSample / n, 1, kMaxRepsPerSample);
+#endif
+
+  const uint64_t start = now_ns();
+  for (uint64_t i = 0; i < reps; ++i) {
+    call_once(state, n);
+  }
+  const uint64_t elapsed = now_ns() - start;
+  if (ctx->warming_up) {
+    return;
+  }
+  const double per_call =
+      static_cast<double>(elapsed) / static_cast<double>(reps);
+  state.sizes[target].ns_per_call.push_back(per_call);
+  ++state.measured;
+  record_sample(ctx, static_cast<uint64_t>(std::llround(per_call)));
+}
+
+double quantile(const std::vector<double>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+std::string format_sweep(const MemcpyState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "size_bytes,samples,p50_ns,mean_ns,p99_ns,gb_per_sec\n";
+  for (const SizeResult& result : state.sizes) {
+    if (result.ns_per_call.empty()) {
+      continue;
+    }
+    std::vector<double> sorted = result.ns_per_call;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) {
+      sum += v;
+    }
+    const double mean = sum / static_cast<double>(sorted.size());
+    out << result.size << "," << sorted.size() << ","
+        << quantile(sorted, 0.50) << "," << mean << ","
+        << quantile(sorted, 0.99) << ","
+        << (mean > 0.0 ? static_cast<double>(result.size) / mean : 0.0)
+        << "\n";
+  }
+  return out.str();
+}
+
+void memcpy_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  MemcpyState& state = *g_state;
+  std::string error;
+  if (state.measured > 0 &&
+      !write_artifact(ctx, "sweep.csv", format_sweep(state), &error)) {
+    std::cerr << "memcpy: failed to write sweep.csv: " << error << "\n";
+  }
+  std::free(state.src_base);
+  std::free(state.dst_base);
+  g_state.reset();
+}
+
+template <Impl I>
+void setup_for(Ctx* ctx) {
+  memcpy_setup(ctx, I);
+}
+
+const Case kMemcpyGlibcCase{
+    "memcpy_glibc",
+    setup_for<Impl::kMemcpy>,
+    memcpy_run_once,
+    memcpy_teardown,
+};
+
+const Case kMemmoveGlibcCase{
+    "memmove_glibc",
+    setup_for<Impl::kMemmove>,
+    memcpy_run_once,
+    memcpy_teardown,
+};
+
+const Case kMemsetGlibcCase{
+    "memset_glibc",
+    setup_for<Impl::kMemset>,
+    memcpy_run_once,
+    memcpy_teardown,
+};
+
+#if defined(__x86_64__)
+const Case kMemcpyRepMovsbCase{
+    "memcpy_rep_movsb",
+    setup_for<Impl::kRepMovsb>,
+    memcpy_run_once,
+    memcpy_teardown,
+};
+
+const Case kMemsetRepStosbCase{
+    "memset_rep_stosb",
+    setup_for<Impl::kRepStosb>,
+    memcpy_run_once,
+    memcpy_teardown,
+};
+
+const Case kMemcpyAvx2Case{
+    "memcpy_avx2",
+    setup_for<Impl::kAvx2>,
+    memcpy_run_once,
+    memcpy_teardown,
+};
+
+const Case kMemcpyAvx512Case{
+    "memcpy_avx512",
+    setup_for<Impl::kAvx512>,
+    memcpy_run_once,
+    memcpy_teardown,
+};
+#endif
+
+}  // namespace
+
+LATENCY_LAB_REGISTER_CASE(kMemcpyGlibcCase);
+LATENCY_LAB_REGISTER_CASE(kMemmoveGlibcCase);
+LATENCY_LAB_REGISTER_CASE(kMemsetGlibcCase);
+#if defined(__x86_64__)
+LATENCY_LAB_REGISTER_CASE(kMemcpyRepMovsbCase);
+LATENCY_LAB_REGISTER_CASE(kMemsetRepStosbCase);
+LATENCY_LAB_REGISTER_CASE(kMemcpyAvx2Case);
+LATENCY_LAB_REGISTER_CASE(kMemcpyAvx512Case);
+#endif
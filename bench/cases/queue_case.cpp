@@ -0,0 +1,406 @@
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "spin.h"
+#include "threads.h"
+#include "timer.h"
+
+// Lock-free queue handoff: producer threads enqueue items stamped with
+// now_ns(); consumers dequeue them. The bench thread is consumer 0 and each
+// sample is one item's enqueue -> dequeue latency (stamp to dequeue), so it
+// includes time spent queued behind earlier items.
+//
+// Cases:
+//   queue_spsc  bounded ring, one producer / one consumer; cached peer index,
+//               producer publishes once per burst
+//   queue_mpsc  bounded Vyukov-style cells; CAS on enqueue only
+//   queue_mpmc  bounded Vyukov MPMC queue; CAS on both ends
+//
+// Params:
+//   producers=<n>     producer threads (default 1; queue_spsc: always 1)
+//   consumers=<n>     consumers including the bench thread (default 1;
+//                     queue_spsc and queue_mpsc: always 1)
+//   capacity=<n>      slots, rounded up to a power of two (default 1024)
+//   burst=<n>         items a producer writes per round (default 1); the SPSC
+//                     ring publishes its tail once per burst
+//   gap_ns=<ns>       producer busy-wait between bursts (default 5000, so a
+//                     consumer drains each burst before the next and samples
+//                     show unloaded handoff; 0 = flat out, which keeps the
+//                     queue full: latency ~ capacity x per-item cost)
+//   padded=true|false head/tail indices on separate cache lines (default true)
+//   cpus=<list>       thread CPUs, see thread_cpus() in placement.h; order is
+//                     bench thread, other consumers, then producers
+//
+// Metric: items_per_sec (all consumers, timed window only).
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Item {
+  uint64_t stamp_ns = 0;
+  uint64_t seq = 0;
+};
+
+// Two indices that either share a cache line or sit 128 bytes apart (two
+// lines, so the adjacent-line prefetcher does not pair them either).
+class Indices {
+ public:
+  explicit Indices(bool padded) : stride_(padded ? 16 : 1) {}
+  std::atomic<uint64_t>& first() { return words_[0]; }
+  std::atomic<uint64_t>& second() { return words_[stride_]; }
+
+ private:
+  alignas(64) std::atomic<uint64_t> words_[17] = {};
+  size_t stride_;
+};
+
+class Queue {
+ public:
+  virtual ~Queue() = default;
+  // Enqueue up to `count` items; returns how many were accepted.
+  virtual size_t try_push(const Item* items, size_t count) = 0;
+  virtual bool try_pop(Item* out) = 0;
+};
+
+class SpscRing final : public Queue {
+ public:
+  SpscRing(size_t capacity, bool padded)
+      : slots_(capacity), mask_(capacity - 1), indices_(padded) {}
+
+  size_t try_push(const Item* items, size_t count) override {
+    const uint64_t tail = tail_index().load(std::memory_order_relaxed);
+    if (tail + count - cached_head_ > slots_.size()) {
+      cached_head_ = head_index().load(std::memory_order_acquire);
+    }
+    const size_t room =
+        slots_.size() - static_cast<size_t>(tail - cached_head_);
+    const size_t n = std::min(count, room);
+    for (size_t i = 0; i < n; ++i) {
+      slots_[(tail + i) & mask_] = items[i];
+    }
+    if (n > 0) {
+      tail_index().store(tail + n, std::memory_order_release);
+    }
+    return n;
+  }
+
+  bool try_pop(Item* out) override {
+    const uint64_t head = head_index().load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_index().load(std::memory_order_acquire);
+      if (head == cached_tail_) {
+        return false;
+      }
+    }
+    *out = slots_[head & mask_];
+    head_index().store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::atomic<uint64_t>& head_index() { return indices_.first(); }
+  std::atomic<uint64_t>& tail_index() { return indices_.second(); }
+
+  std::vector<Item> slots_;
+  size_t mask_;
+  Indices indices_;
+  // Each side's stale copy of the other's index, refreshed only when the
+  // ring looks full/empty.
+  alignas(64) uint64_t cached_head_ = 0;  // producer-owned
+  alignas(64) uint64_t cached_tail_ = 0;  // consumer-owned
+};
+
+// Dmitry Vyukov's bounded MPMC queue: each cell carries a sequence number
+// that tells producers and consumers whether it is free or full for the
+// current lap. With `single_consumer` the dequeue side skips the CAS.
+class VyukovQueue final : public Queue {
+ public:
+  VyukovQueue(size_t capacity, bool padded, bool single_consumer)
+      : cells_(capacity),
+        mask_(capacity - 1),
+        indices_(padded),
+        single_consumer_(single_consumer) {
+    for (size_t i = 0; i < capacity; ++i) {
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  size_t try_push(const Item* items, size_t count) override {
+    size_t pushed = 0;
+    while (pushed < count && push_one(items[pushed])) {
+      ++pushed;
+    }
+    return pushed;
+  }
+
+  bool try_pop(Item* out) override {
+    std::atomic<uint64_t>& dequeue_pos = indices_.first();
+    uint64_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[pos & mask_];
+      const uint64_t seq = cell.seq.load(std::memory_order_acquire);
+      const int64_t diff =
+          static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+      if (diff < 0) {
+        return false;
+      }
+      if (diff == 0) {
+        if (single_consumer_) {
+          dequeue_pos.store(pos + 1, std::memory_order_relaxed);
+        } else if (!dequeue_pos.compare_exchange_weak(
+                       pos, pos + 1, std::memory_order_relaxed)) {
+          continue;
+        }
+        *out = cell.item;
+        cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+      }
+      pos = dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct alignas(32) Cell {
+    std::atomic<uint64_t> seq{0};
+    Item item;
+  };
+
+  bool push_one(const Item& item) {
+    std::atomic<uint64_t>& enqueue_pos = indices_.second();
+    uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[pos & mask_];
+      const uint64_t seq = cell.seq.load(std::memory_order_acquire);
+      const int64_t diff =
+          static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+      if (diff < 0) {
+        return false;
+      }
+      if (diff == 0 && enqueue_pos.compare_exchange_weak(
+                           pos, pos + 1, std::memory_order_relaxed)) {
+        cell.item = item;
+        cell.seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+      if (diff != 0) {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  std::vector<Cell> cells_;
+  size_t mask_;
+  Indices indices_;
+  bool single_consumer_;
+};
+
+enum class Kind {
+  kSpsc,
+  kMpsc,
+  kMpmc,
+};
+
+struct alignas(64) Progress {
+  std::atomic<uint64_t> items{0};
+};
+
+// Long enough for a burst to be dequeued before the next one is stamped.
+constexpr uint64_t kDefaultGapNs = 5000;
+
+struct QueueState {
+  std::unique_ptr<Queue> queue;
+  uint64_t burst = 1;
+  uint64_t gap_ns = kDefaultGapNs;
+  std::vector<std::thread> threads;
+  std::vector<Progress> consumed;  // per worker consumer
+  std::atomic<bool> stop{false};
+  uint64_t bench_items = 0;
+  bool window_open = false;
+  uint64_t window_start_ns = 0;
+  uint64_t window_start_items = 0;
+};
+
+std::unique_ptr<QueueState> g_state;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "queue: " << message << "\n";
+  std::exit(1);
+}
+
+void producer_loop(QueueState* state) {
+  std::vector<Item> items(state->burst);
+  uint64_t seq = 0;
+  while (!state->stop.load(std::memory_order_relaxed)) {
+    spin_for_ns(state->gap_ns);
+    for (Item& item : items) {
+      item.stamp_ns = now_ns();
+      item.seq = seq++;
+    }
+    size_t pushed = 0;
+    while (pushed < items.size()) {
+      pushed += state->queue->try_push(items.data() + pushed,
+                                       items.size() - pushed);
+      if (pushed < items.size()) {
+        if (state->stop.load(std::memory_order_relaxed)) {
+          return;
+        }
+        cpu_relax();
+      }
+    }
+  }
+}
+
+void consumer_loop(QueueState* state, Progress* progress) {
+  Item item;
+  uint64_t consumed = 0;
+  while (!state->stop.load(std::memory_order_relaxed)) {
+    if (state->queue->try_pop(&item)) {
+      progress->items.store(++consumed, std::memory_order_relaxed);
+    } else {
+      cpu_relax();
+    }
+  }
+}
+
+uint64_t total_consumed(const QueueState& state) {
+  uint64_t total = state.bench_items;
+  for (const Progress& progress : state.consumed) {
+    total += progress.items.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t round_up_pow2(uint64_t value) {
+  uint64_t out = 1;
+  while (out < value) {
+    out <<= 1;
+  }
+  return out;
+}
+
+template <Kind K>
+void queue_setup(Ctx* ctx) {
+  auto state = std::make_unique<QueueState>();
+  uint64_t producers = std::max<uint64_t>(1, param_u64(*ctx, "producers", 1));
+  uint64_t consumers = std::max<uint64_t>(1, param_u64(*ctx, "consumers", 1));
+  if (K == Kind::kSpsc) {
+    producers = 1;
+  }
+  if (K != Kind::kMpmc) {
+    consumers = 1;
+  }
+  const uint64_t capacity =
+      round_up_pow2(std::max<uint64_t>(2, param_u64(*ctx, "capacity", 1024)));
+  state->burst = std::max<uint64_t>(1, param_u64(*ctx, "burst", 1));
+  state->gap_ns = param_u64(*ctx, "gap_ns", kDefaultGapNs);
+  const bool padded = param_bool(*ctx, "padded", true);
+
+  if (K == Kind::kSpsc) {
+    state->queue = std::make_unique<SpscRing>(capacity, padded);
+  } else {
+    state->queue = std::make_unique<VyukovQueue>(capacity, padded,
+                                                 K == Kind::kMpsc);
+  }
+  state->consumed = std::vector<Progress>(consumers - 1);
+
+  const std::vector<int> cpus = thread_cpus(*ctx, consumers + producers);
+  std::string error;
+  if (cpus[0] >= 0 && !pin_to_cpu(cpus[0], &error)) {
+    fail("failed to pin to cpu " + std::to_string(cpus[0]) + ": " + error);
+  }
+  QueueState* raw = state.get();
+  state->threads.resize(cpus.size() - 1);
+  for (size_t i = 1; i < cpus.size(); ++i) {
+    std::function<void()> fn;
+    if (i < consumers) {
+      Progress* progress = &state->consumed[i - 1];
+      fn = [raw, progress]() { consumer_loop(raw, progress); };
+    } else {
+      fn = [raw]() { producer_loop(raw); };
+    }
+    if (!start_pinned_thread(cpus[i], fn, &state->threads[i - 1], &error)) {
+      fail("failed to start worker: " + error);
+    }
+  }
+  g_state = std::move(state);
+}
+
+void queue_run_once(Ctx* ctx) {
+  QueueState& state = *g_state;
+  if (!ctx->warming_up && !state.window_open) {
+    state.window_open = true;
+    state.window_start_ns = now_ns();
+    state.window_start_items = total_consumed(state);
+  }
+  Item item;
+  while (!state.queue->try_pop(&item)) {
+    cpu_relax();
+  }
+  const uint64_t now = now_ns();
+  ++state.bench_items;
+  // Stamps come from another core's clock read; clamp tiny negative skew.
+  record_sample(ctx, now > item.stamp_ns ? now - item.stamp_ns : 0);
+}
+
+void queue_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  QueueState& state = *g_state;
+  const uint64_t end_ns = now_ns();
+  const uint64_t end_items = total_consumed(state);
+  state.stop.store(true, std::memory_order_relaxed);
+  for (std::thread& thread : state.threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  if (state.window_open && end_ns > state.window_start_ns) {
+    const double seconds =
+        static_cast<double>(end_ns - state.window_start_ns) / 1e9;
+    record_metric(ctx, "items_per_sec",
+                  static_cast<double>(end_items - state.window_start_items) /
+                      seconds);
+  }
+  restore_affinity(*ctx);
+  g_state.reset();
+}
+
+const Case kQueueSpscCase{
+    "queue_spsc",
+    queue_setup<Kind::kSpsc>,
+    queue_run_once,
+    queue_teardown,
+};
+
+const Case kQueueMpscCase{
+    "queue_mpsc",
+    queue_setup<Kind::kMpsc>,
+    queue_run_once,
+    queue_teardown,
+};
+
+const Case kQueueMpmcCase{
+    "queue_mpmc",
+    queue_setup<Kind::kMpmc>,
+    queue_run_once,
+    queue_teardown,
+};
+
+}  // namespace
+
+LATENCY_LAB_REGISTER_CASE(kQueueSpscCase);
+LATENCY_LAB_REGISTER_CASE(kQueueMpscCase);
+LATENCY_LAB_REGISTER_CASE(kQueueMpmcCase);
@@ -0,0 +1,376 @@
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "threads.h"
+#include "timer.h"
+
+// Signal delivery latency: time from just before the sending syscall to the
+// receiver observing the signal. Both stamps go through a MAP_SHARED page so
+// the receiver may be this thread, another thread, or a forked process.
+//
+// Cases (by how the receiver observes the signal):
+//   signal_handler     entry into an SA_SIGINFO handler
+//   signal_sigwaitinfo return from sigwaitinfo() with the signal blocked
+//   signal_signalfd    return from read() on a signalfd
+//
+// Params:
+//   send=tgkill|kill|sigqueue   sending syscall (default tgkill). kill and
+//                               sigqueue are process-directed; the bench
+//                               thread blocks the signal so another thread
+//                               of this process receives it.
+//   target=thread|process|same  receiver (default thread); `same` sends to
+//                               the bench thread itself
+//   placement/peer_cpu          see placement.h (thread/process targets)
+//
+// SIGRTMIN is used so repeated sends queue instead of coalescing.
+
+#if defined(__linux__)
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <linux/futex.h>
+#include <memory>
+#include <new>
+#include <pthread.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "signal: " << message << ": " << std::strerror(errno) << "\n";
+  std::exit(1);
+}
+
+// Shared between sender and receiver, possibly across fork().
+struct alignas(64) SignalPage {
+  std::atomic<uint64_t> send_ns{0};
+  std::atomic<uint64_t> recv_ns{0};
+  std::atomic<uint32_t> ack{0};
+  std::atomic<uint32_t> stop{0};
+  std::atomic<int> receiver_tid{0};
+};
+
+enum class Receive {
+  kHandler,
+  kSigwaitinfo,
+  kSignalfd,
+};
+
+enum class Send {
+  kTgkill,
+  kKill,
+  kSigqueue,
+};
+
+enum class Target {
+  kThread,
+  kProcess,
+  kSame,
+};
+
+SignalPage* g_page = nullptr;
+
+void futex_wake_shared(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, 1,
+          nullptr, nullptr, 0);
+}
+
+void futex_wait_shared(std::atomic<uint32_t>* word, uint32_t seen) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, seen,
+          nullptr, nullptr, 0);
+}
+
+// Stamp first; everything else is bookkeeping outside the measured path.
+void mark_received() {
+  g_page->recv_ns.store(now_ns(), std::memory_order_relaxed);
+  g_page->ack.fetch_add(1, std::memory_order_release);
+  futex_wake_shared(&g_page->ack);
+}
+
+void on_signal(int, siginfo_t*, void*) {
+  mark_received();
+}
+
+struct SignalState {
+  Receive receive = Receive::kHandler;
+  Send send = Send::kTgkill;
+  Target target = Target::kThread;
+  Placement placement;
+  int signo = 0;
+  sigset_t set{};
+  sigset_t saved_mask{};
+  struct sigaction saved_action {};
+  bool action_installed = false;
+  int signal_fd = -1;
+  pid_t target_pid = 0;
+  pid_t child = -1;
+  std::thread receiver;
+};
+
+std::unique_ptr<SignalState> g_state;
+
+void send_signal(const SignalState& state) {
+  int rc = 0;
+  switch (state.send) {
+    case Send::kTgkill:
+      rc = static_cast<int>(syscall(SYS_tgkill, state.target_pid,
+                                    g_page->receiver_tid.load(), state.signo));
+      break;
+    case Send::kKill:
+      rc = kill(state.target_pid, state.signo);
+      break;
+    case Send::kSigqueue: {
+      sigval value{};
+      rc = sigqueue(state.target_pid, state.signo, value);
+      break;
+    }
+  }
+  if (rc != 0) {
+    fail("send signal");
+  }
+}
+
+// Blocking receive for the sigwaitinfo/signalfd paths.
+void receive_blocked(const SignalState& state) {
+  if (state.receive == Receive::kSigwaitinfo) {
+    siginfo_t info;
+    while (sigwaitinfo(&state.set, &info) < 0) {
+      if (errno != EINTR) {
+        fail("sigwaitinfo");
+      }
+    }
+  } else {
+    signalfd_siginfo info;
+    while (read(state.signal_fd, &info, sizeof(info)) != sizeof(info)) {
+      if (errno != EINTR) {
+        fail("read signalfd");
+      }
+    }
+  }
+  mark_received();
+}
+
+// Runs on the receiving thread or in the child process. The signal is
+// blocked on entry (inherited from the bench thread).
+void receiver_loop(SignalState* state) {
+  g_page->receiver_tid.store(static_cast<int>(syscall(SYS_gettid)),
+                             std::memory_order_release);
+  if (state->receive == Receive::kHandler) {
+    sigset_t wait_mask;
+    pthread_sigmask(SIG_BLOCK, nullptr, &wait_mask);
+    sigdelset(&wait_mask, state->signo);
+    // sigsuspend unblocks and sleeps atomically, so the final stop signal
+    // cannot slip in between the stop check and the wait.
+    while (g_page->stop.load(std::memory_order_acquire) == 0) {
+      sigsuspend(&wait_mask);
+    }
+    return;
+  }
+  while (true) {
+    receive_blocked(*state);
+    if (g_page->stop.load(std::memory_order_acquire) != 0) {
+      return;
+    }
+  }
+}
+
+void signal_setup(Ctx* ctx, Receive receive) {
+  auto state = std::make_unique<SignalState>();
+  state->receive = receive;
+  const std::string send =
+      param_choice(*ctx, "send", {"tgkill", "kill", "sigqueue"}, "tgkill");
+  state->send = send == "kill"       ? Send::kKill
+                : send == "sigqueue" ? Send::kSigqueue
+                                     : Send::kTgkill;
+  const std::string target =
+      param_choice(*ctx, "target", {"thread", "process", "same"}, "thread");
+  state->target = target == "process" ? Target::kProcess
+                  : target == "same"  ? Target::kSame
+                                      : Target::kThread;
+  state->signo = SIGRTMIN;
+
+  if (state->target != Target::kSame &&
+      !setup_placement(ctx, &state->placement)) {
+    return;
+  }
+
+  void* page = mmap(nullptr, sizeof(SignalPage), PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (page == MAP_FAILED) {
+    fail("mmap timestamp page");
+  }
+  g_page = new (page) SignalPage();
+
+  if (receive == Receive::kHandler) {
+    struct sigaction action {};
+    action.sa_sigaction = on_signal;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(state->signo, &action, &state->saved_action) != 0) {
+      fail("sigaction");
+    }
+    state->action_installed = true;
+  }
+
+  // Block before creating the receiver so it inherits the mask and no early
+  // signal can take the default (terminating) action.
+  sigemptyset(&state->set);
+  sigaddset(&state->set, state->signo);
+  pthread_sigmask(SIG_BLOCK, &state->set, &state->saved_mask);
+  if (receive == Receive::kSignalfd) {
+    state->signal_fd = signalfd(-1, &state->set, SFD_CLOEXEC);
+    if (state->signal_fd < 0) {
+      fail("signalfd");
+    }
+  }
+
+  SignalState* raw = state.get();
+  switch (state->target) {
+    case Target::kSame:
+      state->target_pid = getpid();
+      g_page->receiver_tid.store(static_cast<int>(syscall(SYS_gettid)));
+      if (receive == Receive::kHandler) {
+        pthread_sigmask(SIG_UNBLOCK, &state->set, nullptr);
+      }
+      break;
+    case Target::kThread: {
+      state->target_pid = getpid();
+      std::string error;
+      if (!start_pinned_thread(state->placement.peer_cpu,
+                               [raw]() { receiver_loop(raw); },
+                               &state->receiver, &error)) {
+        std::cerr << "signal: failed to start receiver: " << error << "\n";
+        std::exit(1);
+      }
+      break;
+    }
+    case Target::kProcess: {
+      const pid_t pid = fork();
+      if (pid < 0) {
+        fail("fork");
+      }
+      if (pid == 0) {
+        std::string error;
+        if (state->placement.peer_cpu >= 0 &&
+            !pin_to_cpu(state->placement.peer_cpu, &error)) {
+          std::cerr << "signal peer: failed to pin: " << error << "\n";
+          _exit(2);
+        }
+        receiver_loop(raw);
+        _exit(0);
+      }
+      state->child = pid;
+      state->target_pid = pid;
+      break;
+    }
+  }
+  if (state->target != Target::kSame) {
+    while (g_page->receiver_tid.load(std::memory_order_acquire) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  g_state = std::move(state);
+}
+
+void signal_run_once(Ctx* ctx) {
+  SignalState& state = *g_state;
+  const uint32_t before = g_page->ack.load(std::memory_order_acquire);
+  g_page->send_ns.store(now_ns(), std::memory_order_relaxed);
+  send_signal(state);
+  if (state.target == Target::kSame && state.receive != Receive::kHandler) {
+    receive_blocked(state);
+  }
+  uint32_t seen = g_page->ack.load(std::memory_order_acquire);
+  while (seen == before) {
+    futex_wait_shared(&g_page->ack, seen);
+    seen = g_page->ack.load(std::memory_order_acquire);
+  }
+  const uint64_t sent = g_page->send_ns.load(std::memory_order_relaxed);
+  const uint64_t received = g_page->recv_ns.load(std::memory_order_relaxed);
+  record_sample(ctx, received > sent ? received - sent : 0);
+}
+
+void signal_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  SignalState& state = *g_state;
+  if (state.target != Target::kSame) {
+    g_page->stop.store(1, std::memory_order_release);
+    send_signal(state);
+    if (state.receiver.joinable()) {
+      state.receiver.join();
+    }
+    if (state.child > 0) {
+      int status = 0;
+      while (waitpid(state.child, &status, 0) < 0 && errno == EINTR) {
+      }
+    }
+  }
+  if (state.signal_fd >= 0) {
+    close(state.signal_fd);
+  }
+  // Drain anything still queued for this thread before unblocking, so the
+  // restored default action cannot fire.
+  timespec zero{};
+  while (sigtimedwait(&state.set, nullptr, &zero) > 0) {
+  }
+  if (state.action_installed) {
+    sigaction(state.signo, &state.saved_action, nullptr);
+  }
+  pthread_sigmask(SIG_SETMASK, &state.saved_mask, nullptr);
+  munmap(g_page, sizeof(SignalPage));
+  g_page = nullptr;
+  restore_placement(*ctx, state.placement);
+  g_state.reset();
+}
+
+template <Receive R>
+void setup_for(Ctx* ctx) {
+  signal_setup(ctx, R);
+}
+
+const Case kSignalHandlerCase{
+    "signal_handler",
+    setup_for<Receive::kHandler>,
+    signal_run_once,
+    signal_teardown,
+};
+
+const Case kSignalSigwaitinfoCase{
+    "signal_sigwaitinfo",
+    setup_for<Receive::kSigwaitinfo>,
+    signal_run_once,
+    signal_teardown,
+};
+
+const Case kSignalSignalfdCase{
+    "signal_signalfd",
+    setup_for<Receive::kSignalfd>,
+    signal_run_once,
+    signal_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kSignalHandlerCase);
+LATENCY_LAB_REGISTER_CASE(kSignalSigwaitinfoCase);
+LATENCY_LAB_REGISTER_CASE(kSignalSignalfdCase);
+#endif
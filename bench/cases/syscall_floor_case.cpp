@@ -0,0 +1,183 @@
+#include "case.h"
+#include "registry.h"
+
+// Syscall floor: the cheapest kernel entries (and their vDSO shortcuts) on this
+// host. Every other case can be read relative to these numbers; compare runs
+// against `cpu_mitigations` in meta.json to see what the entry path costs.
+
+#if defined(__linux__)
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+// A single call is only tens of ns, close to the cost of the two clock reads
+// around it, so every case in this family is batched.
+constexpr uint32_t kSyscallBatch = 64;
+
+int g_dev_zero_fd = -1;
+int g_dev_null_fd = -1;
+char g_io_byte = 0;
+
+// Results are stored so the compiler cannot drop the calls.
+volatile long g_sink = 0;
+
+void getpid_raw_run_once(Ctx*) {
+  g_sink = syscall(SYS_getpid);
+}
+
+void clock_gettime_vdso_run_once(Ctx*) {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  g_sink = ts.tv_nsec;
+}
+
+void clock_gettime_raw_run_once(Ctx*) {
+  // Bypass the vDSO to pay for a real kernel entry.
+  timespec ts;
+  syscall(SYS_clock_gettime, CLOCK_MONOTONIC, &ts);
+  g_sink = ts.tv_nsec;
+}
+
+void getcpu_vdso_run_once(Ctx*) {
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  getcpu(&cpu, &node);
+  g_sink = cpu;
+}
+
+void getcpu_raw_run_once(Ctx*) {
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  syscall(SYS_getcpu, &cpu, &node, nullptr);
+  g_sink = cpu;
+}
+
+void sched_yield_run_once(Ctx*) {
+  g_sink = sched_yield();
+}
+
+void open_or_exit(const char* path, int flags, int* fd) {
+  *fd = open(path, flags | O_CLOEXEC);
+  if (*fd < 0) {
+    std::cerr << "failed to open " << path << "\n";
+    std::exit(1);
+  }
+}
+
+void close_fd(int* fd) {
+  if (*fd >= 0) {
+    close(*fd);
+    *fd = -1;
+  }
+}
+
+void read_devzero_setup(Ctx*) {
+  open_or_exit("/dev/zero", O_RDONLY, &g_dev_zero_fd);
+}
+
+void read_devzero_run_once(Ctx*) {
+  // Zero-length read: fd lookup and syscall entry/exit, no data copy.
+  g_sink = read(g_dev_zero_fd, &g_io_byte, 0);
+}
+
+void read_devzero_teardown(Ctx*) {
+  close_fd(&g_dev_zero_fd);
+}
+
+void write_devnull_setup(Ctx*) {
+  open_or_exit("/dev/null", O_WRONLY, &g_dev_null_fd);
+}
+
+void write_devnull_run_once(Ctx*) {
+  g_sink = write(g_dev_null_fd, &g_io_byte, 1);
+}
+
+void write_devnull_teardown(Ctx*) {
+  close_fd(&g_dev_null_fd);
+}
+
+const Case kGetpidRawCase{
+    "syscall_getpid_raw",
+    nullptr,
+    getpid_raw_run_once,
+    nullptr,
+    kSyscallBatch,
+};
+
+const Case kClockGettimeVdsoCase{
+    "syscall_clock_gettime_vdso",
+    nullptr,
+    clock_gettime_vdso_run_once,
+    nullptr,
+    kSyscallBatch,
+};
+
+const Case kClockGettimeRawCase{
+    "syscall_clock_gettime_raw",
+    nullptr,
+    clock_gettime_raw_run_once,
+    nullptr,
+    kSyscallBatch,
+};
+
+const Case kGetcpuVdsoCase{
+    "syscall_getcpu_vdso",
+    nullptr,
+    getcpu_vdso_run_once,
+    nullptr,
+    kSyscallBatch,
+};
+
+const Case kGetcpuRawCase{
+    "syscall_getcpu_raw",
+    nullptr,
+    getcpu_raw_run_once,
+    nullptr,
+    kSyscallBatch,
+};
+
+const Case kSchedYieldCase{
+    "syscall_sched_yield",
+    nullptr,
+    sched_yield_run_once,
+    nullptr,
+    kSyscallBatch,
+};
+
+const Case kReadDevzeroCase{
+    "syscall_read_devzero_0",
+    read_devzero_setup,
+    read_devzero_run_once,
+    read_devzero_teardown,
+    kSyscallBatch,
+};
+
+const Case kWriteDevnullCase{
+    "syscall_write_devnull",
+    write_devnull_setup,
+    write_devnull_run_once,
+    write_devnull_teardown,
+    kSyscallBatch,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kGetpidRawCase);
+LATENCY_LAB_REGISTER_CASE(kClockGettimeVdsoCase);
+LATENCY_LAB_REGISTER_CASE(kClockGettimeRawCase);
+LATENCY_LAB_REGISTER_CASE(kGetcpuVdsoCase);
+LATENCY_LAB_REGISTER_CASE(kGetcpuRawCase);
+LATENCY_LAB_REGISTER_CASE(kSchedYieldCase);
+LATENCY_LAB_REGISTER_CASE(kReadDevzeroCase);
+LATENCY_LAB_REGISTER_CASE(kWriteDevnullCase);
+#endif
@@ -0,0 +1,311 @@
+#include "case.h"
+#include "params.h"
+#include "registry.h"
+
+// Timer wakeup accuracy (cyclictest-style): each sample is the lateness of
+// one wakeup, i.e. time observed after waking minus the time requested.
+// Deadlines and wakeups are read from CLOCK_MONOTONIC, the clock the timers
+// run on.
+//
+// Cases:
+//   timer_nanosleep            relative nanosleep(interval)
+//   timer_clock_nanosleep_abs  periodic clock_nanosleep(TIMER_ABSTIME); if a
+//                              wakeup is more than one interval late the
+//                              schedule restarts from now, like cyclictest
+//   timer_timerfd_epoll        periodic timerfd, waited on with epoll_wait
+//   timer_poll                 poll() with no fds; the timeout has
+//                              millisecond granularity, so the interval is
+//                              rounded up to whole ms
+//
+// Params:
+//   interval_us=<us>        requested period/sleep (default 1000)
+//   slack_ns=<ns>           PR_SET_TIMERSLACK for the bench thread (default:
+//                           leave as is; normal threads default to 50us).
+//                           Must be >= 1: the kernel treats 0 as "reset to
+//                           the default slack", so it is rejected
+//   policy=other|fifo|rr    scheduling policy for the bench thread
+//   priority=<n>            RT priority for fifo/rr (default 50)
+//
+// The effective timer slack is reported as the timer_slack_ns metric. An RT
+// policy the process may not use makes the run skip rather than fail.
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "timer: " << message << ": " << std::strerror(errno) << "\n";
+  std::exit(1);
+}
+
+uint64_t mono_ns() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+timespec to_timespec(uint64_t ns) {
+  timespec ts;
+  ts.tv_sec = static_cast<time_t>(ns / 1000000000ull);
+  ts.tv_nsec = static_cast<long>(ns % 1000000000ull);
+  return ts;
+}
+
+enum class Mechanism {
+  kNanosleep,
+  kClockNanosleepAbs,
+  kTimerfdEpoll,
+  kPoll,
+};
+
+struct TimerState {
+  Mechanism mechanism = Mechanism::kNanosleep;
+  uint64_t interval_ns = 0;
+  uint64_t next_deadline_ns = 0;
+  int timer_fd = -1;
+  int epoll_fd = -1;
+  bool restore_slack = false;
+  unsigned long saved_slack = 0;
+  bool restore_policy = false;
+  int saved_policy = SCHED_OTHER;
+  sched_param saved_param{};
+};
+
+TimerState g_state;
+
+void reset_state() {
+  if (g_state.epoll_fd >= 0) {
+    close(g_state.epoll_fd);
+  }
+  if (g_state.timer_fd >= 0) {
+    close(g_state.timer_fd);
+  }
+  g_state = TimerState{};
+}
+
+// Returns false with ctx->skip_reason set when the policy is not permitted.
+bool apply_policy(Ctx* ctx) {
+  const std::string policy =
+      param_choice(*ctx, "policy", {"other", "fifo", "rr"}, "other");
+  if (policy == "other") {
+    return true;
+  }
+  const int wanted = policy == "fifo" ? SCHED_FIFO : SCHED_RR;
+  sched_param param{};
+  param.sched_priority = static_cast<int>(param_u64(*ctx, "priority", 50));
+  pthread_getschedparam(pthread_self(), &g_state.saved_policy,
+                        &g_state.saved_param);
+  const int rc = pthread_setschedparam(pthread_self(), wanted, &param);
+  if (rc != 0) {
+    ctx->skip_reason = "policy=" + policy + " not permitted (" +
+                       std::strerror(rc) +
+                       "); needs CAP_SYS_NICE or an RLIMIT_RTPRIO grant";
+    return false;
+  }
+  g_state.restore_policy = true;
+  return true;
+}
+
+void timer_setup(Ctx* ctx, Mechanism mechanism) {
+  reset_state();
+  g_state.mechanism = mechanism;
+  g_state.interval_ns = param_u64(*ctx, "interval_us", 1000) * 1000;
+  if (g_state.interval_ns == 0) {
+    std::cerr << "timer: interval_us must be > 0\n";
+    std::exit(1);
+  }
+  if (mechanism == Mechanism::kPoll) {
+    g_state.interval_ns = (g_state.interval_ns + 999999) / 1000000 * 1000000;
+  }
+
+  if (find_param(*ctx, "slack_ns") != nullptr) {
+    const uint64_t slack_ns = param_u64(*ctx, "slack_ns", 0);
+    if (slack_ns == 0) {
+      std::cerr << "timer: slack_ns must be >= 1 (0 resets to the default)\n";
+      std::exit(1);
+    }
+    g_state.saved_slack =
+        static_cast<unsigned long>(prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0));
+    if (prctl(PR_SET_TIMERSLACK, slack_ns, 0, 0, 0) != 0) {
+      fail("PR_SET_TIMERSLACK");
+    }
+    g_state.restore_slack = true;
+  }
+  if (!apply_policy(ctx)) {
+    return;
+  }
+
+  if (mechanism == Mechanism::kTimerfdEpoll) {
+    g_state.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    g_state.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (g_state.timer_fd < 0 || g_state.epoll_fd < 0) {
+      fail("timerfd/epoll setup");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = g_state.timer_fd;
+    if (epoll_ctl(g_state.epoll_fd, EPOLL_CTL_ADD, g_state.timer_fd,
+                  &event) != 0) {
+      fail("epoll_ctl");
+    }
+  }
+  // Periodic schedules start one interval from the end of setup.
+  g_state.next_deadline_ns = mono_ns() + g_state.interval_ns;
+  if (mechanism == Mechanism::kTimerfdEpoll) {
+    itimerspec spec{};
+    spec.it_value = to_timespec(g_state.next_deadline_ns);
+    spec.it_interval = to_timespec(g_state.interval_ns);
+    if (timerfd_settime(g_state.timer_fd, TFD_TIMER_ABSTIME, &spec,
+                        nullptr) != 0) {
+      fail("timerfd_settime");
+    }
+  }
+}
+
+// Lateness of a wakeup; an early return (should not happen once EINTR is
+// retried) records 0 rather than wrapping around.
+uint64_t lateness(uint64_t woke, uint64_t deadline) {
+  return woke >= deadline ? woke - deadline : 0;
+}
+
+uint64_t wait_once() {
+  switch (g_state.mechanism) {
+    case Mechanism::kNanosleep: {
+      const uint64_t deadline = mono_ns() + g_state.interval_ns;
+      timespec ts = to_timespec(g_state.interval_ns);
+      timespec rem{};
+      while (nanosleep(&ts, &rem) != 0 && errno == EINTR) {
+        ts = rem;
+      }
+      return lateness(mono_ns(), deadline);
+    }
+    case Mechanism::kPoll: {
+      const uint64_t deadline = mono_ns() + g_state.interval_ns;
+      uint64_t remaining = g_state.interval_ns;
+      // Round up: a truncated timeout would return before the deadline.
+      while (poll(nullptr, 0, static_cast<int>((remaining + 999999) / 1000000)) <
+                 0 &&
+             errno == EINTR) {
+        const uint64_t now = mono_ns();
+        if (now >= deadline) {
+          break;
+        }
+        remaining = deadline - now;
+      }
+      return lateness(mono_ns(), deadline);
+    }
+    case Mechanism::kClockNanosleepAbs: {
+      const uint64_t deadline = g_state.next_deadline_ns;
+      const timespec ts = to_timespec(deadline);
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) ==
+             EINTR) {
+      }
+      const uint64_t woke = mono_ns();
+      g_state.next_deadline_ns += g_state.interval_ns;
+      if (woke > g_state.next_deadline_ns) {
+        g_state.next_deadline_ns = woke + g_state.interval_ns;
+      }
+      return lateness(woke, deadline);
+    }
+    case Mechanism::kTimerfdEpoll: {
+      epoll_event event{};
+      while (epoll_wait(g_state.epoll_fd, &event, 1, -1) < 0 &&
+             errno == EINTR) {
+      }
+      const uint64_t woke = mono_ns();
+      uint64_t expirations = 0;
+      if (read(g_state.timer_fd, &expirations, sizeof(expirations)) !=
+          sizeof(expirations)) {
+        fail("read timerfd");
+      }
+      // Lateness relative to the most recent expiry; missed periods show up
+      // as expirations > 1 and are not double-counted.
+      const uint64_t deadline =
+          g_state.next_deadline_ns + (expirations - 1) * g_state.interval_ns;
+      g_state.next_deadline_ns = deadline + g_state.interval_ns;
+      return lateness(woke, deadline);
+    }
+  }
+  return 0;
+}
+
+void timer_run_once(Ctx* ctx) {
+  record_sample(ctx, wait_once());
+}
+
+void timer_teardown(Ctx* ctx) {
+  const unsigned long slack =
+      static_cast<unsigned long>(prctl(PR_GET_TIMERSLACK, 0, 0, 0, 0));
+  if (ctx->skip_reason.empty()) {
+    record_metric(ctx, "timer_slack_ns", static_cast<double>(slack));
+  }
+  if (g_state.restore_slack) {
+    prctl(PR_SET_TIMERSLACK, g_state.saved_slack, 0, 0, 0);
+  }
+  if (g_state.restore_policy) {
+    pthread_setschedparam(pthread_self(), g_state.saved_policy,
+                          &g_state.saved_param);
+  }
+  reset_state();
+}
+
+template <Mechanism M>
+void setup_for(Ctx* ctx) {
+  timer_setup(ctx, M);
+}
+
+const Case kTimerNanosleepCase{
+    "timer_nanosleep",
+    setup_for<Mechanism::kNanosleep>,
+    timer_run_once,
+    timer_teardown,
+};
+
+const Case kTimerClockNanosleepAbsCase{
+    "timer_clock_nanosleep_abs",
+    setup_for<Mechanism::kClockNanosleepAbs>,
+    timer_run_once,
+    timer_teardown,
+};
+
+const Case kTimerTimerfdEpollCase{
+    "timer_timerfd_epoll",
+    setup_for<Mechanism::kTimerfdEpoll>,
+    timer_run_once,
+    timer_teardown,
+};
+
+const Case kTimerPollCase{
+    "timer_poll",
+    setup_for<Mechanism::kPoll>,
+    timer_run_once,
+    timer_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kTimerNanosleepCase);
+LATENCY_LAB_REGISTER_CASE(kTimerClockNanosleepAbsCase);
+LATENCY_LAB_REGISTER_CASE(kTimerTimerfdEpollCase);
+LATENCY_LAB_REGISTER_CASE(kTimerPollCase);
+#endif
@@ -0,0 +1,256 @@
+#include "artifacts.h"
+#include "case.h"
+#include "chase.h"
+#include "pages.h"
+#include "params.h"
+#include "perf_counter.h"
+#include "registry.h"
+#include "timer.h"
+
+// TLB reach: dependent random loads over a working set backed by 4 KiB,
+// THP or hugetlb pages. The working set holds one node per 4 KiB block
+// (on a different cache line in each block, so the nodes spread over cache
+// sets) linked in a random single cycle (chase.h). With 4 KiB
+// pages every load lands on its own page; with huge pages the same loads
+// share a page per 512 (2 MiB) or 262144 (1 GiB) nodes, so comparing runs at
+// the same size_bytes isolates the translation cost.
+//
+// --iters is split evenly across sizes, smallest first. A sample is one
+// chain of kStepsPerSample loads, recorded as whole ns per load. The whole
+// buffer is faulted in during setup, so no page faults land in a sample.
+// sweep.csv has the per-size view:
+//   size_bytes,pages,samples,p50_ns,mean_ns,p99_ns,dtlb_misses_per_load
+// where the last column is the user-space dTLB load-miss count per load
+// (empty when the counter cannot be opened; the reason goes to stderr).
+// The counter is read outside the timed window.
+//
+// Params:
+//   hugepages=<mode>          page size (see pages.h)
+//   min_kib=<n>               smallest working set (default 64)
+//   max_mib=<n>               largest working set (default 8192, capped at
+//                             half of physical memory): past the 2 MiB-page
+//                             reach of common STLBs (1536-3072 entries,
+//                             3-6 GiB), so huge-page runs show their knee.
+//                             hugetlb modes are also capped at the free
+//                             pool, and skip if it is below min_kib
+//   per_octave=<n>            sizes per doubling (default 2)
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+constexpr uint64_t kStepsPerSample = 512;
+constexpr size_t kBlockBytes = 4096;
+constexpr uint64_t kDefaultMaxMib = 8192;
+// Untimed loads after building a chain, capped so huge sets stay cheap.
+constexpr uint64_t kMaxWarmupSteps = 1u << 20;
+
+struct SizeResult {
+  uint64_t size = 0;
+  std::vector<double> ns_per_load;
+  uint64_t loads = 0;
+  uint64_t misses = 0;
+};
+
+struct TlbState {
+  PageMode mode = PageMode::kSmall;
+  char* buffer = nullptr;
+  size_t buffer_bytes = 0;
+  std::vector<SizeResult> sizes;
+  uint64_t per_size = 1;
+  uint64_t measured = 0;
+  size_t active = 0;
+  bool built = false;
+  void** cursor = nullptr;
+  PerfCounter dtlb_misses;
+};
+
+std::unique_ptr<TlbState> g_state;
+void* volatile g_sink = nullptr;
+
+void start_size(TlbState& state, size_t index) {
+  const uint64_t size = state.sizes[index].size;
+  const uint64_t nodes = size / kBlockBytes;
+  state.cursor = build_chase(state.buffer, nodes,
+                             ChaseLayout{kBlockBytes, true}, 0x71b ^ size);
+  state.cursor = chase(state.cursor, std::min(nodes, kMaxWarmupSteps));
+  state.active = index;
+  state.built = true;
+}
+
+void tlb_setup(Ctx* ctx) {
+  auto state = std::make_unique<TlbState>();
+  if (!page_mode_param(ctx, &state->mode)) {
+    return;
+  }
+  const uint64_t min_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "min_kib", 64)) << 10;
+  uint64_t max_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "max_mib", kDefaultMaxMib)) << 20;
+  const uint64_t memory_bytes = static_cast<uint64_t>(sysconf(_SC_PHYS_PAGES)) *
+                                static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  if (find_param(*ctx, "max_mib") == nullptr && memory_bytes > 0 &&
+      max_bytes > memory_bytes / 2) {
+    max_bytes = memory_bytes / 2;
+    std::cerr << "tlb_random_access: note: max_mib capped at "
+              << (max_bytes >> 20)
+              << " (half of physical memory); the sweep may stop short of the "
+                 "2 MiB-page TLB reach\n";
+  }
+  const bool hugetlb = state->mode == PageMode::kHugetlb ||
+                       state->mode == PageMode::kHugetlb1G;
+  const uint64_t pool_bytes = hugetlb_free_bytes(state->mode);
+  if (hugetlb && max_bytes > pool_bytes) {
+    max_bytes = pool_bytes;
+    std::cerr << "tlb_random_access: note: max_mib capped at "
+              << (max_bytes >> 20)
+              << " (free hugetlb pool); the sweep may stop short of the "
+                 "2 MiB-page TLB reach\n";
+  }
+  const uint64_t per_octave =
+      std::max<uint64_t>(1, param_u64(*ctx, "per_octave", 2));
+
+  for (uint64_t bytes :
+       chase_sizes(min_bytes, max_bytes, per_octave, kBlockBytes)) {
+    state->sizes.push_back(SizeResult{bytes, {}, 0, 0});
+  }
+  if (state->sizes.empty() && hugetlb) {
+    ctx->skip_reason = "free hugetlb pool (" +
+                       std::to_string(pool_bytes >> 20) +
+                       " MiB) is smaller than min_kib";
+    return;
+  }
+  if (state->sizes.empty()) {
+    std::cerr << "tlb_random_access: min_kib exceeds max_mib\n";
+    std::exit(1);
+  }
+
+  state->buffer_bytes = page_round_up(state->sizes.back().size, state->mode);
+  std::string error;
+  void* buffer = map_pages(state->buffer_bytes, state->mode, true, &error);
+  if (buffer == nullptr && hugetlb) {
+    // The pool can shrink between the check above and the mapping.
+    ctx->skip_reason = error + " (free hugetlb pages ran out)";
+    return;
+  }
+  if (buffer == nullptr) {
+    std::cerr << "tlb_random_access: " << error << "\n";
+    std::exit(1);
+  }
+  state->buffer = static_cast<char*>(buffer);
+
+  if (!state->dtlb_misses.open(PerfEvent::kDtlbLoadMisses, &error)) {
+    std::cerr << "tlb_random_access: no dTLB counter: " << error << "\n";
+  }
+  state->per_size = std::max<uint64_t>(1, ctx->iters / state->sizes.size());
+  g_state = std::move(state);
+}
+
+void tlb_run_once(Ctx* ctx) {
+  TlbState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_size,
+                              state.sizes.size() - 1);
+  }
+  if (!state.built || target != state.active) {
+    start_size(state, target);
+  }
+
+  const uint64_t misses_before = state.dtlb_misses.read();
+  const uint64_t start = now_ns();
+  state.cursor = chase(state.cursor, kStepsPerSample);
+  const uint64_t elapsed = now_ns() - start;
+  const uint64_t misses_after = state.dtlb_misses.read();
+  g_sink = state.cursor;
+  if (ctx->warming_up) {
+    return;
+  }
+  const double per_load =
+      static_cast<double>(elapsed) / static_cast<double>(kStepsPerSample);
+  SizeResult& result = state.sizes[target];
+  result.ns_per_load.push_back(per_load);
+  result.loads += kStepsPerSample;
+  result.misses += misses_after - misses_before;
+  ++state.measured;
+  record_sample(ctx, static_cast<uint64_t>(std::llround(per_load)));
+}
+
+double quantile(const std::vector<double>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+std::string format_sweep(const TlbState& state) {
+  const size_t page = page_bytes(state.mode);
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "size_bytes,pages,samples,p50_ns,mean_ns,p99_ns,"
+         "dtlb_misses_per_load\n";
+  for (const SizeResult& result : state.sizes) {
+    if (result.ns_per_load.empty()) {
+      continue;
+    }
+    std::vector<double> sorted = result.ns_per_load;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (double v : sorted) {
+      sum += v;
+    }
+    out << result.size << "," << (result.size + page - 1) / page << ","
+        << sorted.size() << "," << quantile(sorted, 0.50) << ","
+        << sum / static_cast<double>(sorted.size()) << ","
+        << quantile(sorted, 0.99) << ",";
+    if (state.dtlb_misses.available()) {
+      out << std::setprecision(4)
+          << static_cast<double>(result.misses) /
+                 static_cast<double>(result.loads)
+          << std::setprecision(2);
+    }
+    out << "\n";
+  }
+  return out.str();
+}
+
+void tlb_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  TlbState& state = *g_state;
+  std::string error;
+  if (state.measured > 0 &&
+      !write_artifact(ctx, "sweep.csv", format_sweep(state), &error)) {
+    std::cerr << "tlb_random_access: failed to write sweep.csv: " << error
+              << "\n";
+  }
+  unmap_pages(state.buffer, state.buffer_bytes, state.mode);
+  g_state.reset();
+}
+
+const Case kTlbRandomAccessCase{
+    "tlb_random_access",
+    tlb_setup,
+    tlb_run_once,
+    tlb_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kTlbRandomAccessCase);
+#endif
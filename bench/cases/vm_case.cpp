@@ -0,0 +1,401 @@
+#include "artifacts.h"
+#include "case.h"
+#include "pages.h"
+#include "params.h"
+#include "registry.h"
+#include "timer.h"
+
+// Costs of the virtual memory operations behind allocation-heavy code, on
+// anonymous private mappings.
+//
+// Cases:
+//   vm_first_touch       one sample per page: the first write to a page of a
+//                        fresh mapping (the fault, zeroing and PTE install).
+//                        The region_mib mapping is replaced, untimed, once
+//                        every page has been touched.
+//   vm_mmap_populate     mmap(MAP_POPULATE) of a range. hugepages=off times
+//                        the plain call, so the system THP policy applies
+//                        as it would to any mmap; hugetlb adds MAP_HUGETLB;
+//                        THP is mmap + trim + advice + MADV_POPULATE_WRITE
+//                        (see pages.h)
+//   vm_munmap            munmap of a fully faulted range
+//   vm_madvise_dontneed  madvise(MADV_DONTNEED) of a faulted range
+//   vm_madvise_free      madvise(MADV_FREE) of a dirtied range (4 KiB/THP)
+//   vm_mprotect          mprotect toggling a faulted range between RW and R
+//
+// The per-call cases sweep the range size geometrically and split --iters
+// across sizes, smallest first. Re-faulting a range between calls happens
+// outside the sample. Samples are ns per call; sweep.csv adds the per-page
+// view:
+//   size_bytes,pages,samples,p50_ns,mean_ns,p99_ns,p50_ns_per_page
+//
+// Params:
+//   hugepages=<mode>             page size (see pages.h)
+//   region_mib=<n>               vm_first_touch mapping size (default 64)
+//   min_kib=<n>, max_mib=<n>     per-call sweep bounds (default 4 KiB, 64 MiB;
+//                                rounded up to whole pages)
+//   per_octave=<n>               sizes per doubling (default 1)
+
+#if defined(__linux__)
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "vm: " << message << "\n";
+  std::exit(1);
+}
+
+enum class Op {
+  kFirstTouch,
+  kMmapPopulate,
+  kMunmap,
+  kMadviseDontneed,
+  kMadviseFree,
+  kMprotect,
+};
+
+struct SizeResult {
+  uint64_t size = 0;
+  std::vector<uint64_t> ns;
+};
+
+struct VmState {
+  Op op = Op::kFirstTouch;
+  PageMode mode = PageMode::kSmall;
+  size_t page = kSmallPageBytes;
+
+  // Current mapping (nullptr when unmapped).
+  char* addr = nullptr;
+  size_t bytes = 0;
+  size_t next_page = 0;    // vm_first_touch cursor
+  bool writable = true;    // vm_mprotect toggle
+
+  std::vector<SizeResult> sizes;
+  uint64_t per_size = 1;
+  uint64_t measured = 0;
+  size_t active = 0;
+  bool started = false;
+};
+
+std::unique_ptr<VmState> g_state;
+
+void map_range(VmState& state, size_t bytes, bool populate) {
+  std::string error;
+  void* addr = map_pages(bytes, state.mode, populate, &error);
+  if (addr == nullptr) {
+    fail(error);
+  }
+  state.addr = static_cast<char*>(addr);
+  state.bytes = bytes;
+  state.next_page = 0;
+  state.writable = true;
+}
+
+void unmap_range(VmState& state) {
+  if (state.addr != nullptr) {
+    unmap_pages(state.addr, state.bytes, state.mode);
+    state.addr = nullptr;
+  }
+}
+
+// Write one byte per page so every page is faulted in and dirty.
+void touch_range(const VmState& state) {
+  for (size_t off = 0; off < state.bytes; off += state.page) {
+    state.addr[off] = 1;
+  }
+}
+
+void vm_setup(Ctx* ctx, Op op) {
+  auto state = std::make_unique<VmState>();
+  state->op = op;
+  if (!page_mode_param(ctx, &state->mode)) {
+    return;
+  }
+  state->page = page_bytes(state->mode);
+  if (op == Op::kMadviseFree && (state->mode == PageMode::kHugetlb ||
+                                 state->mode == PageMode::kHugetlb1G)) {
+    ctx->skip_reason = "MADV_FREE does not apply to hugetlb mappings";
+    return;
+  }
+
+  if (op == Op::kFirstTouch) {
+    const size_t region =
+        std::max<uint64_t>(1, param_u64(*ctx, "region_mib", 64)) << 20;
+    map_range(*state, page_round_up(region, state->mode), false);
+    g_state = std::move(state);
+    return;
+  }
+
+  const uint64_t min_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "min_kib", 4)) << 10;
+  const uint64_t max_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "max_mib", 64)) << 20;
+  const uint64_t per_octave =
+      std::max<uint64_t>(1, param_u64(*ctx, "per_octave", 1));
+  for (double size = static_cast<double>(min_bytes);
+       size <= static_cast<double>(max_bytes) * 1.0001;
+       size *= std::pow(2.0, 1.0 / static_cast<double>(per_octave))) {
+    const uint64_t bytes =
+        page_round_up(static_cast<size_t>(size), state->mode);
+    if (state->sizes.empty() || state->sizes.back().size != bytes) {
+      state->sizes.push_back(SizeResult{bytes, {}});
+    }
+  }
+  if (state->sizes.empty()) {
+    fail("min_kib exceeds max_mib");
+  }
+  state->per_size = std::max<uint64_t>(1, ctx->iters / state->sizes.size());
+  g_state = std::move(state);
+}
+
+void first_touch_run_once(Ctx* ctx) {
+  VmState& state = *g_state;
+  if (state.next_page * state.page >= state.bytes) {
+    const size_t bytes = state.bytes;
+    unmap_range(state);
+    map_range(state, bytes, false);
+  }
+  char* page = state.addr + state.next_page * state.page;
+  ++state.next_page;
+
+  const uint64_t start = now_ns();
+  *static_cast<volatile char*>(page) = 1;
+  const uint64_t elapsed = now_ns() - start;
+  record_sample(ctx, elapsed);
+}
+
+// Untimed: bring the range into the state the measured call expects.
+void prepare_call(VmState& state, size_t bytes) {
+  switch (state.op) {
+    case Op::kMmapPopulate:
+      break;
+    case Op::kMunmap:
+      map_range(state, bytes, true);
+      break;
+    case Op::kMadviseDontneed:
+    case Op::kMadviseFree:
+      touch_range(state);
+      break;
+    case Op::kMprotect:
+    case Op::kFirstTouch:
+      break;
+  }
+}
+
+// The measured call.
+void timed_call(VmState& state, size_t bytes) {
+  int rc = 0;
+  switch (state.op) {
+    case Op::kMmapPopulate: {
+      std::string error;
+      // map_pages() prefaults 4 KiB mappings after MADV_NOHUGEPAGE, which
+      // is not the MAP_POPULATE cost this case times.
+      void* addr =
+          state.mode == PageMode::kSmall
+              ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0)
+              : map_pages(bytes, state.mode, true, &error);
+      if (addr == MAP_FAILED) {
+        fail(std::string("mmap failed: ") + std::strerror(errno));
+      }
+      if (addr == nullptr) {
+        fail(error);
+      }
+      state.addr = static_cast<char*>(addr);
+      state.bytes = bytes;
+      break;
+    }
+    case Op::kMunmap:
+      rc = munmap(state.addr, bytes);
+      state.addr = nullptr;
+      break;
+    case Op::kMadviseDontneed:
+      rc = madvise(state.addr, bytes, MADV_DONTNEED);
+      break;
+    case Op::kMadviseFree:
+      rc = madvise(state.addr, bytes, MADV_FREE);
+      break;
+    case Op::kMprotect:
+      state.writable = !state.writable;
+      rc = mprotect(state.addr, bytes,
+                    state.writable ? PROT_READ | PROT_WRITE : PROT_READ);
+      break;
+    case Op::kFirstTouch:
+      break;
+  }
+  if (rc != 0) {
+    fail(std::string("call failed: ") + std::strerror(errno));
+  }
+}
+
+// Untimed: undo whatever the measured call left behind.
+void finish_call(VmState& state) {
+  if (state.op == Op::kMmapPopulate) {
+    unmap_range(state);
+  }
+}
+
+void start_size(VmState& state, size_t index) {
+  unmap_range(state);
+  const size_t bytes = state.sizes[index].size;
+  if (state.op != Op::kMmapPopulate && state.op != Op::kMunmap) {
+    // One long-lived range, faulted in up front.
+    map_range(state, bytes, true);
+    touch_range(state);
+  }
+  state.active = index;
+  state.started = true;
+}
+
+void call_run_once(Ctx* ctx) {
+  VmState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_size,
+                              state.sizes.size() - 1);
+  }
+  if (!state.started || target != state.active) {
+    start_size(state, target);
+  }
+  const size_t bytes = state.sizes[target].size;
+
+  prepare_call(state, bytes);
+  const uint64_t start = now_ns();
+  timed_call(state, bytes);
+  const uint64_t elapsed = now_ns() - start;
+  finish_call(state);
+
+  record_sample(ctx, elapsed);
+  if (!ctx->warming_up) {
+    state.sizes[target].ns.push_back(elapsed);
+    ++state.measured;
+  }
+}
+
+void vm_run_once(Ctx* ctx) {
+  if (g_state->op == Op::kFirstTouch) {
+    first_touch_run_once(ctx);
+  } else {
+    call_run_once(ctx);
+  }
+}
+
+uint64_t quantile(const std::vector<uint64_t>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+std::string format_sweep(const VmState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "size_bytes,pages,samples,p50_ns,mean_ns,p99_ns,p50_ns_per_page\n";
+  for (const SizeResult& result : state.sizes) {
+    if (result.ns.empty()) {
+      continue;
+    }
+    std::vector<uint64_t> sorted = result.ns;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (uint64_t v : sorted) {
+      sum += static_cast<double>(v);
+    }
+    const uint64_t pages = result.size / state.page;
+    out << result.size << "," << pages << "," << sorted.size() << ","
+        << quantile(sorted, 0.50) << ","
+        << sum / static_cast<double>(sorted.size()) << ","
+        << quantile(sorted, 0.99) << ","
+        << static_cast<double>(quantile(sorted, 0.50)) /
+               static_cast<double>(pages)
+        << "\n";
+  }
+  return out.str();
+}
+
+void vm_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  VmState& state = *g_state;
+  std::string error;
+  if (state.measured > 0 &&
+      !write_artifact(ctx, "sweep.csv", format_sweep(state), &error)) {
+    std::cerr << "vm: failed to write sweep.csv: " << error << "\n";
+  }
+  unmap_range(state);
+  g_state.reset();
+}
+
+template <Op O>
+void setup_for(Ctx* ctx) {
+  vm_setup(ctx, O);
+}
+
+const Case kVmFirstTouchCase{
+    "vm_first_touch",
+    setup_for<Op::kFirstTouch>,
+    vm_run_once,
+    vm_teardown,
+};
+
+const Case kVmMmapPopulateCase{
+    "vm_mmap_populate",
+    setup_for<Op::kMmapPopulate>,
+    vm_run_once,
+    vm_teardown,
+};
+
+const Case kVmMunmapCase{
+    "vm_munmap",
+    setup_for<Op::kMunmap>,
+    vm_run_once,
+    vm_teardown,
+};
+
+const Case kVmMadviseDontneedCase{
+    "vm_madvise_dontneed",
+    setup_for<Op::kMadviseDontneed>,
+    vm_run_once,
+    vm_teardown,
+};
+
+const Case kVmMadviseFreeCase{
+    "vm_madvise_free",
+    setup_for<Op::kMadviseFree>,
+    vm_run_once,
+    vm_teardown,
+};
+
+const Case kVmMprotectCase{
+    "vm_mprotect",
+    setup_for<Op::kMprotect>,
+    vm_run_once,
+    vm_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kVmFirstTouchCase);
+LATENCY_LAB_REGISTER_CASE(kVmMmapPopulateCase);
+LATENCY_LAB_REGISTER_CASE(kVmMunmapCase);
+LATENCY_LAB_REGISTER_CASE(kVmMadviseDontneedCase);
+LATENCY_LAB_REGISTER_CASE(kVmMadviseFreeCase);
+LATENCY_LAB_REGISTER_CASE(kVmMprotectCase);
+#endif
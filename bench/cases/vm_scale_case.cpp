@@ -0,0 +1,272 @@
+#include "case.h"
+#include "pages.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "threads.h"
+#include "timer.h"
+
+// Address-space scalability: the bench thread and `threads - 1` workers run
+// the same VM operation concurrently, each on its own regions of one process.
+// The regions never overlap, so any slowdown as threads grow comes from
+// shared per-process state: the mmap lock, VMA tree updates and the TLB
+// shootdowns munmap sends to every CPU running the process.
+//
+// Cases:
+//   vm_scale_mmap_munmap  one op = mmap of region_kib, a write to its first
+//                         page (touch=true) and munmap. hugepages=off and
+//                         hugetlb issue just those two calls; thp adds the
+//                         2 MiB alignment over-map, up to two trimming
+//                         munmaps and MADV_HUGEPAGE (see pages.h), each
+//                         taking the mmap lock for writing (region_kib is
+//                         rounded up to whole 2 MiB pages there)
+//   vm_scale_fault        one op = first write to a page of the thread's
+//                         region_mib mapping; exhausted mappings are replaced
+//                         outside the op (and outside the bench thread's
+//                         sample)
+//
+// Each sample is one bench-thread op. Run the case once per thread count to
+// see the scaling curve; ops_per_sec sums all threads over the timed window
+// and ops_per_sec_per_thread divides it by `threads`.
+//
+// Params:
+//   threads=<n>          threads including the bench thread (default 4)
+//   hugepages=<mode>     page size (see pages.h)
+//   region_kib=<n>       vm_scale_mmap_munmap mapping size (default 64)
+//   touch=true|false     vm_scale_mmap_munmap: fault the first page, so
+//                        munmap has a PTE to zap and a TLB to flush
+//                        (default true)
+//   region_mib=<n>       vm_scale_fault per-thread mapping (default 16)
+//   cpus=<list>          see thread_cpus() in placement.h
+
+#if defined(__linux__)
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <thread>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "vm_scale: " << message << "\n";
+  std::exit(1);
+}
+
+enum class Op {
+  kMmapMunmap,
+  kFault,
+};
+
+// Per-thread region and op counter. Each slot is owned by one thread.
+struct alignas(64) ScaleSlot {
+  char* addr = nullptr;
+  size_t bytes = 0;
+  size_t next_page = 0;
+  std::atomic<uint64_t> ops{0};
+};
+
+struct ScaleState {
+  Op op = Op::kMmapMunmap;
+  PageMode mode = PageMode::kSmall;
+  size_t page = kSmallPageBytes;
+  size_t region_bytes = 0;
+  bool touch = true;
+  std::vector<ScaleSlot> slots;  // slot 0 is the bench thread
+  std::vector<std::thread> workers;
+  std::atomic<bool> stop{false};
+  bool window_open = false;
+  uint64_t window_start_ns = 0;
+  uint64_t window_start_ops = 0;
+};
+
+std::unique_ptr<ScaleState> g_state;
+
+char* map_region(const ScaleState& state, size_t bytes) {
+  std::string error;
+  void* addr = map_pages(bytes, state.mode, false, &error);
+  if (addr == nullptr) {
+    fail(error);
+  }
+  return static_cast<char*>(addr);
+}
+
+// Untimed: give vm_scale_fault a fresh mapping once every page is touched.
+void prepare_op(const ScaleState& state, ScaleSlot* slot) {
+  if (state.op != Op::kFault || slot->next_page * state.page < slot->bytes) {
+    return;
+  }
+  if (slot->addr != nullptr) {
+    unmap_pages(slot->addr, slot->bytes, state.mode);
+  }
+  slot->bytes = state.region_bytes;
+  slot->addr = map_region(state, slot->bytes);
+  slot->next_page = 0;
+}
+
+void run_op(const ScaleState& state, ScaleSlot* slot) {
+  if (state.op == Op::kFault) {
+    char* page = slot->addr + slot->next_page * state.page;
+    ++slot->next_page;
+    *static_cast<volatile char*>(page) = 1;
+  } else if (state.mode == PageMode::kSmall) {
+    // Plain calls: map_pages() would add a MADV_NOHUGEPAGE, one more mmap
+    // lock round trip per op.
+    void* addr = mmap(nullptr, state.region_bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      fail(std::string("mmap failed: ") + std::strerror(errno));
+    }
+    if (state.touch) {
+      *static_cast<volatile char*>(addr) = 1;
+    }
+    munmap(addr, state.region_bytes);
+  } else {
+    char* addr = map_region(state, state.region_bytes);
+    if (state.touch) {
+      *static_cast<volatile char*>(addr) = 1;
+    }
+    unmap_pages(addr, state.region_bytes, state.mode);
+  }
+  slot->ops.store(slot->ops.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+}
+
+void worker_loop(ScaleState* state, ScaleSlot* slot) {
+  while (!state->stop.load(std::memory_order_relaxed)) {
+    prepare_op(*state, slot);
+    run_op(*state, slot);
+  }
+}
+
+uint64_t total_ops(const ScaleState& state) {
+  uint64_t total = 0;
+  for (const ScaleSlot& slot : state.slots) {
+    total += slot.ops.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void scale_setup(Ctx* ctx, Op op) {
+  auto state = std::make_unique<ScaleState>();
+  state->op = op;
+  if (!page_mode_param(ctx, &state->mode)) {
+    return;
+  }
+  state->page = page_bytes(state->mode);
+  const uint64_t threads =
+      std::max<uint64_t>(1, param_u64(*ctx, "threads", 4));
+  if (op == Op::kMmapMunmap) {
+    state->region_bytes = page_round_up(
+        std::max<uint64_t>(1, param_u64(*ctx, "region_kib", 64)) << 10,
+        state->mode);
+    state->touch = param_bool(*ctx, "touch", true);
+  } else {
+    state->region_bytes = page_round_up(
+        std::max<uint64_t>(1, param_u64(*ctx, "region_mib", 16)) << 20,
+        state->mode);
+  }
+  state->slots = std::vector<ScaleSlot>(threads);
+
+  const std::vector<int> cpus = thread_cpus(*ctx, threads);
+  std::string error;
+  if (cpus[0] >= 0 && !pin_to_cpu(cpus[0], &error)) {
+    fail("failed to pin to cpu " + std::to_string(cpus[0]) + ": " + error);
+  }
+  ScaleState* raw = state.get();
+  state->workers.resize(threads - 1);
+  for (size_t i = 1; i < threads; ++i) {
+    ScaleSlot* slot = &state->slots[i];
+    if (!start_pinned_thread(
+            cpus[i], [raw, slot]() { worker_loop(raw, slot); },
+            &state->workers[i - 1], &error)) {
+      fail("failed to start worker: " + error);
+    }
+  }
+  g_state = std::move(state);
+}
+
+void scale_run_once(Ctx* ctx) {
+  ScaleState& state = *g_state;
+  if (!ctx->warming_up && !state.window_open) {
+    state.window_open = true;
+    state.window_start_ns = now_ns();
+    state.window_start_ops = total_ops(state);
+  }
+  ScaleSlot* slot = &state.slots[0];
+  prepare_op(state, slot);
+  const uint64_t start = now_ns();
+  run_op(state, slot);
+  const uint64_t elapsed = now_ns() - start;
+  record_sample(ctx, elapsed);
+}
+
+void scale_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  ScaleState& state = *g_state;
+  const uint64_t end_ns = now_ns();
+  const uint64_t window_ops = total_ops(state) - state.window_start_ops;
+  state.stop.store(true, std::memory_order_relaxed);
+  for (std::thread& worker : state.workers) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+
+  if (state.window_open && end_ns > state.window_start_ns) {
+    const double seconds =
+        static_cast<double>(end_ns - state.window_start_ns) / 1e9;
+    const double rate = static_cast<double>(window_ops) / seconds;
+    record_metric(ctx, "ops_per_sec", rate);
+    record_metric(ctx, "ops_per_sec_per_thread",
+                  rate / static_cast<double>(state.slots.size()));
+  }
+
+  for (ScaleSlot& slot : state.slots) {
+    if (slot.addr != nullptr) {
+      unmap_pages(slot.addr, slot.bytes, state.mode);
+    }
+  }
+  restore_affinity(*ctx);
+  g_state.reset();
+}
+
+template <Op O>
+void setup_for(Ctx* ctx) {
+  scale_setup(ctx, O);
+}
+
+const Case kVmScaleMmapMunmapCase{
+    "vm_scale_mmap_munmap",
+    setup_for<Op::kMmapMunmap>,
+    scale_run_once,
+    scale_teardown,
+};
+
+const Case kVmScaleFaultCase{
+    "vm_scale_fault",
+    setup_for<Op::kFault>,
+    scale_run_once,
+    scale_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kVmScaleMmapMunmapCase);
+LATENCY_LAB_REGISTER_CASE(kVmScaleFaultCase);
+#endif
@@ -0,0 +1,390 @@
+#include "case.h"
+#include "params.h"
+#include "placement.h"
+#include "registry.h"
+#include "spin.h"
+#include "threads.h"
+#include "timer.h"
+
+// Inter-thread wakeup latency: the bench thread signals a pinned peer thread
+// through one of several kernel/library primitives and waits for the reply.
+//
+// Cases: wakeup_futex, wakeup_condvar, wakeup_eventfd, wakeup_pipe,
+//        wakeup_sem, wakeup_atomic_wait
+//
+// Params:
+//   measure=roundtrip|oneway  roundtrip (default) times ping + pong; oneway
+//                             times signal -> peer running (peer stamps the
+//                             clock as soon as its wait returns)
+//   spin=<n>                  poll n times before blocking (default 0 = block
+//                             immediately); models spin-then-block waiters
+//   placement/peer_cpu        see placement.h (same-core vs cross-core)
+
+#if defined(__linux__)
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <semaphore.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <linux/futex.h>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "wakeup: " << message << "\n";
+  std::exit(1);
+}
+
+// One direction of the ping-pong. try_wait() consumes a pending signal
+// without blocking so spin-then-block can poll before sleeping.
+class WakeChannel {
+ public:
+  virtual ~WakeChannel() = default;
+  virtual void post() = 0;
+  virtual bool try_wait() = 0;
+  virtual void wait() = 0;
+};
+
+long futex(std::atomic<uint32_t>* word, int op, uint32_t value) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value,
+                 nullptr, nullptr, 0);
+}
+
+class FutexChannel final : public WakeChannel {
+ public:
+  void post() override {
+    word_.store(1, std::memory_order_release);
+    futex(&word_, FUTEX_WAKE_PRIVATE, 1);
+  }
+  bool try_wait() override {
+    return word_.exchange(0, std::memory_order_acquire) == 1;
+  }
+  void wait() override {
+    while (word_.exchange(0, std::memory_order_acquire) == 0) {
+      futex(&word_, FUTEX_WAIT_PRIVATE, 0);
+    }
+  }
+
+ private:
+  alignas(64) std::atomic<uint32_t> word_{0};
+};
+
+// C++20 atomic wait/notify; libstdc++ may spin briefly before the futex.
+class AtomicWaitChannel final : public WakeChannel {
+ public:
+  void post() override {
+    word_.store(1, std::memory_order_release);
+    word_.notify_one();
+  }
+  bool try_wait() override {
+    return word_.exchange(0, std::memory_order_acquire) == 1;
+  }
+  void wait() override {
+    while (word_.exchange(0, std::memory_order_acquire) == 0) {
+      word_.wait(0, std::memory_order_acquire);
+    }
+  }
+
+ private:
+  alignas(64) std::atomic<uint32_t> word_{0};
+};
+
+class CondvarChannel final : public WakeChannel {
+ public:
+  void post() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_ = true;
+    }
+    cv_.notify_one();
+  }
+  bool try_wait() override {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !ready_) {
+      return false;
+    }
+    ready_ = false;
+    return true;
+  }
+  void wait() override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return ready_; });
+    ready_ = false;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool ready_ = false;
+};
+
+bool fd_readable(int fd) {
+  pollfd pfd{fd, POLLIN, 0};
+  return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+class EventfdChannel final : public WakeChannel {
+ public:
+  EventfdChannel() : fd_(eventfd(0, EFD_CLOEXEC)) {
+    if (fd_ < 0) {
+      fail("eventfd failed");
+    }
+  }
+  ~EventfdChannel() override { close(fd_); }
+  void post() override {
+    const uint64_t one = 1;
+    while (write(fd_, &one, sizeof(one)) < 0 && errno == EINTR) {
+    }
+  }
+  bool try_wait() override {
+    if (!fd_readable(fd_)) {
+      return false;
+    }
+    wait();
+    return true;
+  }
+  void wait() override {
+    uint64_t value = 0;
+    while (read(fd_, &value, sizeof(value)) < 0 && errno == EINTR) {
+    }
+  }
+
+ private:
+  int fd_;
+};
+
+class PipeChannel final : public WakeChannel {
+ public:
+  PipeChannel() {
+    if (pipe2(fds_, O_CLOEXEC) != 0) {
+      fail("pipe2 failed");
+    }
+  }
+  ~PipeChannel() override {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+  void post() override {
+    const char byte = 1;
+    while (write(fds_[1], &byte, 1) < 0 && errno == EINTR) {
+    }
+  }
+  bool try_wait() override {
+    if (!fd_readable(fds_[0])) {
+      return false;
+    }
+    wait();
+    return true;
+  }
+  void wait() override {
+    char byte = 0;
+    while (read(fds_[0], &byte, 1) < 0 && errno == EINTR) {
+    }
+  }
+
+ private:
+  int fds_[2] = {-1, -1};
+};
+
+class SemChannel final : public WakeChannel {
+ public:
+  SemChannel() {
+    if (sem_init(&sem_, 0, 0) != 0) {
+      fail("sem_init failed");
+    }
+  }
+  ~SemChannel() override { sem_destroy(&sem_); }
+  void post() override { sem_post(&sem_); }
+  bool try_wait() override { return sem_trywait(&sem_) == 0; }
+  void wait() override {
+    while (sem_wait(&sem_) != 0 && errno == EINTR) {
+    }
+  }
+
+ private:
+  sem_t sem_;
+};
+
+enum class Mechanism {
+  kFutex,
+  kCondvar,
+  kEventfd,
+  kPipe,
+  kSem,
+  kAtomicWait,
+};
+
+std::unique_ptr<WakeChannel> make_channel(Mechanism mechanism) {
+  switch (mechanism) {
+    case Mechanism::kFutex:
+      return std::make_unique<FutexChannel>();
+    case Mechanism::kCondvar:
+      return std::make_unique<CondvarChannel>();
+    case Mechanism::kEventfd:
+      return std::make_unique<EventfdChannel>();
+    case Mechanism::kPipe:
+      return std::make_unique<PipeChannel>();
+    case Mechanism::kSem:
+      return std::make_unique<SemChannel>();
+    case Mechanism::kAtomicWait:
+      return std::make_unique<AtomicWaitChannel>();
+  }
+  return nullptr;
+}
+
+void spin_then_wait(WakeChannel* channel, uint64_t spin) {
+  for (uint64_t i = 0; i < spin; ++i) {
+    if (channel->try_wait()) {
+      return;
+    }
+    cpu_relax();
+  }
+  channel->wait();
+}
+
+struct WakeupState {
+  Placement placement;
+  bool oneway = false;
+  uint64_t spin = 0;
+  std::unique_ptr<WakeChannel> ping;
+  std::unique_ptr<WakeChannel> pong;
+  std::atomic<bool> stop{false};
+  // Written by the peer right after its wait returns (oneway mode).
+  alignas(64) std::atomic<uint64_t> woke_ns{0};
+  std::thread peer;
+};
+
+std::unique_ptr<WakeupState> g_state;
+
+void peer_loop(WakeupState* state) {
+  while (true) {
+    spin_then_wait(state->ping.get(), state->spin);
+    if (state->oneway) {
+      state->woke_ns.store(now_ns(), std::memory_order_relaxed);
+    }
+    if (state->stop.load(std::memory_order_acquire)) {
+      return;
+    }
+    state->pong->post();
+  }
+}
+
+void wakeup_setup(Ctx* ctx, Mechanism mechanism) {
+  auto state = std::make_unique<WakeupState>();
+  state->oneway = param_choice(*ctx, "measure", {"roundtrip", "oneway"},
+                               "roundtrip") == "oneway";
+  state->spin = param_u64(*ctx, "spin", 0);
+  if (!setup_placement(ctx, &state->placement)) {
+    return;
+  }
+  state->ping = make_channel(mechanism);
+  state->pong = make_channel(mechanism);
+
+  std::string error;
+  WakeupState* raw = state.get();
+  if (!start_pinned_thread(state->placement.peer_cpu,
+                           [raw]() { peer_loop(raw); }, &state->peer,
+                           &error)) {
+    fail("failed to start peer: " + error);
+  }
+  g_state = std::move(state);
+}
+
+void wakeup_run_once(Ctx* ctx) {
+  WakeupState& state = *g_state;
+  const uint64_t start = now_ns();
+  state.ping->post();
+  spin_then_wait(state.pong.get(), state.spin);
+  const uint64_t end = now_ns();
+  // The peer's stamp is published before its pong, so it is visible here.
+  record_sample(ctx, state.oneway
+                         ? state.woke_ns.load(std::memory_order_relaxed) - start
+                         : end - start);
+}
+
+void wakeup_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  WakeupState& state = *g_state;
+  if (state.peer.joinable()) {
+    state.stop.store(true, std::memory_order_release);
+    state.ping->post();
+    state.peer.join();
+  }
+  restore_placement(*ctx, state.placement);
+  g_state.reset();
+}
+
+template <Mechanism M>
+void setup_for(Ctx* ctx) {
+  wakeup_setup(ctx, M);
+}
+
+const Case kWakeupFutexCase{
+    "wakeup_futex",
+    setup_for<Mechanism::kFutex>,
+    wakeup_run_once,
+    wakeup_teardown,
+};
+
+const Case kWakeupCondvarCase{
+    "wakeup_condvar",
+    setup_for<Mechanism::kCondvar>,
+    wakeup_run_once,
+    wakeup_teardown,
+};
+
+const Case kWakeupEventfdCase{
+    "wakeup_eventfd",
+    setup_for<Mechanism::kEventfd>,
+    wakeup_run_once,
+    wakeup_teardown,
+};
+
+const Case kWakeupPipeCase{
+    "wakeup_pipe",
+    setup_for<Mechanism::kPipe>,
+    wakeup_run_once,
+    wakeup_teardown,
+};
+
+const Case kWakeupSemCase{
+    "wakeup_sem",
+    setup_for<Mechanism::kSem>,
+    wakeup_run_once,
+    wakeup_teardown,
+};
+
+const Case kWakeupAtomicWaitCase{
+    "wakeup_atomic_wait",
+    setup_for<Mechanism::kAtomicWait>,
+    wakeup_run_once,
+    wakeup_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kWakeupFutexCase);
+LATENCY_LAB_REGISTER_CASE(kWakeupCondvarCase);
+LATENCY_LAB_REGISTER_CASE(kWakeupEventfdCase);
+LATENCY_LAB_REGISTER_CASE(kWakeupPipeCase);
+LATENCY_LAB_REGISTER_CASE(kWakeupSemCase);
+LATENCY_LAB_REGISTER_CASE(kWakeupAtomicWaitCase);
+#endif
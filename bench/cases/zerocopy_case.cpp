@@ -0,0 +1,543 @@
+#include "artifacts.h"
+#include "case.h"
+#include "params.h"
+#include "pinning.h"
+#include "placement.h"
+#include "registry.h"
+#include "threads.h"
+#include "timer.h"
+
+// Copying versus zero-copy data movement between fds, by payload size.
+//
+// Cases (source -> destination: mechanism):
+//   zc_rw_socket         file -> socket: pread into a buffer + write
+//   zc_sendfile_socket   file -> socket: sendfile
+//   zc_splice_socket     file -> socket: splice into a pipe, splice out
+//   zc_rw_file           file -> file: pread + pwrite
+//   zc_copy_file_range   file -> file: copy_file_range
+//   zc_write_pipe        memory -> pipe: write
+//   zc_vmsplice_pipe     memory -> pipe: vmsplice (pages are referenced, not
+//                        copied)
+//
+// The source file is filled and read once in setup, so it sits in the page
+// cache; transfers walk it in `size` steps and wrap at file_mib. File
+// destinations are overwritten at the source offset. Socket and pipe
+// destinations are drained by a helper thread (read() for sockets, splice to
+// /dev/null for pipes) that is never timed.
+//
+// A sample is one transfer of `size` bytes on the bench thread, in ns, until
+// every byte has been handed to the destination fd. Sizes sweep
+// geometrically and --iters is split evenly across them, smallest first.
+// Per-size results go to sweep.csv:
+//   size_bytes,samples,p50_ns,mean_ns,p99_ns,mib_per_sec
+// where mib_per_sec is size / mean.
+//
+// Params:
+//   min_kib=<n>         smallest payload (default 4)
+//   max_mib=<n>         largest payload (default 16)
+//   per_octave=<n>      sizes per doubling (default 1)
+//   socket=unix|tcp     socket cases: AF_UNIX socketpair (default) or a
+//                       127.0.0.1 TCP connection
+//   dir=<path>          directory for the files (default /var/tmp)
+//   file_mib=<n>        source file size (default 64; raised to max_mib)
+//   cpus=<list>         bench thread and drain thread, see thread_cpus()
+
+#if defined(__linux__)
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <sstream>
+#include <string>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+
+constexpr size_t kPipeBytes = 1u << 20;
+constexpr size_t kDrainBytes = 1u << 20;
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "zerocopy: " << message << ": " << std::strerror(errno)
+            << "\n";
+  std::exit(1);
+}
+
+enum class Method {
+  kRwSocket,
+  kSendfileSocket,
+  kSpliceSocket,
+  kRwFile,
+  kCopyFileRange,
+  kWritePipe,
+  kVmsplicePipe,
+};
+
+bool to_socket(Method method) {
+  return method == Method::kRwSocket || method == Method::kSendfileSocket ||
+         method == Method::kSpliceSocket;
+}
+
+bool to_file(Method method) {
+  return method == Method::kRwFile || method == Method::kCopyFileRange;
+}
+
+bool from_file(Method method) {
+  return to_socket(method) || to_file(method);
+}
+
+struct SizeResult {
+  uint64_t size = 0;
+  std::vector<uint64_t> ns;
+};
+
+struct ZcState {
+  Method method = Method::kRwSocket;
+  std::vector<SizeResult> sizes;
+  uint64_t per_size = 1;
+  uint64_t measured = 0;
+
+  int src_fd = -1;     // source file
+  uint64_t file_bytes = 0;
+  uint64_t offset = 0;
+  int dst_fd = -1;     // file, socket or pipe write end
+  int drain_fd = -1;   // socket peer or pipe read end
+  int splice_r = -1;   // zc_splice_socket's intermediate pipe
+  int splice_w = -1;
+  char* buffer = nullptr;
+  std::thread drainer;
+};
+
+std::unique_ptr<ZcState> g_state;
+
+int create_unlinked(const std::string& dir, const char* tag) {
+  const std::string path = dir + "/latency_lab_zc_" + tag + "_" +
+                           std::to_string(getpid()) + ".dat";
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd >= 0) {
+    unlink(path.c_str());
+  }
+  return fd;
+}
+
+void write_full(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = ::write(fd, data, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      fail("write failed");
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+  }
+}
+
+void grow_pipe(int fd) {
+  // Best effort: the default 64 KiB pipe still works, in more steps.
+  fcntl(fd, F_SETPIPE_SZ, static_cast<int>(kPipeBytes));
+}
+
+void socket_pair(const std::string& kind, int* a, int* b) {
+  if (kind == "unix") {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+      fail("socketpair failed");
+    }
+    *a = fds[0];
+    *b = fds[1];
+    return;
+  }
+  const int listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t len = sizeof(addr);
+  if (listener < 0 ||
+      bind(listener, reinterpret_cast<const sockaddr*>(&addr),
+           sizeof(addr)) != 0 ||
+      getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+      listen(listener, 1) != 0) {
+    fail("tcp listen on 127.0.0.1 failed");
+  }
+  *a = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (*a < 0 || connect(*a, reinterpret_cast<const sockaddr*>(&addr),
+                        sizeof(addr)) != 0) {
+    fail("tcp connect failed");
+  }
+  *b = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+  if (*b < 0) {
+    fail("tcp accept failed");
+  }
+  close(listener);
+}
+
+// Runs until the write side is closed in teardown.
+void drain_loop(ZcState* state) {
+  if (to_socket(state->method)) {
+    std::vector<char> sink(kDrainBytes);
+    while (true) {
+      const ssize_t n = ::read(state->drain_fd, sink.data(), sink.size());
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        return;
+      }
+    }
+  }
+  const int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+  if (devnull < 0) {
+    fail("open /dev/null failed");
+  }
+  while (true) {
+    const ssize_t n = splice(state->drain_fd, nullptr, devnull, nullptr,
+                             kDrainBytes, SPLICE_F_MOVE);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+  }
+  close(devnull);
+}
+
+void zc_setup(Ctx* ctx, Method method) {
+  auto state = std::make_unique<ZcState>();
+  state->method = method;
+  const uint64_t min_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "min_kib", 4)) << 10;
+  const uint64_t max_bytes =
+      std::max<uint64_t>(1, param_u64(*ctx, "max_mib", 16)) << 20;
+  const uint64_t per_octave =
+      std::max<uint64_t>(1, param_u64(*ctx, "per_octave", 1));
+  for (double size = static_cast<double>(min_bytes);
+       size <= static_cast<double>(max_bytes) * 1.0001;
+       size *= std::pow(2.0, 1.0 / static_cast<double>(per_octave))) {
+    const uint64_t bytes = static_cast<uint64_t>(size);
+    if (state->sizes.empty() || state->sizes.back().size != bytes) {
+      state->sizes.push_back(SizeResult{bytes, {}});
+    }
+  }
+  if (state->sizes.empty()) {
+    std::cerr << "zerocopy: min_kib exceeds max_mib\n";
+    std::exit(1);
+  }
+  state->per_size = std::max<uint64_t>(1, ctx->iters / state->sizes.size());
+  const uint64_t largest = state->sizes.back().size;
+  const std::string socket_kind =
+      param_choice(*ctx, "socket", {"unix", "tcp"}, "unix");
+  const std::string dir = param_string(*ctx, "dir", "/var/tmp");
+
+  // vmsplice hands these pages to the pipe, so keep them page aligned.
+  state->buffer = static_cast<char*>(std::aligned_alloc(
+      4096, (largest + 4095) / 4096 * 4096));
+  if (state->buffer == nullptr) {
+    fail("aligned_alloc failed");
+  }
+  std::memset(state->buffer, 0x5a, largest);
+
+  if (from_file(method)) {
+    state->src_fd = create_unlinked(dir, "src");
+    if (state->src_fd < 0) {
+      ctx->skip_reason =
+          "cannot create a file in " + dir + ": " + std::strerror(errno);
+      std::free(state->buffer);
+      return;
+    }
+    state->file_bytes = std::max<uint64_t>(
+        param_u64(*ctx, "file_mib", 64) << 20, largest);
+    for (uint64_t off = 0; off < state->file_bytes; off += largest) {
+      write_full(state->src_fd, state->buffer,
+                 std::min<uint64_t>(largest, state->file_bytes - off));
+    }
+    for (uint64_t off = 0; off < state->file_bytes; off += largest) {
+      if (pread(state->src_fd, state->buffer, largest,
+                static_cast<off_t>(off)) < 0) {
+        fail("pread failed");
+      }
+    }
+  }
+
+  if (to_file(method)) {
+    state->dst_fd = create_unlinked(dir, "dst");
+    if (state->dst_fd < 0) {
+      fail("create destination file failed");
+    }
+    if (method == Method::kCopyFileRange) {
+      loff_t in = 0;
+      loff_t out = 0;
+      if (copy_file_range(state->src_fd, &in, state->dst_fd, &out, 1, 0) <
+          0) {
+        ctx->skip_reason =
+            std::string("copy_file_range failed: ") + std::strerror(errno);
+        close(state->src_fd);
+        close(state->dst_fd);
+        std::free(state->buffer);
+        return;
+      }
+    }
+  } else if (to_socket(method)) {
+    socket_pair(socket_kind, &state->dst_fd, &state->drain_fd);
+  } else {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+      fail("pipe2 failed");
+    }
+    state->drain_fd = fds[0];
+    state->dst_fd = fds[1];
+    grow_pipe(state->dst_fd);
+  }
+  if (method == Method::kSpliceSocket) {
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+      fail("pipe2 failed");
+    }
+    state->splice_r = fds[0];
+    state->splice_w = fds[1];
+    grow_pipe(state->splice_w);
+  }
+
+  if (state->drain_fd >= 0) {
+    const std::vector<int> cpus = thread_cpus(*ctx, 2);
+    std::string error;
+    if (cpus[0] >= 0 && !pin_to_cpu(cpus[0], &error)) {
+      fail("failed to pin to cpu " + std::to_string(cpus[0]) + ": " + error);
+    }
+    ZcState* raw = state.get();
+    if (!start_pinned_thread(
+            cpus[1], [raw]() { drain_loop(raw); }, &state->drainer,
+            &error)) {
+      fail("failed to start drain thread: " + error);
+    }
+  }
+  g_state = std::move(state);
+}
+
+// Moves `len` bytes from the source at `offset` to the destination.
+void transfer(ZcState& state, uint64_t offset, size_t len) {
+  loff_t in = static_cast<loff_t>(offset);
+  loff_t out = static_cast<loff_t>(offset);
+  size_t done = 0;
+  while (done < len) {
+    const size_t want = len - done;
+    ssize_t n = 0;
+    switch (state.method) {
+      case Method::kRwSocket:
+      case Method::kRwFile:
+        n = pread(state.src_fd, state.buffer, want,
+                  static_cast<off_t>(offset + done));
+        if (n > 0 && state.method == Method::kRwSocket) {
+          write_full(state.dst_fd, state.buffer, static_cast<size_t>(n));
+        } else if (n > 0 &&
+                   pwrite(state.dst_fd, state.buffer, static_cast<size_t>(n),
+                          static_cast<off_t>(offset + done)) != n) {
+          fail("pwrite failed");
+        }
+        break;
+      case Method::kSendfileSocket:
+        n = sendfile(state.dst_fd, state.src_fd, &in, want);
+        break;
+      case Method::kSpliceSocket: {
+        n = splice(state.src_fd, &in, state.splice_w, nullptr,
+                   std::min(want, kPipeBytes), SPLICE_F_MOVE);
+        for (ssize_t moved = 0; n > 0 && moved < n;) {
+          const ssize_t m = splice(state.splice_r, nullptr, state.dst_fd,
+                                   nullptr, static_cast<size_t>(n - moved),
+                                   SPLICE_F_MOVE);
+          if (m <= 0) {
+            fail("splice to socket failed");
+          }
+          moved += m;
+        }
+        break;
+      }
+      case Method::kCopyFileRange:
+        n = copy_file_range(state.src_fd, &in, state.dst_fd, &out, want, 0);
+        break;
+      case Method::kWritePipe:
+        n = ::write(state.dst_fd, state.buffer + done, want);
+        break;
+      case Method::kVmsplicePipe: {
+        iovec iov{state.buffer + done, want};
+        n = vmsplice(state.dst_fd, &iov, 1, 0);
+        break;
+      }
+    }
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      fail("transfer failed");
+    }
+    done += static_cast<size_t>(n);
+  }
+}
+
+void zc_run_once(Ctx* ctx) {
+  ZcState& state = *g_state;
+  size_t target = 0;
+  if (!ctx->warming_up) {
+    target = std::min<size_t>(state.measured / state.per_size,
+                              state.sizes.size() - 1);
+  }
+  const size_t bytes = state.sizes[target].size;
+  if (state.offset + bytes > state.file_bytes) {
+    state.offset = 0;
+  }
+
+  const uint64_t start = now_ns();
+  transfer(state, state.offset, bytes);
+  const uint64_t elapsed = now_ns() - start;
+  state.offset += bytes;
+
+  record_sample(ctx, elapsed);
+  if (!ctx->warming_up) {
+    state.sizes[target].ns.push_back(elapsed);
+    ++state.measured;
+  }
+}
+
+uint64_t quantile(const std::vector<uint64_t>& sorted, double p) {
+  const double index = p * static_cast<double>(sorted.size() - 1);
+  return sorted[static_cast<size_t>(index)];
+}
+
+std::string format_sweep(const ZcState& state) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(2);
+  out << "size_bytes,samples,p50_ns,mean_ns,p99_ns,mib_per_sec\n";
+  for (const SizeResult& result : state.sizes) {
+    if (result.ns.empty()) {
+      continue;
+    }
+    std::vector<uint64_t> sorted = result.ns;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0.0;
+    for (uint64_t v : sorted) {
+      sum += static_cast<double>(v);
+    }
+    const double mean = sum / static_cast<double>(sorted.size());
+    out << result.size << "," << sorted.size() << ","
+        << quantile(sorted, 0.50) << "," << mean << ","
+        << quantile(sorted, 0.99) << ","
+        << static_cast<double>(result.size) / (1 << 20) / (mean / 1e9)
+        << "\n";
+  }
+  return out.str();
+}
+
+void zc_teardown(Ctx* ctx) {
+  if (!g_state) {
+    return;
+  }
+  ZcState& state = *g_state;
+  std::string error;
+  if (state.measured > 0 &&
+      !write_artifact(ctx, "sweep.csv", format_sweep(state), &error)) {
+    std::cerr << "zerocopy: failed to write sweep.csv: " << error << "\n";
+  }
+  // Closing the write side ends the drain loop with EOF.
+  if (to_socket(state.method)) {
+    shutdown(state.dst_fd, SHUT_WR);
+  } else if (!to_file(state.method)) {
+    close(state.dst_fd);
+    state.dst_fd = -1;
+  }
+  if (state.drainer.joinable()) {
+    state.drainer.join();
+    restore_affinity(*ctx);
+  }
+  for (int fd : {state.src_fd, state.dst_fd, state.drain_fd, state.splice_r,
+                 state.splice_w}) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+  std::free(state.buffer);
+  g_state.reset();
+}
+
+template <Method M>
+void setup_for(Ctx* ctx) {
+  zc_setup(ctx, M);
+}
+
+const Case kZcRwSocketCase{
+    "zc_rw_socket",
+    setup_for<Method::kRwSocket>,
+    zc_run_once,
+    zc_teardown,
+};
+
+const Case kZcSendfileSocketCase{
+    "zc_sendfile_socket",
+    setup_for<Method::kSendfileSocket>,
+    zc_run_once,
+    zc_teardown,
+};
+
+const Case kZcSpliceSocketCase{
+    "zc_splice_socket",
+    setup_for<Method::kSpliceSocket>,
+    zc_run_once,
+    zc_teardown,
+};
+
+const Case kZcRwFileCase{
+    "zc_rw_file",
+    setup_for<Method::kRwFile>,
+    zc_run_once,
+    zc_teardown,
+};
+
+const Case kZcCopyFileRangeCase{
+    "zc_copy_file_range",
+    setup_for<Method::kCopyFileRange>,
+    zc_run_once,
+    zc_teardown,
+};
+
+const Case kZcWritePipeCase{
+    "zc_write_pipe",
+    setup_for<Method::kWritePipe>,
+    zc_run_once,
+    zc_teardown,
+};
+
+const Case kZcVmsplicePipeCase{
+    "zc_vmsplice_pipe",
+    setup_for<Method::kVmsplicePipe>,
+    zc_run_once,
+    zc_teardown,
+};
+#endif
+
+}  // namespace
+
+#if defined(__linux__)
+LATENCY_LAB_REGISTER_CASE(kZcRwSocketCase);
+LATENCY_LAB_REGISTER_CASE(kZcSendfileSocketCase);
+LATENCY_LAB_REGISTER_CASE(kZcSpliceSocketCase);
+LATENCY_LAB_REGISTER_CASE(kZcRwFileCase);
+LATENCY_LAB_REGISTER_CASE(kZcCopyFileRangeCase);
+LATENCY_LAB_REGISTER_CASE(kZcWritePipeCase);
+LATENCY_LAB_REGISTER_CASE(kZcVmsplicePipeCase);
+#endif
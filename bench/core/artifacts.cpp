@@ -0,0 +1,55 @@
+#include "artifacts.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+bool write_text_file_atomic(const std::string& path,
+                            const std::string& contents,
+                            std::string* error) {
+  const std::string tmp_path = path + ".tmp";
+  std::ofstream out(tmp_path, std::ios::out | std::ios::trunc);
+  if (!out.is_open()) {
+    if (error) {
+      *error = std::strerror(errno);
+    }
+    return false;
+  }
+  out << contents;
+  out.flush();
+  if (!out.good()) {
+    if (error) {
+      *error = "failed to write file";
+    }
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  out.close();
+
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(path.c_str());
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      if (error) {
+        *error = std::strerror(errno);
+      }
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool write_artifact(Ctx* ctx,
+                    const std::string& name,
+                    const std::string& contents,
+                    std::string* error) {
+  const std::filesystem::path dir(ctx->artifact_dir.empty() ? "."
+                                                            : ctx->artifact_dir);
+  if (!write_text_file_atomic((dir / name).string(), contents, error)) {
+    return false;
+  }
+  ctx->artifacts.push_back(name);
+  return true;
+}
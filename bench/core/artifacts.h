@@ -0,0 +1,17 @@
+#pragma once
+
+#include "case.h"
+
+#include <string>
+
+// Write-to-temp + rename so readers never see a truncated file.
+bool write_text_file_atomic(const std::string& path,
+                            const std::string& contents,
+                            std::string* error);
+
+// Write an extra per-run file (e.g. matrix.csv) into ctx->artifact_dir and
+// record its name in ctx->artifacts so it is listed in meta.json.
+bool write_artifact(Ctx* ctx,
+                    const std::string& name,
+                    const std::string& contents,
+                    std::string* error);
@@ -1,12 +1,60 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
 // Shared context passed between setup/run/teardown for a case.
 // This will grow as the harness adds common helpers.
-struct Ctx {};
+struct Ctx {
+  // Run settings copied from the CLI so cases can size their own state.
+  uint64_t iters = 0;
+  uint64_t warmup = 0;
+  // --pin CPU (-1 when unpinned) and the affinity mask from before pinning,
+  // for cases that place helper threads or processes on other CPUs.
+  int pin_cpu = -1;
+  std::vector<int> allowed_cpus;
+  // True while the harness is running warmup iterations.
+  bool warming_up = false;
+  // Directory for extra per-run files such as matrix.csv (see artifacts.h).
+  std::string artifact_dir;
+  // Repeated --param key=value flags in command-line order (see params.h).
+  std::vector<std::pair<std::string, std::string>> params;
+
+  // Cases that time their own operation (to keep per-sample bookkeeping out
+  // of the timed region) set these in run_once(); the harness then records
+  // sample_ns instead of the wall time around the call. Such cases should
+  // leave batch at 1.
+  bool has_sample = false;
+  uint64_t sample_ns = 0;
+
+  // Set in setup() when the case cannot run on this host. The harness skips
+  // measurement and records the reason in meta.json.
+  std::string skip_reason;
+  // Artifact file names written for this run, recorded in meta.json.
+  std::vector<std::string> artifacts;
+  // Derived per-run figures (e.g. throughput), usually set in teardown().
+  // Printed after the quantiles and recorded in meta.json under "metrics".
+  std::vector<std::pair<std::string, double>> metrics;
+};
+
+inline void record_sample(Ctx* ctx, uint64_t ns) {
+  ctx->has_sample = true;
+  ctx->sample_ns = ns;
+}
+
+inline void record_metric(Ctx* ctx, const std::string& name, double value) {
+  ctx->metrics.emplace_back(name, value);
+}
 
 struct Case {
   const char* name = nullptr;
   void (*setup)(Ctx*) = nullptr;
   void (*run_once)(Ctx*) = nullptr;
   void (*teardown)(Ctx*) = nullptr;
+  // Number of run_once() calls per timed sample. Cheap operations (syscalls,
+  // vDSO calls) set this above 1 so the per-call cost rises above timer
+  // overhead; each recorded sample is then the per-call average of the batch.
+  uint32_t batch = 1;
 };
@@ -0,0 +1,56 @@
+#include "chase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+constexpr size_t kLineBytes = 64;
+
+char* node_address(char* base, size_t index, const ChaseLayout& layout) {
+  char* node = base + index * layout.stride;
+  if (layout.spread_lines) {
+    node += (index % (layout.stride / kLineBytes)) * kLineBytes;
+  }
+  return node;
+}
+
+}  // namespace
+
+void** build_chase(char* base,
+                   size_t nodes,
+                   const ChaseLayout& layout,
+                   uint64_t seed) {
+  std::vector<uint32_t> order(nodes);
+  for (size_t i = 0; i < nodes; ++i) {
+    order[i] = static_cast<uint32_t>(i);
+  }
+  std::mt19937_64 rng(seed);
+  for (size_t i = nodes - 1; i > 0; --i) {
+    std::uniform_int_distribution<size_t> pick(0, i - 1);
+    std::swap(order[i], order[pick(rng)]);
+  }
+  for (size_t i = 0; i < nodes; ++i) {
+    void** node = reinterpret_cast<void**>(node_address(base, i, layout));
+    *node = node_address(base, order[i], layout);
+  }
+  return reinterpret_cast<void**>(node_address(base, 0, layout));
+}
+
+std::vector<uint64_t> chase_sizes(uint64_t min_bytes,
+                                  uint64_t max_bytes,
+                                  uint64_t per_octave,
+                                  size_t granule) {
+  std::vector<uint64_t> sizes;
+  for (double size = static_cast<double>(min_bytes);
+       size <= static_cast<double>(max_bytes) * 1.0001;
+       size *= std::pow(2.0, 1.0 / static_cast<double>(per_octave))) {
+    uint64_t bytes = static_cast<uint64_t>(size) / granule * granule;
+    bytes = std::max<uint64_t>(bytes, 2 * granule);
+    if (sizes.empty() || sizes.back() != bytes) {
+      sizes.push_back(bytes);
+    }
+  }
+  return sizes;
+}
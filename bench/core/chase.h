@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pointer chasing for load-latency cases (mem_pointer_chase, tlb_*): nodes
+// linked in one random cycle, so every load depends on the previous one and
+// prefetchers cannot guess the next address.
+
+// Where node i lives: base + i * stride, plus (i % (stride / 64)) cache lines
+// when spread_lines is set, so one-node-per-page layouts do not all map to
+// the same cache set.
+struct ChaseLayout {
+  size_t stride = 64;
+  bool spread_lines = false;
+};
+
+// Link `nodes` (at least 2) slots of `base` into a single cycle (Sattolo's
+// algorithm, seeded by `seed`) and return the first node.
+void** build_chase(char* base,
+                   size_t nodes,
+                   const ChaseLayout& layout,
+                   uint64_t seed);
+
+// Follow the chain for `steps` dependent loads.
+inline void** chase(void** p, uint64_t steps) {
+  for (uint64_t i = 0; i < steps; ++i) {
+    p = static_cast<void**>(*p);
+  }
+  return p;
+}
+
+// Working-set sizes from min_bytes to max_bytes, `per_octave` per doubling,
+// rounded down to whole `granule`s (at least two) and de-duplicated.
+std::vector<uint64_t> chase_sizes(uint64_t min_bytes,
+                                  uint64_t max_bytes,
+                                  uint64_t per_octave,
+                                  size_t granule);
@@ -134,6 +134,19 @@ CliParseResult parse_cli_args(int argc, char** argv) {
         return result;
       }
       result.options.warmup = value;
+    } else if (arg == "--batch") {
+      if (i + 1 >= argc) {
+        result.ok = false;
+        result.error = "--batch requires a number";
+        return result;
+      }
+      uint64_t value = 0;
+      if (!parse_u64_strict(argv[++i], &value) || value == 0) {
+        result.ok = false;
+        result.error = "--batch expects a positive integer";
+        return result;
+      }
+      result.options.batch = value;
     } else if (arg == "--pin") {
       if (i + 1 >= argc) {
         result.ok = false;
@@ -173,6 +186,21 @@ CliParseResult parse_cli_args(int argc, char** argv) {
         return result;
       }
       result.options.tags.push_back(argv[++i]);
+    } else if (arg == "--param") {
+      if (i + 1 >= argc) {
+        result.ok = false;
+        result.error = "--param requires key=value";
+        return result;
+      }
+      const std::string param = argv[++i];
+      const auto eq = param.find('=');
+      if (eq == std::string::npos || eq == 0) {
+        result.ok = false;
+        result.error = "--param expects key=value";
+        return result;
+      }
+      result.options.params.emplace_back(param.substr(0, eq),
+                                         param.substr(eq + 1));
     } else if (arg == "--summary-format") {
       if (i + 1 >= argc) {
         result.ok = false;
@@ -186,6 +214,8 @@ CliParseResult parse_cli_args(int argc, char** argv) {
         return result;
       }
       result.options.summary_format = format;
+    } else if (arg == "--raw-bin") {
+      result.options.raw_bin = true;
     } else if (arg == "--help" || arg == "-h") {
       result.show_help = true;
       return result;
@@ -222,7 +252,7 @@ CliParseResult parse_cli_args(int argc, char** argv) {
 void print_usage(const char* argv0, std::ostream& out) {
   out << "usage: " << argv0
       << " [--list] [--case name] [--out dir] [--iters N] [--warmup N]"
-         " [--pin cpu] [--noise off|free|same|other] [--tag label]"
-         " [--summary-format human|csv]"
+         " [--batch N] [--pin cpu] [--noise off|free|same|other] [--tag label]"
+         " [--param key=value] [--summary-format human|csv] [--raw-bin]"
          " [out.csv] [iters] [warmup]\n";
 }
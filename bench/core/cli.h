@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 enum class SummaryFormat {
@@ -19,6 +20,8 @@ struct CliOptions {
   std::string out_path = "raw.csv";
   uint64_t iters = 10000;
   uint64_t warmup = 1000;
+  // 0 keeps the case's own batch size; see Case::batch.
+  uint64_t batch = 0;
   std::string case_name;
   bool list_cases = false;
   bool pin_enabled = false;
@@ -26,7 +29,11 @@ struct CliOptions {
   NoiseMode noise_mode = NoiseMode::kOff;
   // Tags are captured for metadata; harness does not interpret them yet.
   std::vector<std::string> tags;
+  // Case parameters from repeated --param key=value; cases interpret them.
+  std::vector<std::pair<std::string, std::string>> params;
   SummaryFormat summary_format = SummaryFormat::kHuman;
+  // Also write raw.bin (mmap-able samples) next to raw.csv.
+  bool raw_bin = false;
 };
 
 // Parse result bundles options with simple status flags for main().
@@ -2,10 +2,14 @@
 
 #include "build_info.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <thread>
 
@@ -65,6 +69,27 @@ uint32_t read_cpu_cores() {
   return cores;
 }
 
+std::vector<std::pair<std::string, std::string>> read_cpu_mitigations() {
+  std::vector<std::pair<std::string, std::string>> out;
+  const std::filesystem::path dir("/sys/devices/system/cpu/vulnerabilities");
+  std::error_code ec;
+  std::filesystem::directory_iterator it(dir, ec);
+  if (ec) {
+    return out;
+  }
+  for (const auto& entry : it) {
+    std::ifstream in(entry.path());
+    std::string status;
+    if (!in.is_open() || !std::getline(in, status)) {
+      continue;
+    }
+    out.emplace_back(entry.path().filename().string(), trim_copy(status));
+  }
+  // Directory order is unspecified; sort so runs diff cleanly.
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
 std::string read_kernel_version() {
 #if defined(__unix__) || defined(__APPLE__)
   struct utsname info;
@@ -141,6 +166,16 @@ std::string json_escape(const std::string& text) {
   return out.str();
 }
 
+// JSON has no NaN/Inf; emit null rather than an unparseable file.
+std::string format_json_number(double value) {
+  if (!std::isfinite(value)) {
+    return "null";
+  }
+  std::ostringstream out;
+  out << std::setprecision(17) << value;
+  return out.str();
+}
+
 bool write_text_atomic(const std::string& path,
                        const std::string& contents,
                        std::string* error) {
@@ -206,6 +241,7 @@ RunMetadata collect_system_metadata() {
   meta.kernel_version = read_kernel_version();
   meta.compiler_version = compiler_version();
   meta.build_flags = build_flags();
+  meta.cpu_mitigations = read_cpu_mitigations();
   return meta;
 }
 
@@ -232,6 +268,19 @@ bool write_meta_json(const std::string& path,
   out << "  \"compiler_version\": \""
       << json_escape(meta.compiler_version) << "\",\n";
   out << "  \"build_flags\": \"" << json_escape(meta.build_flags) << "\",\n";
+  out << "  \"cpu_mitigations\": {";
+  for (size_t i = 0; i < meta.cpu_mitigations.size(); ++i) {
+    if (i > 0) {
+      out << ",";
+    }
+    out << "\n    \"" << json_escape(meta.cpu_mitigations[i].first) << "\": \""
+        << json_escape(meta.cpu_mitigations[i].second) << "\"";
+  }
+  if (!meta.cpu_mitigations.empty()) {
+    out << "\n  ";
+  }
+  out << "},\n";
+  out << "  \"batch\": " << meta.batch << ",\n";
   out << "  \"pinning\": " << (meta.pinning ? "true" : "false") << ",\n";
   if (meta.pinning) {
     out << "  \"pinned_cpu\": " << meta.pinned_cpu << ",\n";
@@ -246,7 +295,37 @@ bool write_meta_json(const std::string& path,
     }
     out << "\"" << json_escape(meta.tags[i]) << "\"";
   }
-  out << "]\n";
+  out << "],\n";
+  out << "  \"params\": {";
+  for (size_t i = 0; i < meta.params.size(); ++i) {
+    if (i > 0) {
+      out << ", ";
+    }
+    out << "\"" << json_escape(meta.params[i].first) << "\": \""
+        << json_escape(meta.params[i].second) << "\"";
+  }
+  out << "},\n";
+  out << "  \"artifacts\": [";
+  for (size_t i = 0; i < meta.artifacts.size(); ++i) {
+    if (i > 0) {
+      out << ", ";
+    }
+    out << "\"" << json_escape(meta.artifacts[i]) << "\"";
+  }
+  out << "],\n";
+  out << "  \"metrics\": {";
+  for (size_t i = 0; i < meta.metrics.size(); ++i) {
+    if (i > 0) {
+      out << ", ";
+    }
+    out << "\"" << json_escape(meta.metrics[i].first) << "\": "
+        << format_json_number(meta.metrics[i].second);
+  }
+  out << "},\n";
+  if (meta.skipped) {
+    out << "  \"skip_reason\": \"" << json_escape(meta.skip_reason) << "\",\n";
+  }
+  out << "  \"skipped\": " << (meta.skipped ? "true" : "false") << "\n";
   out << "}\n";
 
   return write_text_atomic(path, out.str(), error);
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 struct RunMetadata {
@@ -11,12 +12,22 @@ struct RunMetadata {
   std::string command_line;
   std::string compiler_version;
   std::string build_flags;
+  // Entries from /sys/devices/system/cpu/vulnerabilities (name -> status).
+  // Syscall-entry cost depends heavily on which mitigations are active.
+  std::vector<std::pair<std::string, std::string>> cpu_mitigations;
+  uint64_t batch = 1;
   bool pinning = false;
   int pinned_cpu = -1;
   bool noise = false;
   std::string noise_mode = "off";
   int noise_cpu = -1;
   std::vector<std::string> tags;
+  std::vector<std::pair<std::string, std::string>> params;
+  // Extra files the case wrote next to raw.csv (e.g. matrix.csv).
+  std::vector<std::string> artifacts;
+  std::vector<std::pair<std::string, double>> metrics;
+  bool skipped = false;
+  std::string skip_reason;
 };
 
 RunMetadata collect_system_metadata();
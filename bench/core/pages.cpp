@@ -0,0 +1,186 @@
+#include "pages.h"
+
+#include "params.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << 26)
+#endif
+
+namespace {
+
+std::string read_first_line(const std::string& path) {
+  std::ifstream in(path);
+  std::string line;
+  std::getline(in, line);
+  return line;
+}
+
+}  // namespace
+
+bool page_mode_param(Ctx* ctx, PageMode* mode) {
+  const std::string choice = param_choice(
+      *ctx, "hugepages", {"off", "thp", "hugetlb", "hugetlb_1g"}, "off");
+  if (choice == "off") {
+    *mode = PageMode::kSmall;
+    return true;
+  }
+#if defined(__linux__)
+  if (choice == "thp") {
+    *mode = PageMode::kThp;
+    const std::string enabled =
+        read_first_line("/sys/kernel/mm/transparent_hugepage/enabled");
+    if (enabled.empty() || enabled.find("[never]") != std::string::npos) {
+      ctx->skip_reason = "transparent huge pages are disabled";
+      return false;
+    }
+    return true;
+  }
+  *mode = choice == "hugetlb" ? PageMode::kHugetlb : PageMode::kHugetlb1G;
+  std::string error;
+  void* probe = map_pages(page_bytes(*mode), *mode, false, &error);
+  if (probe == nullptr) {
+    ctx->skip_reason =
+        error + (*mode == PageMode::kHugetlb
+                     ? " (reserve pages via /proc/sys/vm/nr_hugepages)"
+                     : " (reserve pages via /sys/kernel/mm/hugepages/"
+                       "hugepages-1048576kB/nr_hugepages)");
+    return false;
+  }
+  unmap_pages(probe, page_bytes(*mode), *mode);
+  return true;
+#else
+  ctx->skip_reason = "hugepages=" + choice + " needs Linux";
+  return false;
+#endif
+}
+
+size_t page_bytes(PageMode mode) {
+  switch (mode) {
+    case PageMode::kSmall:
+      return kSmallPageBytes;
+    case PageMode::kThp:
+    case PageMode::kHugetlb:
+      return kHugePageBytes;
+    case PageMode::kHugetlb1G:
+      return kGiantPageBytes;
+  }
+  return kSmallPageBytes;
+}
+
+size_t page_round_up(size_t bytes, PageMode mode) {
+  const size_t page = page_bytes(mode);
+  return (bytes + page - 1) / page * page;
+}
+
+size_t hugetlb_free_bytes(PageMode mode) {
+  if (mode != PageMode::kHugetlb && mode != PageMode::kHugetlb1G) {
+    return 0;
+  }
+  const std::string pool = mode == PageMode::kHugetlb
+                               ? "hugepages-2048kB"
+                               : "hugepages-1048576kB";
+  const std::string line = read_first_line("/sys/kernel/mm/hugepages/" + pool +
+                                           "/free_hugepages");
+  return static_cast<size_t>(std::strtoull(line.c_str(), nullptr, 10)) *
+         page_bytes(mode);
+}
+
+#if defined(__linux__)
+namespace {
+
+// Fault in the range after the page-size advice is in place; kernels before
+// 5.14 lack MADV_POPULATE_WRITE, so fall back to touching every page.
+void prefault(void* addr, size_t bytes) {
+  if (madvise(addr, bytes, MADV_POPULATE_WRITE) != 0) {
+    for (size_t off = 0; off < bytes; off += kSmallPageBytes) {
+      static_cast<volatile char*>(addr)[off] = 0;
+    }
+  }
+}
+
+}  // namespace
+
+void* map_pages(size_t bytes,
+                PageMode mode,
+                bool populate,
+                std::string* error) {
+  bytes = page_round_up(bytes, mode);
+  const int prot = PROT_READ | PROT_WRITE;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  if (mode == PageMode::kHugetlb || mode == PageMode::kHugetlb1G) {
+    if (mode == PageMode::kHugetlb1G) {
+      flags |= MAP_HUGE_1GB;
+    }
+    void* addr = mmap(nullptr, bytes, prot,
+                      flags | MAP_HUGETLB | (populate ? MAP_POPULATE : 0), -1,
+                      0);
+    if (addr == MAP_FAILED) {
+      *error = std::string("MAP_HUGETLB failed: ") + std::strerror(errno);
+      return nullptr;
+    }
+    return addr;
+  }
+  if (mode == PageMode::kSmall) {
+    // No MAP_POPULATE: with THP enabled=always it would fault in huge pages
+    // before the NOHUGEPAGE advice could apply.
+    void* addr = mmap(nullptr, bytes, prot, flags, -1, 0);
+    if (addr == MAP_FAILED) {
+      *error = std::string("mmap failed: ") + std::strerror(errno);
+      return nullptr;
+    }
+    madvise(addr, bytes, MADV_NOHUGEPAGE);
+    if (populate) {
+      prefault(addr, bytes);
+    }
+    return addr;
+  }
+
+  // THP: over-map and trim so the range starts on a huge page boundary.
+  const size_t span = bytes + kHugePageBytes;
+  void* raw = mmap(nullptr, span, prot, flags, -1, 0);
+  if (raw == MAP_FAILED) {
+    *error = std::string("mmap failed: ") + std::strerror(errno);
+    return nullptr;
+  }
+  const uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+  const uintptr_t aligned =
+      (base + kHugePageBytes - 1) & ~uintptr_t{kHugePageBytes - 1};
+  if (aligned > base) {
+    munmap(raw, aligned - base);
+  }
+  const uintptr_t end = aligned + bytes;
+  if (base + span > end) {
+    munmap(reinterpret_cast<void*>(end), base + span - end);
+  }
+  void* addr = reinterpret_cast<void*>(aligned);
+  madvise(addr, bytes, MADV_HUGEPAGE);
+  if (populate) {
+    prefault(addr, bytes);
+  }
+  return addr;
+}
+
+void unmap_pages(void* addr, size_t bytes, PageMode mode) {
+  munmap(addr, page_round_up(bytes, mode));
+}
+#else
+void* map_pages(size_t, PageMode, bool, std::string* error) {
+  *error = "anonymous mappings need Linux";
+  return nullptr;
+}
+
+void unmap_pages(void*, size_t, PageMode) {}
+#endif
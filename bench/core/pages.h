@@ -0,0 +1,45 @@
+#pragma once
+
+#include "case.h"
+
+#include <cstddef>
+#include <string>
+
+// Anonymous mappings with a chosen page size, for the VM/TLB cases.
+// Param:
+//   hugepages=off|thp|hugetlb|hugetlb_1g
+//                               4 KiB pages with THP disabled for the mapping
+//                               (default), MADV_HUGEPAGE, MAP_HUGETLB (2 MiB),
+//                               or MAP_HUGETLB | MAP_HUGE_1GB
+enum class PageMode {
+  kSmall,
+  kThp,
+  kHugetlb,
+  kHugetlb1G,
+};
+
+constexpr size_t kSmallPageBytes = 4096;
+constexpr size_t kHugePageBytes = 2u << 20;
+constexpr size_t kGiantPageBytes = 1u << 30;
+
+// Parse hugepages=. Returns false with ctx->skip_reason set when the mode is
+// unusable here (THP disabled system-wide, or no hugetlb pages of the
+// requested size reserved).
+bool page_mode_param(Ctx* ctx, PageMode* mode);
+size_t page_bytes(PageMode mode);
+// Rounded up to a whole number of pages.
+size_t page_round_up(size_t bytes, PageMode mode);
+// Bytes left in the reserved hugetlb pool for a hugetlb mode (free_hugepages
+// x page size); 0 for other modes or when sysfs cannot be read.
+size_t hugetlb_free_bytes(PageMode mode);
+
+// Map `bytes` (rounded up to the page size). THP mappings are 2 MiB aligned
+// so every huge page can be backed. `populate` prefaults the whole range
+// (MAP_POPULATE for hugetlb; otherwise MADV_POPULATE_WRITE after the THP
+// advice, so 4 KiB mappings stay 4 KiB). Returns nullptr with *error set on
+// failure.
+void* map_pages(size_t bytes,
+                PageMode mode,
+                bool populate,
+                std::string* error);
+void unmap_pages(void* addr, size_t bytes, PageMode mode);
@@ -0,0 +1,171 @@
+#include "params.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+[[noreturn]] void fail_param(const std::string& key,
+                             const std::string& value,
+                             const char* expected) {
+  std::cerr << "invalid --param " << key << "=" << value << " (expected "
+            << expected << ")\n";
+  std::exit(1);
+}
+
+bool parse_u64_text(const std::string& text, uint64_t* value) {
+  if (text.empty() || text[0] == '-') {
+    return false;
+  }
+  char* end = nullptr;
+  const unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+  if (!end || *end != '\0') {
+    return false;
+  }
+  *value = static_cast<uint64_t>(parsed);
+  return true;
+}
+
+}  // namespace
+
+const std::string* find_param(const Ctx& ctx, const std::string& key) {
+  const std::string* found = nullptr;
+  for (const auto& entry : ctx.params) {
+    if (entry.first == key) {
+      found = &entry.second;
+    }
+  }
+  return found;
+}
+
+std::string param_string(const Ctx& ctx,
+                         const std::string& key,
+                         const std::string& fallback) {
+  const std::string* value = find_param(ctx, key);
+  return value ? *value : fallback;
+}
+
+uint64_t param_u64(const Ctx& ctx, const std::string& key, uint64_t fallback) {
+  const std::string* value = find_param(ctx, key);
+  if (!value) {
+    return fallback;
+  }
+  uint64_t parsed = 0;
+  if (!parse_u64_text(*value, &parsed)) {
+    fail_param(key, *value, "an unsigned integer");
+  }
+  return parsed;
+}
+
+std::vector<uint64_t> param_u64_list(const Ctx& ctx, const std::string& key) {
+  std::vector<uint64_t> values;
+  const std::string* value = find_param(ctx, key);
+  if (!value) {
+    return values;
+  }
+  size_t pos = 0;
+  while (pos <= value->size()) {
+    const size_t comma = std::min(value->find(',', pos), value->size());
+    const std::string item = value->substr(pos, comma - pos);
+    const size_t dash = item.find('-');
+    uint64_t first = 0;
+    uint64_t last = 0;
+    if (dash == std::string::npos) {
+      if (!parse_u64_text(item, &first)) {
+        fail_param(key, *value, "a list of unsigned integers like 1,4,16");
+      }
+      last = first;
+    } else if (!parse_u64_text(item.substr(0, dash), &first) ||
+               !parse_u64_text(item.substr(dash + 1), &last) || last < first) {
+      fail_param(key, *value, "a list of unsigned integers like 1,4,16");
+    }
+    for (uint64_t n = first; n <= last; ++n) {
+      values.push_back(n);
+      if (n == UINT64_MAX) {
+        break;
+      }
+    }
+    pos = comma + 1;
+  }
+  return values;
+}
+
+bool param_bool(const Ctx& ctx, const std::string& key, bool fallback) {
+  const std::string* value = find_param(ctx, key);
+  if (!value) {
+    return fallback;
+  }
+  if (*value == "1" || *value == "true" || *value == "on" || *value == "yes") {
+    return true;
+  }
+  if (*value == "0" || *value == "false" || *value == "off" || *value == "no") {
+    return false;
+  }
+  fail_param(key, *value, "true/false");
+}
+
+std::string param_choice(const Ctx& ctx,
+                         const std::string& key,
+                         const std::vector<std::string>& choices,
+                         const std::string& fallback) {
+  const std::string* value = find_param(ctx, key);
+  if (!value) {
+    return fallback;
+  }
+  if (std::find(choices.begin(), choices.end(), *value) == choices.end()) {
+    std::string expected = "one of";
+    for (size_t i = 0; i < choices.size(); ++i) {
+      expected += (i == 0 ? " " : "|") + choices[i];
+    }
+    fail_param(key, *value, expected.c_str());
+  }
+  return *value;
+}
+
+std::vector<int> param_cpu_list(const Ctx& ctx, const std::string& key) {
+  std::vector<int> cpus;
+  const std::string* value = find_param(ctx, key);
+  if (!value) {
+    return cpus;
+  }
+  if (!parse_cpu_list(*value, &cpus)) {
+    fail_param(key, *value, "a cpu list like 0,2,4-7");
+  }
+  return cpus;
+}
+
+bool parse_cpu_list(const std::string& text, std::vector<int>* cpus) {
+  if (!cpus || text.empty()) {
+    return false;
+  }
+  std::vector<int> out;
+  size_t pos = 0;
+  while (pos <= text.size()) {
+    const size_t comma = std::min(text.find(',', pos), text.size());
+    const std::string item = text.substr(pos, comma - pos);
+    const size_t dash = item.find('-');
+    uint64_t first = 0;
+    uint64_t last = 0;
+    if (dash == std::string::npos) {
+      if (!parse_u64_text(item, &first)) {
+        return false;
+      }
+      last = first;
+    } else if (!parse_u64_text(item.substr(0, dash), &first) ||
+               !parse_u64_text(item.substr(dash + 1), &last) || last < first) {
+      return false;
+    }
+    if (last > 4095) {
+      return false;
+    }
+    for (uint64_t cpu = first; cpu <= last; ++cpu) {
+      out.push_back(static_cast<int>(cpu));
+    }
+    pos = comma + 1;
+  }
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+  *cpus = out;
+  return true;
+}
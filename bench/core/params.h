@@ -0,0 +1,30 @@
+#pragma once
+
+#include "case.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Typed lookups over Ctx::params (from --param key=value). Missing keys return
+// the fallback; when a key repeats, the last value wins. Malformed values are
+// a configuration error: they are reported on stderr and the process exits,
+// the same way case setup handles other fatal problems.
+const std::string* find_param(const Ctx& ctx, const std::string& key);
+std::string param_string(const Ctx& ctx,
+                         const std::string& key,
+                         const std::string& fallback);
+uint64_t param_u64(const Ctx& ctx, const std::string& key, uint64_t fallback);
+// Sweep values: "1,4,16" or ranges like "1-8", kept in the order given
+// (duplicates too). Missing -> empty.
+std::vector<uint64_t> param_u64_list(const Ctx& ctx, const std::string& key);
+bool param_bool(const Ctx& ctx, const std::string& key, bool fallback);
+// Enumerated value; anything outside `choices` is a configuration error.
+std::string param_choice(const Ctx& ctx,
+                         const std::string& key,
+                         const std::vector<std::string>& choices,
+                         const std::string& fallback);
+// CPU lists use the kernel's cpulist syntax: "0,2,4-7". Missing -> empty.
+std::vector<int> param_cpu_list(const Ctx& ctx, const std::string& key);
+
+bool parse_cpu_list(const std::string& text, std::vector<int>* cpus);
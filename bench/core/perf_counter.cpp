@@ -0,0 +1,67 @@
+#include "perf_counter.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#if defined(__linux__)
+namespace {
+
+uint64_t event_config(PerfEvent event) {
+  switch (event) {
+    case PerfEvent::kDtlbLoadMisses:
+      return PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  }
+  return 0;
+}
+
+}  // namespace
+
+PerfCounter::~PerfCounter() {
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+bool PerfCounter::open(PerfEvent event, std::string* error) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HW_CACHE;
+  attr.config = event_config(event);
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0) {
+    *error = std::string("perf_event_open failed: ") + std::strerror(errno);
+    return false;
+  }
+  fd_ = static_cast<int>(fd);
+  return true;
+}
+
+uint64_t PerfCounter::read() const {
+  uint64_t value = 0;
+  if (fd_ < 0 || ::read(fd_, &value, sizeof(value)) != sizeof(value)) {
+    return 0;
+  }
+  return value;
+}
+#else
+PerfCounter::~PerfCounter() = default;
+
+bool PerfCounter::open(PerfEvent, std::string* error) {
+  *error = "hardware counters need Linux";
+  return false;
+}
+
+uint64_t PerfCounter::read() const {
+  return 0;
+}
+#endif
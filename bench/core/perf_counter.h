@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// One user-space hardware counter on the calling thread (perf_event_open).
+// Counting starts at open() and never stops; callers read() before and after
+// the region of interest, outside their timed window. Setup-time open; a
+// failure (no PMU in a VM, perf_event_paranoid too high) leaves the counter
+// unavailable with *error set, and cases report the figure as missing.
+enum class PerfEvent {
+  kDtlbLoadMisses,
+};
+
+class PerfCounter {
+ public:
+  PerfCounter() = default;
+  ~PerfCounter();
+  PerfCounter(const PerfCounter&) = delete;
+  PerfCounter& operator=(const PerfCounter&) = delete;
+
+  bool open(PerfEvent event, std::string* error);
+  bool available() const { return fd_ >= 0; }
+  // Running count; 0 when unavailable.
+  uint64_t read() const;
+
+ private:
+  int fd_ = -1;
+};
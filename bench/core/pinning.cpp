@@ -8,25 +8,38 @@
 #endif
 
 bool pin_to_cpu(int cpu, std::string* error) {
+  return pin_to_cpus(std::vector<int>{cpu}, error);
+}
+
+bool pin_to_cpus(const std::vector<int>& cpus, std::string* error) {
 #if defined(__linux__)
-  // Validate against the build-time CPU bitmap size.
-  if (cpu < 0) {
+  if (cpus.empty()) {
     if (error) {
-      *error = "cpu index must be >= 0";
+      *error = "cpu set must not be empty";
     }
     return false;
   }
-  if (cpu >= CPU_SETSIZE) {
-    if (error) {
-      *error = "cpu index is out of range for this build";
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    // Validate against the build-time CPU bitmap size.
+    if (cpu < 0) {
+      if (error) {
+        *error = "cpu index must be >= 0";
+      }
+      return false;
     }
-    return false;
+    if (cpu >= CPU_SETSIZE) {
+      if (error) {
+        *error = "cpu index is out of range for this build";
+      }
+      return false;
+    }
+    CPU_SET(cpu, &set);
   }
 
   // Apply affinity to the current thread/process.
-  cpu_set_t set;
-  CPU_ZERO(&set);
-  CPU_SET(cpu, &set);
   if (sched_setaffinity(0, sizeof(set), &set) != 0) {
     if (error) {
       *error = std::strerror(errno);
@@ -36,9 +49,34 @@ bool pin_to_cpu(int cpu, std::string* error) {
 
   return true;
 #else
+  (void)cpus;
   if (error) {
     *error = "cpu pinning is only supported on Linux";
   }
   return false;
 #endif
 }
+
+std::vector<int> allowed_cpus(std::string* error) {
+  std::vector<int> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    if (error) {
+      *error = std::strerror(errno);
+    }
+    return cpus;
+  }
+  for (int i = 0; i < CPU_SETSIZE; ++i) {
+    if (CPU_ISSET(i, &set)) {
+      cpus.push_back(i);
+    }
+  }
+#else
+  if (error) {
+    *error = "cpu affinity is only supported on Linux";
+  }
+#endif
+  return cpus;
+}
@@ -1,7 +1,14 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 // Best-effort CPU pinning. Returns false with a human-readable error on failure.
 // Keeping this separate from the harness keeps main() focused on benchmarking.
+// Affinity applies to the calling thread, so worker threads can pin themselves.
 bool pin_to_cpu(int cpu, std::string* error);
+bool pin_to_cpus(const std::vector<int>& cpus, std::string* error);
+
+// CPUs in the calling thread's affinity mask, ascending. This respects
+// taskset/cgroup restrictions, unlike the online CPU count.
+std::vector<int> allowed_cpus(std::string* error);
@@ -0,0 +1,96 @@
+#include "placement.h"
+
+#include "params.h"
+#include "pinning.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+bool setup_placement(Ctx* ctx, Placement* placement) {
+  placement->mode =
+      param_choice(*ctx, "placement", {"cross", "same", "none"}, "cross");
+  if (placement->mode == "none") {
+    return true;
+  }
+
+  const std::vector<int>& allowed = ctx->allowed_cpus;
+  if (ctx->pin_cpu >= 0) {
+    placement->self_cpu = ctx->pin_cpu;
+  } else if (!allowed.empty()) {
+    placement->self_cpu = allowed.front();
+  } else {
+    ctx->skip_reason = "no cpus in the affinity mask";
+    return false;
+  }
+
+  if (placement->mode == "same") {
+    placement->peer_cpu = placement->self_cpu;
+  } else {
+    const uint64_t peer = param_u64(*ctx, "peer_cpu", UINT64_MAX);
+    if (peer != UINT64_MAX) {
+      placement->peer_cpu = static_cast<int>(peer);
+    } else {
+      // Next allowed CPU after ours, wrapping around.
+      for (int cpu : allowed) {
+        if (cpu > placement->self_cpu) {
+          placement->peer_cpu = cpu;
+          break;
+        }
+      }
+      if (placement->peer_cpu < 0 && !allowed.empty() &&
+          allowed.front() != placement->self_cpu) {
+        placement->peer_cpu = allowed.front();
+      }
+    }
+    if (placement->peer_cpu < 0 || placement->peer_cpu == placement->self_cpu) {
+      ctx->skip_reason = "placement=cross needs a second cpu";
+      return false;
+    }
+  }
+
+  std::string error;
+  if (!pin_to_cpu(placement->self_cpu, &error)) {
+    std::cerr << "failed to pin to cpu " << placement->self_cpu << ": " << error
+              << "\n";
+    std::exit(1);
+  }
+  return true;
+}
+
+void restore_placement(const Ctx& ctx, const Placement& placement) {
+  if (placement.self_cpu < 0 || ctx.pin_cpu >= 0 || ctx.allowed_cpus.empty()) {
+    return;
+  }
+  std::string error;
+  if (!pin_to_cpus(ctx.allowed_cpus, &error)) {
+    std::cerr << "failed to restore affinity: " << error << "\n";
+  }
+}
+
+std::vector<int> thread_cpus(const Ctx& ctx, size_t count) {
+  std::vector<int> cpus = param_cpu_list(ctx, "cpus");
+  if (cpus.empty()) {
+    cpus = ctx.allowed_cpus;
+    const auto pinned = std::find(cpus.begin(), cpus.end(), ctx.pin_cpu);
+    if (pinned != cpus.end()) {
+      std::rotate(cpus.begin(), pinned, cpus.end());
+    }
+  }
+  std::vector<int> out(count, -1);
+  if (!cpus.empty()) {
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = cpus[i % cpus.size()];
+    }
+  }
+  return out;
+}
+
+void restore_affinity(const Ctx& ctx) {
+  const std::vector<int> restore =
+      ctx.pin_cpu >= 0 ? std::vector<int>{ctx.pin_cpu} : ctx.allowed_cpus;
+  std::string error;
+  if (!restore.empty() && !pin_to_cpus(restore, &error)) {
+    std::cerr << "failed to restore affinity: " << error << "\n";
+  }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "case.h"
+
+#include <string>
+#include <vector>
+
+// Two-party CPU placement for ping-pong style cases (bench thread + peer).
+// Params:
+//   placement=cross  bench thread and peer on different CPUs (default)
+//   placement=same   both on one CPU
+//   placement=none   no pinning
+//   peer_cpu=<cpu>   explicit peer CPU (cross only)
+// The bench thread keeps --pin's CPU when given, else the first allowed CPU.
+struct Placement {
+  std::string mode = "cross";
+  int self_cpu = -1;
+  int peer_cpu = -1;
+};
+
+// Resolve the placement and pin the bench thread. Returns false with
+// ctx->skip_reason set when the host cannot satisfy it (e.g. cross on one
+// CPU); pinning failures are fatal, like other setup errors.
+bool setup_placement(Ctx* ctx, Placement* placement);
+// Put the bench thread back on the affinity it had before the case ran.
+void restore_placement(const Ctx& ctx, const Placement& placement);
+
+// CPUs for `count` threads of a multi-threaded case, index 0 being the bench
+// thread. Assigned round-robin from --param cpus (default: the affinity mask
+// from before --pin, starting at the --pin CPU when given), so more threads
+// than CPUs oversubscribes. Empty CPU list -> all -1 (unpinned).
+std::vector<int> thread_cpus(const Ctx& ctx, size_t count);
+// Give the bench thread back its pre-case affinity (--pin CPU or full mask)
+// after a case pinned it via thread_cpus().
+void restore_affinity(const Ctx& ctx);
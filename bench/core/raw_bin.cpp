@@ -0,0 +1,157 @@
+#include "raw_bin.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+constexpr char kMagic[4] = {'L', 'L', 'R', 'B'};
+constexpr size_t kCaseOffset = 48;
+
+template <typename T>
+void put(uint8_t* out, T value) {
+  std::memcpy(out, &value, sizeof(value));  // LE hosts only.
+}
+
+template <typename T>
+T get(const uint8_t* in) {
+  T value;
+  std::memcpy(&value, in, sizeof(value));
+  return value;
+}
+
+}  // namespace
+
+bool write_raw_bin(const std::string& path,
+                   const RawBinHeader& header,
+                   const std::vector<uint64_t>& samples,
+                   std::string* error) {
+  const uint64_t max_value =
+      samples.empty() ? 0 : *std::max_element(samples.begin(), samples.end());
+  const uint16_t value_bytes = max_value <= UINT32_MAX ? 4 : 8;
+  const uint32_t case_len = static_cast<uint32_t>(std::min(
+      header.case_name.size(), kRawBinHeaderBytes - kCaseOffset));
+
+  std::vector<uint8_t> page(kRawBinHeaderBytes, 0);
+  std::memcpy(page.data(), kMagic, sizeof(kMagic));
+  page[4] = static_cast<uint8_t>(kRawBinVersion);
+  page[5] = header.unit;
+  put<uint16_t>(&page[6], value_bytes);
+  put<uint64_t>(&page[8], kRawBinHeaderBytes);
+  put<uint64_t>(&page[16], samples.size());
+  put<uint64_t>(&page[24], header.iters);
+  put<uint64_t>(&page[32], header.warmup);
+  put<int32_t>(&page[40], header.pin_cpu);
+  put<uint32_t>(&page[44], case_len);
+  std::memcpy(&page[kCaseOffset], header.case_name.data(), case_len);
+
+  const std::string tmp_path = path + ".tmp";
+  std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    *error = std::strerror(errno);
+    return false;
+  }
+  out.write(reinterpret_cast<const char*>(page.data()),
+            static_cast<std::streamsize>(page.size()));
+  if (value_bytes == 8) {
+    out.write(reinterpret_cast<const char*>(samples.data()),
+              static_cast<std::streamsize>(samples.size() * sizeof(uint64_t)));
+  } else {
+    // Narrow in page-sized chunks to avoid a second full-size buffer.
+    std::vector<uint32_t> chunk;
+    chunk.reserve(1024);
+    for (size_t i = 0; i < samples.size(); i += 1024) {
+      const size_t end = std::min(samples.size(), i + 1024);
+      chunk.assign(samples.begin() + i, samples.begin() + end);
+      out.write(reinterpret_cast<const char*>(chunk.data()),
+                static_cast<std::streamsize>(chunk.size() * sizeof(uint32_t)));
+    }
+  }
+  out.flush();
+  if (!out.good()) {
+    *error = "failed to write file";
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  out.close();
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    *error = std::strerror(errno);
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+MappedRawBin::~MappedRawBin() {
+  if (map_ != nullptr) {
+    munmap(map_, map_bytes_);
+  }
+}
+
+bool MappedRawBin::open(const std::string& path, std::string* error) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    *error = path + ": " + std::strerror(errno);
+    return false;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < kRawBinHeaderBytes) {
+    *error = path + ": truncated raw.bin header";
+    close(fd);
+    return false;
+  }
+  map_bytes_ = static_cast<size_t>(st.st_size);
+  map_ = mmap(nullptr, map_bytes_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = nullptr;
+    *error = path + ": mmap: " + std::strerror(errno);
+    return false;
+  }
+
+  const uint8_t* base = static_cast<const uint8_t*>(map_);
+  const uint16_t value_bytes = get<uint16_t>(base + 6);
+  const uint64_t data_offset = get<uint64_t>(base + 8);
+  const uint64_t count = get<uint64_t>(base + 16);
+  const uint32_t case_len = get<uint32_t>(base + 44);
+  if (std::memcmp(base, kMagic, sizeof(kMagic)) != 0 ||
+      base[4] != kRawBinVersion) {
+    *error = path + ": invalid raw.bin magic or version";
+    return false;
+  }
+  if ((value_bytes != 4 && value_bytes != 8) || data_offset % 4096 != 0 ||
+      case_len > kRawBinHeaderBytes - kCaseOffset ||
+      data_offset > map_bytes_ ||
+      count > (map_bytes_ - data_offset) / value_bytes) {
+    *error = path + ": corrupt raw.bin header";
+    return false;
+  }
+  header_.unit = base[5];
+  header_.iters = get<uint64_t>(base + 24);
+  header_.warmup = get<uint64_t>(base + 32);
+  header_.pin_cpu = get<int32_t>(base + 40);
+  header_.case_name.assign(reinterpret_cast<const char*>(base + kCaseOffset),
+                           case_len);
+  value_bytes_ = value_bytes;
+  data_ = base + data_offset;
+  count_ = static_cast<size_t>(count);
+  // Analysis scans the array front to back.
+  madvise(map_, map_bytes_, MADV_SEQUENTIAL);
+  return true;
+}
+
+bool is_raw_bin_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[sizeof(kMagic)] = {};
+  in.read(magic, sizeof(magic));
+  return in.good() && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
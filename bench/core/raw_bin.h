@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// raw.bin: uncompressed samples for zero-copy loading (np.memmap, mmap).
+// One header page, then a little-endian uint32 or uint64 array starting at
+// data_offset (page-aligned):
+//   0   "LLRB"
+//   4   u8 version, u8 unit (raw_format.UNIT_NAMES index), u16 value_bytes
+//   8   u64 data_offset, u64 sample_count, u64 iters, u64 warmup
+//   40  i32 pin_cpu, u32 case_len, case name bytes
+// Must stay in sync with raw_format.RAW_BIN_HEADER.
+constexpr uint32_t kRawBinVersion = 1;
+constexpr size_t kRawBinHeaderBytes = 4096;
+
+struct RawBinHeader {
+  uint8_t unit = 0;  // 0 = ns
+  std::string case_name;
+  uint64_t iters = 0;
+  uint64_t warmup = 0;
+  int32_t pin_cpu = -1;
+};
+
+// Write-to-temp + rename, like raw.csv. Values are stored in header.unit;
+// value_bytes is 4 when every value fits in 32 bits, else 8.
+bool write_raw_bin(const std::string& path,
+                   const RawBinHeader& header,
+                   const std::vector<uint64_t>& samples,
+                   std::string* error);
+
+// Read-only mapping of a raw.bin file; values are read in place.
+class MappedRawBin {
+ public:
+  MappedRawBin() = default;
+  ~MappedRawBin();
+  MappedRawBin(const MappedRawBin&) = delete;
+  MappedRawBin& operator=(const MappedRawBin&) = delete;
+
+  bool open(const std::string& path, std::string* error);
+  const RawBinHeader& header() const { return header_; }
+  size_t size() const { return count_; }
+  unsigned value_bytes() const { return value_bytes_; }
+  // Raw array at data_offset: uint32_t or uint64_t per value_bytes().
+  const void* data() const { return data_; }
+  uint64_t operator[](size_t i) const {
+    return value_bytes_ == 4 ? static_cast<const uint32_t*>(data_)[i]
+                             : static_cast<const uint64_t*>(data_)[i];
+  }
+
+ private:
+  RawBinHeader header_;
+  void* map_ = nullptr;
+  size_t map_bytes_ = 0;
+  const void* data_ = nullptr;
+  size_t count_ = 0;
+  unsigned value_bytes_ = 8;
+};
+
+// True if the file starts with the raw.bin magic.
+bool is_raw_bin_file(const std::string& path);
@@ -9,8 +9,12 @@ void register_case(const Case& bench_case);
 const std::vector<const Case*>& cases();
 const Case* find_case(const std::string& name);
 
+// The extra indirection expands __COUNTER__ before token pasting, so a file
+// can register several cases (one registrar per invocation).
 #define LATENCY_LAB_REGISTER_CASE(bench_case) \
-  LATENCY_LAB_REGISTER_CASE_IMPL(bench_case, __COUNTER__)
+  LATENCY_LAB_REGISTER_CASE_EXPAND(bench_case, __COUNTER__)
+#define LATENCY_LAB_REGISTER_CASE_EXPAND(bench_case, counter) \
+  LATENCY_LAB_REGISTER_CASE_IMPL(bench_case, counter)
 #define LATENCY_LAB_REGISTER_CASE_IMPL(bench_case, counter) \
   namespace { \
   struct CaseRegistrar_##counter { \
@@ -25,6 +25,11 @@ std::string resolve_output_path(const CliOptions& options) {
   return options.out_path;
 }
 
+std::string resolve_raw_bin_path(const CliOptions& options) {
+  const std::filesystem::path raw_csv(resolve_output_path(options));
+  return (raw_csv.parent_path() / "raw.bin").string();
+}
+
 std::string resolve_meta_path(const CliOptions& options) {
   if (options.out_dir.empty()) {
     return "";
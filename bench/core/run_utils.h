@@ -7,5 +7,7 @@
 
 const Case* resolve_case(const std::string& name);
 std::string resolve_output_path(const CliOptions& options);
+// raw.bin sits next to raw.csv.
+std::string resolve_raw_bin_path(const CliOptions& options);
 std::string resolve_meta_path(const CliOptions& options);
 std::string resolve_stdout_path(const CliOptions& options);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "timer.h"
+
+#include <atomic>
+#include <cstdint>
+
+// Hint to the core that we are in a spin-wait loop. On x86 this is `pause`,
+// which also avoids a memory-order mis-speculation flush when the awaited
+// line finally changes.
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Busy-wait for roughly `ns` nanoseconds (clock-read granularity). Used to
+// model work and think time without sleeping.
+inline void spin_for_ns(uint64_t ns) {
+  if (ns == 0) {
+    return;
+  }
+  const uint64_t end = now_ns() + ns;
+  while (now_ns() < end) {
+    cpu_relax();
+  }
+}
@@ -0,0 +1,44 @@
+#include "threads.h"
+
+#include "pinning.h"
+
+#include <exception>
+#include <future>
+#include <utility>
+
+bool start_pinned_thread(int cpu,
+                         std::function<void()> fn,
+                         std::thread* out,
+                         std::string* error) {
+  std::promise<std::string> promise;
+  auto future = promise.get_future();
+  try {
+    *out = std::thread(
+        [cpu, fn = std::move(fn), promise = std::move(promise)]() mutable {
+          if (cpu >= 0) {
+            std::string pin_error;
+            if (!pin_to_cpu(cpu, &pin_error)) {
+              promise.set_value(pin_error);
+              return;
+            }
+          }
+          promise.set_value("");
+          fn();
+        });
+  } catch (const std::exception& exc) {
+    if (error) {
+      *error = exc.what();
+    }
+    return false;
+  }
+
+  const std::string start_error = future.get();
+  if (!start_error.empty()) {
+    out->join();
+    if (error) {
+      *error = "failed to pin to cpu " + std::to_string(cpu) + ": " + start_error;
+    }
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <thread>
+
+// Start a helper thread pinned to `cpu` (unpinned when cpu < 0) and wait until
+// it has applied its affinity, so pinning errors surface before the case
+// starts measuring. `fn` only runs after a successful pin. Setup-time helper;
+// never call this from a timed region.
+bool start_pinned_thread(int cpu,
+                         std::function<void()> fn,
+                         std::thread* out,
+                         std::string* error);
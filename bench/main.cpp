@@ -1,19 +1,17 @@
+#include "artifacts.h"
 #include "cli.h"
 #include "csv.h"
 #include "meta.h"
 #include "noise.h"
 #include "pinning.h"
+#include "raw_bin.h"
 #include "registry.h"
 #include "run_utils.h"
 #include "stats.h"
 #include "timer.h"
 
-#include <cerrno>
-#include <cstdio>
-#include <cstring>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -47,41 +45,6 @@ bool ensure_output_dir(const std::string& out_dir, std::string* error) {
   return true;
 }
 
-bool write_text_file_atomic(const std::string& path,
-                            const std::string& contents,
-                            std::string* error) {
-  const std::string tmp_path = path + ".tmp";
-  std::ofstream out(tmp_path, std::ios::out | std::ios::trunc);
-  if (!out.is_open()) {
-    if (error) {
-      *error = std::strerror(errno);
-    }
-    return false;
-  }
-  out << contents;
-  out.flush();
-  if (!out.good()) {
-    if (error) {
-      *error = "failed to write file";
-    }
-    std::remove(tmp_path.c_str());
-    return false;
-  }
-  out.close();
-
-  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
-    std::remove(path.c_str());
-    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
-      if (error) {
-        *error = std::strerror(errno);
-      }
-      std::remove(tmp_path.c_str());
-      return false;
-    }
-  }
-  return true;
-}
-
 std::string format_ns(double ns) {
   double value = ns;
   const char* unit = "ns";
@@ -104,9 +67,16 @@ std::string format_ns(double ns) {
 std::string format_summary(const Case& bench_case,
                            const Quantiles& q,
                            uint64_t iters,
+                           uint64_t batch,
+                           const std::vector<std::pair<std::string, double>>&
+                               metrics,
                            SummaryFormat format) {
   std::ostringstream out;
-  out << bench_case.name << " (iters=" << iters << ")\n";
+  out << bench_case.name << " (iters=" << iters;
+  if (batch > 1) {
+    out << ", batch=" << batch;
+  }
+  out << ")\n";
   if (format == SummaryFormat::kCsv) {
     out << "min,p50,p95,p99,p999,max,mean,iters\n";
     out << q.min << "," << q.p50 << "," << q.p95 << "," << q.p99 << ","
@@ -121,13 +91,72 @@ std::string format_summary(const Case& bench_case,
       << "p999=" << format_ns(static_cast<double>(q.p999)) << "\n"
       << "max=" << format_ns(static_cast<double>(q.max)) << "\n"
       << "mean=" << format_ns(q.mean) << "\n";
+  // Case metrics carry their unit in the name (e.g. mib_per_sec).
+  for (const auto& metric : metrics) {
+    out << metric.first << "=" << std::fixed << std::setprecision(2)
+        << metric.second << "\n";
+  }
   return out.str();
 }
 
+// Emit the stdout summary, raw.csv, and meta.json. Skipped runs go through
+// the same path with no samples so the output schema stays identical.
+int write_outputs(const CliOptions& options,
+                  const char* case_name,
+                  const RunMetadata& meta,
+                  const std::vector<uint64_t>& samples,
+                  const std::string& summary) {
+  std::cout << summary;
+
+  if (!options.out_dir.empty()) {
+    const std::string stdout_path = resolve_stdout_path(options);
+    std::string error;
+    if (!write_text_file_atomic(stdout_path, summary, &error)) {
+      std::cerr << "failed to write " << stdout_path << ": " << error << "\n";
+      return 1;
+    }
+  }
+
+  const std::string out_path = resolve_output_path(options);
+  if (!write_raw_csv(out_path, samples)) {
+    std::cerr << "failed to write " << out_path << "\n";
+    return 1;
+  }
+
+  if (options.raw_bin) {
+    RawBinHeader header;
+    header.case_name = case_name;
+    header.iters = options.iters;
+    header.warmup = options.warmup;
+    header.pin_cpu = options.pin_enabled ? options.pin_cpu : -1;
+    const std::string bin_path = resolve_raw_bin_path(options);
+    std::string error;
+    if (!write_raw_bin(bin_path, header, samples, &error)) {
+      std::cerr << "failed to write " << bin_path << ": " << error << "\n";
+      return 1;
+    }
+  }
+
+  if (!options.out_dir.empty()) {
+    const std::string meta_path = resolve_meta_path(options);
+    std::string error;
+    if (!write_meta_json(meta_path, meta, &error)) {
+      std::cerr << "failed to write " << meta_path << ": " << error << "\n";
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
 // Run the selected case and emit outputs (stdout summary + raw CSV).
 int run_benchmark(const Case& bench_case,
                   const CliOptions& options,
                   const std::string& command_line) {
+  // Capture the affinity mask before --pin narrows it to one CPU.
+  std::string affinity_error;
+  const std::vector<int> allowed = allowed_cpus(&affinity_error);
+
   if (options.pin_enabled) {
     std::string error;
     // Pin before setup/warmup so the entire run stays on one CPU.
@@ -152,12 +181,37 @@ int run_benchmark(const Case& bench_case,
   meta.pinning = options.pin_enabled;
   meta.pinned_cpu = options.pin_cpu;
   meta.tags = options.tags;
+  meta.params = options.params;
+  // CLI override wins; otherwise use the case's own batch size.
+  const uint64_t batch =
+      options.batch > 0 ? options.batch
+                        : (bench_case.batch > 0 ? bench_case.batch : 1);
+  meta.batch = batch;
 
   Ctx ctx;
+  ctx.iters = options.iters;
+  ctx.warmup = options.warmup;
+  ctx.pin_cpu = options.pin_enabled ? options.pin_cpu : -1;
+  ctx.allowed_cpus = allowed;
+  ctx.params = options.params;
+  // Artifacts live next to raw.csv, whether or not --out was given.
+  ctx.artifact_dir =
+      std::filesystem::path(resolve_output_path(options)).parent_path().string();
   if (bench_case.setup) {
     bench_case.setup(&ctx);
   }
 
+  if (!ctx.skip_reason.empty()) {
+    if (bench_case.teardown) {
+      bench_case.teardown(&ctx);
+    }
+    meta.skipped = true;
+    meta.skip_reason = ctx.skip_reason;
+    return write_outputs(options, bench_case.name, meta, {},
+                         bench_case.name + std::string(" skipped: ") +
+                             ctx.skip_reason + "\n");
+  }
+
   NoiseRunner noise;
   NoiseConfig noise_config;
   noise_config.mode = options.noise_mode;
@@ -177,19 +231,27 @@ int run_benchmark(const Case& bench_case,
   meta.noise_cpu = noise.noise_cpu();
 
   // Warmup reduces cold-start effects (cache/branch predictor) in the samples.
+  ctx.warming_up = true;
   for (uint64_t i = 0; i < options.warmup; ++i) {
-    bench_case.run_once(&ctx);
+    for (uint64_t b = 0; b < batch; ++b) {
+      bench_case.run_once(&ctx);
+    }
   }
+  ctx.warming_up = false;
 
   std::vector<uint64_t> samples;
   samples.reserve(static_cast<size_t>(options.iters));
 
   for (uint64_t i = 0; i < options.iters; ++i) {
-    // Timed region is only the operation under test.
+    // Timed region is only the operation under test. Batched cases amortize
+    // the two clock reads over `batch` calls and record the per-call average.
+    ctx.has_sample = false;
     const uint64_t start = now_ns();
-    bench_case.run_once(&ctx);
+    for (uint64_t b = 0; b < batch; ++b) {
+      bench_case.run_once(&ctx);
+    }
     const uint64_t end = now_ns();
-    samples.push_back(end - start);
+    samples.push_back(ctx.has_sample ? ctx.sample_ns : (end - start) / batch);
   }
 
   noise.Stop();
@@ -198,36 +260,14 @@ int run_benchmark(const Case& bench_case,
     bench_case.teardown(&ctx);
   }
 
+  meta.artifacts = ctx.artifacts;
+  meta.metrics = ctx.metrics;
+
   const Quantiles q = compute_quantiles(samples);
   const std::string summary =
-      format_summary(bench_case, q, options.iters, options.summary_format);
-  std::cout << summary;
-
-  if (!options.out_dir.empty()) {
-    const std::string stdout_path = resolve_stdout_path(options);
-    std::string error;
-    if (!write_text_file_atomic(stdout_path, summary, &error)) {
-      std::cerr << "failed to write " << stdout_path << ": " << error << "\n";
-      return 1;
-    }
-  }
-
-  const std::string out_path = resolve_output_path(options);
-  if (!write_raw_csv(out_path, samples)) {
-    std::cerr << "failed to write " << out_path << "\n";
-    return 1;
-  }
-
-  if (!options.out_dir.empty()) {
-    const std::string meta_path = resolve_meta_path(options);
-    std::string error;
-    if (!write_meta_json(meta_path, meta, &error)) {
-      std::cerr << "failed to write " << meta_path << ": " << error << "\n";
-      return 1;
-    }
-  }
-
-  return 0;
+      format_summary(bench_case, q, options.iters, batch, ctx.metrics,
+                     options.summary_format);
+  return write_outputs(options, bench_case.name, meta, samples, summary);
 }
 
 }  // namespace
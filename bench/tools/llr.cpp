@@ -0,0 +1,838 @@
+#include "llr.h"
+
+#include <lzma.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr char kMagicV1[4] = {'L', 'L', 'R', '1'};
+constexpr char kMagicV2[4] = {'L', 'L', 'R', '2'};
+constexpr char kIndexMagic[4] = {'L', 'L', 'R', 'I'};
+constexpr uint8_t kXzMagic[6] = {0xfd, '7', 'z', 'X', 'Z', 0x00};
+constexpr uint32_t kLzmaPreset = 9 | LZMA_PRESET_EXTREME;
+constexpr size_t kBlockEntryBytes = 8 + 4 + 4 + 8 + 8 + 4 * kLlrHistBuckets;
+constexpr size_t kTrailerBytes = 8 + 4 + 4;
+
+struct BlockEntry {
+  uint64_t offset = 0;
+  uint32_t compressed_len = 0;
+  uint32_t count = 0;
+};
+
+// --- Little-endian byte buffers ---------------------------------------------
+
+template <typename T>
+void put(std::vector<uint8_t>* out, T value) {
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out->push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >>
+                                        (8 * i)));
+  }
+}
+
+void put_string(std::vector<uint8_t>* out, const std::string& text) {
+  put<uint32_t>(out, static_cast<uint32_t>(text.size()));
+  out->insert(out->end(), text.begin(), text.end());
+}
+
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  bool get(T* value) {
+    if (size_ - pos_ < sizeof(T)) {
+      return false;
+    }
+    uint64_t raw = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      raw |= static_cast<uint64_t>(data_[pos_ + i]) << (8 * i);
+    }
+    pos_ += sizeof(T);
+    *value = static_cast<T>(raw);
+    return true;
+  }
+
+  bool get_string(std::string* text) {
+    uint32_t len = 0;
+    if (!get(&len) || size_ - pos_ < len) {
+      return false;
+    }
+    text->assign(reinterpret_cast<const char*>(data_ + pos_), len);
+    pos_ += len;
+    return true;
+  }
+
+  bool get_bytes(char* out, size_t len) {
+    if (size_ - pos_ < len) {
+      return false;
+    }
+    std::memcpy(out, data_ + pos_, len);
+    pos_ += len;
+    return true;
+  }
+
+  size_t pos() const { return pos_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+void put_header(std::vector<uint8_t>* out, const LlrHeader& header) {
+  const char* magic = header.version == kLlrVersion1 ? kMagicV1 : kMagicV2;
+  out->insert(out->end(), magic, magic + 4);
+  put<uint8_t>(out, static_cast<uint8_t>(header.version));
+  put<uint8_t>(out, static_cast<uint8_t>(header.unit));
+  put<uint16_t>(out, header.version == kLlrVersion2
+                         ? static_cast<uint16_t>(header.codec)
+                         : 0);
+  put<uint64_t>(out, header.sample_count);
+  put<uint64_t>(out, header.iters);
+  put<uint64_t>(out, header.warmup);
+  put<int32_t>(out, header.pin_cpu);
+  put<uint32_t>(out, static_cast<uint32_t>(header.tags.size()));
+  put_string(out, header.case_name);
+  for (const std::string& tag : header.tags) {
+    put_string(out, tag);
+  }
+  put<uint32_t>(out, static_cast<uint32_t>(header.args.size()));
+  for (const std::string& arg : header.args) {
+    put_string(out, arg);
+  }
+  if (header.version == kLlrVersion2) {
+    put<uint32_t>(out, header.block_samples);
+  }
+}
+
+bool get_header(Reader* in, LlrHeader* header, std::string* error) {
+  char magic[4];
+  uint8_t version = 0;
+  uint8_t unit = 0;
+  uint16_t codec = 0;
+  uint32_t tag_count = 0;
+  if (!in->get_bytes(magic, 4) || !in->get(&version) || !in->get(&unit) ||
+      !in->get(&codec)) {
+    *error = "truncated raw header";
+    return false;
+  }
+  const char* expected = version == kLlrVersion1 ? kMagicV1 : kMagicV2;
+  if ((version != kLlrVersion1 && version != kLlrVersion2) ||
+      std::memcmp(magic, expected, 4) != 0) {
+    *error = "invalid raw file magic or version";
+    return false;
+  }
+  if (unit > static_cast<uint8_t>(LlrUnit::kS)) {
+    *error = "invalid unit enum";
+    return false;
+  }
+  if (codec > static_cast<uint16_t>(LlrCodec::kFor)) {
+    *error = "unknown codec id " + std::to_string(codec);
+    return false;
+  }
+  header->version = version;
+  header->unit = static_cast<LlrUnit>(unit);
+  header->codec = static_cast<LlrCodec>(codec);
+  if (!in->get(&header->sample_count) || !in->get(&header->iters) ||
+      !in->get(&header->warmup) || !in->get(&header->pin_cpu) ||
+      !in->get(&tag_count) || !in->get_string(&header->case_name)) {
+    *error = "truncated raw header";
+    return false;
+  }
+  header->tags.resize(tag_count);
+  for (std::string& tag : header->tags) {
+    if (!in->get_string(&tag)) {
+      *error = "truncated tag";
+      return false;
+    }
+  }
+  uint32_t arg_count = 0;
+  if (!in->get(&arg_count)) {
+    *error = "truncated arg count";
+    return false;
+  }
+  header->args.resize(arg_count);
+  for (std::string& arg : header->args) {
+    if (!in->get_string(&arg)) {
+      *error = "truncated arg";
+      return false;
+    }
+  }
+  if (version == kLlrVersion2 && !in->get(&header->block_samples)) {
+    *error = "truncated raw header";
+    return false;
+  }
+  return true;
+}
+
+// --- xz ---------------------------------------------------------------------
+
+bool xz_decompress(const uint8_t* data,
+                   size_t size,
+                   std::vector<uint8_t>* out,
+                   std::string* error) {
+  lzma_stream stream = LZMA_STREAM_INIT;
+  if (lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+    *error = "lzma_stream_decoder failed";
+    return false;
+  }
+  out->resize(std::max<size_t>(size * 4, 4096));
+  stream.next_in = data;
+  stream.avail_in = size;
+  stream.next_out = out->data();
+  stream.avail_out = out->size();
+  lzma_ret ret = LZMA_OK;
+  while (true) {
+    ret = lzma_code(&stream, stream.avail_in == 0 ? LZMA_FINISH : LZMA_RUN);
+    if (ret != LZMA_OK) {
+      break;
+    }
+    if (stream.avail_out == 0) {
+      const size_t used = out->size();
+      out->resize(used * 2);
+      stream.next_out = out->data() + used;
+      stream.avail_out = out->size() - used;
+    }
+  }
+  out->resize(stream.total_out);
+  lzma_end(&stream);
+  if (ret != LZMA_STREAM_END) {
+    *error = "xz decode failed (lzma error " + std::to_string(ret) + ")";
+    return false;
+  }
+  return true;
+}
+
+bool xz_compress(const std::vector<uint8_t>& in,
+                 std::vector<uint8_t>* out,
+                 std::string* error) {
+  out->resize(lzma_stream_buffer_bound(in.size()));
+  size_t out_pos = 0;
+  if (lzma_easy_buffer_encode(kLzmaPreset, LZMA_CHECK_CRC64, nullptr,
+                              in.data(), in.size(), out->data(), &out_pos,
+                              out->size()) != LZMA_OK) {
+    *error = "xz encode failed";
+    return false;
+  }
+  out->resize(out_pos);
+  return true;
+}
+
+// --- Varints ----------------------------------------------------------------
+
+inline uint64_t zigzag_decode(uint64_t value) {
+  return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+inline uint64_t zigzag_encode(uint64_t delta) {
+  return (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >>
+                                              63);
+}
+
+void put_varint(uint64_t value, std::vector<uint8_t>* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+}
+
+bool get_varint(const uint8_t* data, size_t size, size_t* pos, uint64_t* value) {
+  uint64_t result = 0;
+  for (unsigned shift = 0; *pos < size && shift < 70; shift += 7) {
+    const uint8_t byte = data[(*pos)++];
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+// --- Frame-of-reference bit packing -----------------------------------------
+
+__extension__ typedef unsigned __int128 Uint128;
+
+constexpr size_t kFrameSlack = 16;
+
+// Reads up to kFrameSlack bytes past the frame; callers pad short inputs.
+template <unsigned W>
+void unpack_frame(const uint8_t* in, uint64_t* out) {
+  if constexpr (W == 0) {
+    std::fill(out, out + kLlrForFrame, 0);
+  } else {
+    constexpr uint64_t kMask = W == 64 ? ~uint64_t{0} : (uint64_t{1} << W) - 1;
+    for (size_t i = 0; i < kLlrForFrame; ++i) {
+      const size_t bit = i * W;
+      if constexpr (W <= 56) {
+        uint64_t word;
+        std::memcpy(&word, in + bit / 8, sizeof(word));
+        out[i] = (word >> (bit % 8)) & kMask;
+      } else {
+        Uint128 word;
+        std::memcpy(&word, in + bit / 8, sizeof(word));
+        out[i] = static_cast<uint64_t>(word >> (bit % 8)) & kMask;
+      }
+    }
+  }
+}
+
+// Writes exactly 16 * W bytes.
+template <unsigned W>
+void pack_frame(const uint64_t* in, uint8_t* out) {
+  if constexpr (W > 0) {
+    Uint128 acc = 0;
+    unsigned bits = 0;
+    for (size_t i = 0; i < kLlrForFrame; ++i) {
+      acc |= static_cast<Uint128>(in[i]) << bits;
+      bits += W;
+      if (bits >= 64) {
+        const uint64_t word = static_cast<uint64_t>(acc);
+        std::memcpy(out, &word, sizeof(word));
+        out += sizeof(word);
+        acc >>= 64;
+        bits -= 64;
+      }
+    }
+  }
+}
+
+using UnpackFn = void (*)(const uint8_t*, uint64_t*);
+using PackFn = void (*)(const uint64_t*, uint8_t*);
+
+template <size_t... W>
+constexpr std::array<UnpackFn, sizeof...(W)> unpack_table(
+    std::index_sequence<W...>) {
+  return {&unpack_frame<W>...};
+}
+
+template <size_t... W>
+constexpr std::array<PackFn, sizeof...(W)> pack_table(
+    std::index_sequence<W...>) {
+  return {&pack_frame<W>...};
+}
+
+constexpr auto kUnpack = unpack_table(std::make_index_sequence<65>{});
+constexpr auto kPack = pack_table(std::make_index_sequence<65>{});
+
+size_t decode_scalar(const uint8_t* data,
+                     size_t size,
+                     size_t count,
+                     uint64_t* out,
+                     size_t* consumed,
+                     uint64_t* prev) {
+  size_t pos = *consumed;
+  size_t n = 0;
+  uint64_t current = *prev;
+  while (n < count && pos < size) {
+    uint64_t value = 0;
+    unsigned shift = 0;
+    size_t p = pos;
+    bool done = false;
+    while (p < size && shift < 70) {
+      const uint8_t byte = data[p++];
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        done = true;
+        break;
+      }
+      shift += 7;
+    }
+    if (!done) {
+      break;
+    }
+    pos = p;
+    current += zigzag_decode(value);
+    out[n++] = current;
+  }
+  *consumed = pos;
+  *prev = current;
+  return n;
+}
+
+#if defined(__x86_64__)
+// 16 bytes at a time: one SSE2 movemask gives every terminator (high bit
+// clear) in the window. Each varint of up to 8 bytes is then gathered with a
+// single unaligned load and pext. A longer one is decoded on its own by the
+// scalar path before the next window; only the tail stays scalar.
+__attribute__((target("sse2,bmi,bmi2"))) size_t decode_bmi2(const uint8_t* data,
+                                                           size_t size,
+                                                           size_t count,
+                                                           uint64_t* out) {
+  size_t pos = 0;
+  size_t n = 0;
+  uint64_t prev = 0;
+  while (n < count && pos + 24 <= size) {
+    const __m128i window =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    uint32_t ends = ~static_cast<uint32_t>(_mm_movemask_epi8(window)) & 0xffff;
+    if (ends == 0xffff && n + 16 <= count) {
+      // All single-byte varints.
+      for (int i = 0; i < 16; ++i) {
+        prev += zigzag_decode(data[pos + i]);
+        out[n++] = prev;
+      }
+      pos += 16;
+      continue;
+    }
+    if (ends == 0) {
+      break;
+    }
+    size_t start = 0;
+    while (ends != 0 && n < count) {
+      const size_t end = _tzcnt_u32(ends);
+      const size_t len = end - start + 1;
+      if (len > 8) {
+        break;
+      }
+      uint64_t word = 0;
+      std::memcpy(&word, data + pos + start, sizeof(word));
+      const uint64_t keep =
+          len == 8 ? ~uint64_t{0} : ((uint64_t{1} << (8 * len)) - 1);
+      prev += zigzag_decode(_pext_u64(word & keep, 0x7f7f7f7f7f7f7f7full));
+      out[n++] = prev;
+      start = end + 1;
+      ends &= ends - 1;
+    }
+    if (start == 0) {
+      // The window opens with a 9- or 10-byte varint.
+      size_t consumed = pos;
+      if (decode_scalar(data, size, 1, out + n, &consumed, &prev) == 0) {
+        break;
+      }
+      ++n;
+      pos = consumed;
+      continue;
+    }
+    pos += start;
+  }
+  size_t consumed = pos;
+  return n + decode_scalar(data, size, count - n, out + n, &consumed, &prev);
+}
+
+bool cpu_has_bmi2() {
+  static const bool has = __builtin_cpu_supports("bmi2");
+  return has;
+}
+#endif
+
+// --- LLR2 blocks ------------------------------------------------------------
+
+bool decode_blocks(const std::vector<uint8_t>& file,
+                   LlrCodec codec,
+                   const std::vector<BlockEntry>& blocks,
+                   unsigned threads,
+                   std::vector<uint64_t>* values,
+                   std::string* error) {
+  std::vector<size_t> first(blocks.size() + 1, 0);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    first[i + 1] = first[i] + blocks[i].count;
+  }
+  values->assign(first.back(), 0);
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min<unsigned>(threads,
+                               std::max<size_t>(1, blocks.size()));
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::string> errors(threads);
+  auto worker = [&](unsigned id) {
+    std::vector<uint8_t> payload;
+    for (size_t i = next++; i < blocks.size() && !failed; i = next++) {
+      const BlockEntry& block = blocks[i];
+      if (block.offset > file.size() ||
+          block.compressed_len > file.size() - block.offset) {
+        errors[id] = "block extends past end of file";
+        failed = true;
+        return;
+      }
+      const uint8_t* data = file.data() + block.offset;
+      size_t got = 0;
+      if (codec == LlrCodec::kFor) {
+        got = decode_for_frames(data, block.compressed_len, block.count,
+                                values->data() + first[i]);
+      } else if (xz_decompress(data, block.compressed_len, &payload,
+                               &errors[id])) {
+        got = decode_varint_deltas(payload.data(), payload.size(),
+                                   block.count, values->data() + first[i]);
+      } else {
+        failed = true;
+        return;
+      }
+      if (got != block.count) {
+        errors[id] = "block " + std::to_string(i) + " is truncated";
+        failed = true;
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  for (unsigned id = 1; id < threads; ++id) {
+    pool.emplace_back(worker, id);
+  }
+  worker(0);
+  for (std::thread& thread : pool) {
+    thread.join();
+  }
+  if (failed) {
+    for (const std::string& message : errors) {
+      if (!message.empty()) {
+        *error = message;
+        break;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
+bool read_v2(const std::vector<uint8_t>& file,
+             unsigned threads,
+             LlrHeader* header,
+             std::vector<uint64_t>* values,
+             std::string* error) {
+  Reader in(file.data(), file.size());
+  if (!get_header(&in, header, error)) {
+    return false;
+  }
+  if (file.size() < kTrailerBytes) {
+    *error = "missing LLR2 block index";
+    return false;
+  }
+  Reader trailer(file.data() + file.size() - kTrailerBytes, kTrailerBytes);
+  uint64_t index_offset = 0;
+  uint32_t block_count = 0;
+  char magic[4];
+  trailer.get(&index_offset);
+  trailer.get(&block_count);
+  trailer.get_bytes(magic, 4);
+  const uint64_t index_end = file.size() - kTrailerBytes;
+  if (std::memcmp(magic, kIndexMagic, 4) != 0 || index_offset > index_end ||
+      uint64_t{block_count} * kBlockEntryBytes > index_end - index_offset) {
+    *error = "missing LLR2 block index";
+    return false;
+  }
+  std::vector<BlockEntry> blocks(block_count);
+  for (uint32_t i = 0; i < block_count; ++i) {
+    Reader entry(file.data() + index_offset + i * kBlockEntryBytes,
+                 kBlockEntryBytes);
+    entry.get(&blocks[i].offset);
+    entry.get(&blocks[i].compressed_len);
+    entry.get(&blocks[i].count);
+  }
+  return decode_blocks(file, header->codec, blocks, threads, values, error);
+}
+
+bool read_v1(const std::vector<uint8_t>& file,
+             LlrHeader* header,
+             std::vector<uint64_t>* values,
+             std::string* error) {
+  std::vector<uint8_t> plain;
+  if (!xz_decompress(file.data(), file.size(), &plain, error)) {
+    return false;
+  }
+  Reader in(plain.data(), plain.size());
+  if (!get_header(&in, header, error)) {
+    return false;
+  }
+  values->assign(header->sample_count, 0);
+  const size_t got =
+      decode_varint_deltas(plain.data() + in.pos(), plain.size() - in.pos(),
+                           header->sample_count, values->data());
+  values->resize(got);
+  return true;
+}
+
+void put_block_entry(std::vector<uint8_t>* out,
+                     uint64_t offset,
+                     size_t compressed_len,
+                     const uint64_t* values,
+                     size_t count) {
+  uint32_t hist[kLlrHistBuckets] = {};
+  uint64_t low = count > 0 ? values[0] : 0;
+  uint64_t high = low;
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t value = values[i];
+    low = std::min(low, value);
+    high = std::max(high, value);
+    const size_t bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+    ++hist[bucket];
+  }
+  put<uint64_t>(out, offset);
+  put<uint32_t>(out, static_cast<uint32_t>(compressed_len));
+  put<uint32_t>(out, static_cast<uint32_t>(count));
+  put<uint64_t>(out, low);
+  put<uint64_t>(out, high);
+  for (uint32_t bucket : hist) {
+    put<uint32_t>(out, bucket);
+  }
+}
+
+bool write_file(const std::string& path,
+                const std::vector<uint8_t>& bytes,
+                std::string* error) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(bytes.data()),
+            static_cast<std::streamsize>(bytes.size()));
+  if (!out) {
+    *error = "failed to write " + path;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint64_t llr_unit_scale_ns(LlrUnit unit) {
+  switch (unit) {
+    case LlrUnit::kNs:
+      return 1;
+    case LlrUnit::kUs:
+      return 1'000;
+    case LlrUnit::kMs:
+      return 1'000'000;
+    case LlrUnit::kS:
+      return 1'000'000'000;
+  }
+  return 1;
+}
+
+const char* llr_codec_name(LlrCodec codec) {
+  return codec == LlrCodec::kFor ? "for" : "xz";
+}
+
+bool parse_llr_codec(const std::string& text, LlrCodec* codec) {
+  for (LlrCodec candidate : {LlrCodec::kXz, LlrCodec::kFor}) {
+    if (text == llr_codec_name(candidate)) {
+      *codec = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* llr_unit_name(LlrUnit unit) {
+  switch (unit) {
+    case LlrUnit::kNs:
+      return "ns";
+    case LlrUnit::kUs:
+      return "us";
+    case LlrUnit::kMs:
+      return "ms";
+    case LlrUnit::kS:
+      return "s";
+  }
+  return "ns";
+}
+
+bool parse_llr_unit(const std::string& text, LlrUnit* unit) {
+  for (LlrUnit candidate :
+       {LlrUnit::kNs, LlrUnit::kUs, LlrUnit::kMs, LlrUnit::kS}) {
+    if (text == llr_unit_name(candidate)) {
+      *unit = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+LlrUnit llr_unit_from_min(uint64_t min_ns) {
+  if (min_ns >= 100'000'000'000ull) {
+    return LlrUnit::kS;
+  }
+  if (min_ns >= 100'000'000ull) {
+    return LlrUnit::kMs;
+  }
+  if (min_ns >= 100'000ull) {
+    return LlrUnit::kUs;
+  }
+  return LlrUnit::kNs;
+}
+
+uint64_t llr_convert(uint64_t value, LlrUnit from, LlrUnit to) {
+  const uint64_t from_scale = llr_unit_scale_ns(from);
+  const uint64_t to_scale = llr_unit_scale_ns(to);
+  return (value * from_scale + to_scale / 2) / to_scale;
+}
+
+size_t decode_varint_deltas(const uint8_t* data,
+                            size_t size,
+                            size_t count,
+                            uint64_t* out) {
+#if defined(__x86_64__)
+  if (cpu_has_bmi2()) {
+    return decode_bmi2(data, size, count, out);
+  }
+#endif
+  size_t consumed = 0;
+  uint64_t prev = 0;
+  return decode_scalar(data, size, count, out, &consumed, &prev);
+}
+
+void encode_varint_deltas(const uint64_t* values,
+                          size_t count,
+                          std::vector<uint8_t>* out) {
+  uint64_t prev = 0;
+  for (size_t i = 0; i < count; ++i) {
+    put_varint(zigzag_encode(values[i] - prev), out);
+    prev = values[i];
+  }
+}
+
+size_t decode_for_frames(const uint8_t* data,
+                         size_t size,
+                         size_t count,
+                         uint64_t* out) {
+  alignas(64) uint64_t frame[kLlrForFrame];
+  uint8_t padded[kLlrForFrame * 8 + kFrameSlack];
+  size_t pos = 0;
+  size_t n = 0;
+  uint64_t prev = 0;
+  while (n < count && pos < size) {
+    const unsigned width = data[pos++];
+    uint64_t ref = 0;
+    if (width > 64 || !get_varint(data, size, &pos, &ref)) {
+      break;
+    }
+    const size_t bytes = kLlrForFrame * width / 8;
+    if (size - pos < bytes) {
+      break;
+    }
+    const uint8_t* src = data + pos;
+    if (size - pos < bytes + kFrameSlack) {
+      std::memcpy(padded, src, bytes);
+      std::memset(padded + bytes, 0, kFrameSlack);
+      src = padded;
+    }
+    kUnpack[width](src, frame);
+    pos += bytes;
+    const size_t take = std::min(kLlrForFrame, count - n);
+    for (size_t i = 0; i < take; ++i) {
+      prev += zigzag_decode(ref + frame[i]);
+      out[n++] = prev;
+    }
+  }
+  return n;
+}
+
+void encode_for_frames(const uint64_t* values,
+                       size_t count,
+                       std::vector<uint8_t>* out) {
+  alignas(64) uint64_t frame[kLlrForFrame];
+  uint64_t prev = 0;
+  for (size_t first = 0; first < count; first += kLlrForFrame) {
+    const size_t take = std::min(kLlrForFrame, count - first);
+    uint64_t low = ~uint64_t{0};
+    uint64_t high = 0;
+    for (size_t i = 0; i < take; ++i) {
+      frame[i] = zigzag_encode(values[first + i] - prev);
+      prev = values[first + i];
+      low = std::min(low, frame[i]);
+      high = std::max(high, frame[i]);
+    }
+    std::fill(frame + take, frame + kLlrForFrame, low);
+    for (uint64_t& value : frame) {
+      value -= low;
+    }
+    const unsigned width =
+        high == low ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(high - low));
+    out->push_back(static_cast<uint8_t>(width));
+    put_varint(low, out);
+    const size_t used = out->size();
+    out->resize(used + kLlrForFrame * width / 8);
+    kPack[width](frame, out->data() + used);
+  }
+}
+
+bool read_llr_file(const std::string& path,
+                   unsigned threads,
+                   LlrHeader* header,
+                   std::vector<uint64_t>* values,
+                   std::string* error) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    *error = "cannot open " + path;
+    return false;
+  }
+  const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+  if (file.size() >= sizeof(kXzMagic) &&
+      std::memcmp(file.data(), kXzMagic, sizeof(kXzMagic)) == 0) {
+    return read_v1(file, header, values, error);
+  }
+  if (file.size() >= 4 && std::memcmp(file.data(), kMagicV2, 4) == 0) {
+    return read_v2(file, threads, header, values, error);
+  }
+  *error = "invalid raw file magic";
+  return false;
+}
+
+bool write_llr_file(const std::string& path,
+                    const LlrHeader& header_in,
+                    const std::vector<uint64_t>& values,
+                    std::string* error) {
+  LlrHeader header = header_in;
+  header.sample_count = values.size();
+  std::vector<uint8_t> bytes;
+  put_header(&bytes, header);
+
+  if (header.version == kLlrVersion1) {
+    if (header.codec != LlrCodec::kXz) {
+      *error = "LLR1 only supports the xz codec";
+      return false;
+    }
+    encode_varint_deltas(values.data(), values.size(), &bytes);
+    std::vector<uint8_t> compressed;
+    return xz_compress(bytes, &compressed, error) &&
+           write_file(path, compressed, error);
+  }
+  if (header.block_samples == 0) {
+    *error = "block_samples must be positive";
+    return false;
+  }
+
+  std::vector<uint8_t> index;
+  std::vector<uint8_t> payload;
+  std::vector<uint8_t> compressed;
+  uint32_t block_count = 0;
+  for (size_t first = 0; first < values.size();
+       first += header.block_samples) {
+    const size_t count =
+        std::min<size_t>(header.block_samples, values.size() - first);
+    if (header.codec == LlrCodec::kFor) {
+      compressed.clear();
+      encode_for_frames(values.data() + first, count, &compressed);
+    } else {
+      payload.clear();
+      encode_varint_deltas(values.data() + first, count, &payload);
+      if (!xz_compress(payload, &compressed, error)) {
+        return false;
+      }
+    }
+    put_block_entry(&index, bytes.size(), compressed.size(),
+                    values.data() + first, count);
+    bytes.insert(bytes.end(), compressed.begin(), compressed.end());
+    ++block_count;
+  }
+  const uint64_t index_offset = bytes.size();
+  bytes.insert(bytes.end(), index.begin(), index.end());
+  put<uint64_t>(&bytes, index_offset);
+  put<uint32_t>(&bytes, block_count);
+  bytes.insert(bytes.end(), kIndexMagic, kIndexMagic + 4);
+  return write_file(path, bytes, error);
+}
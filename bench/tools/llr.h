@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Native reader/writer for the raw sample formats defined in
+// scripts/raw_format.py (LLR1: one xz stream; LLR2: independently
+// xz-compressed blocks plus a block index). The layouts must stay
+// byte-compatible with the Python implementation.
+enum class LlrUnit : uint8_t {
+  kNs = 0,
+  kUs = 1,
+  kMs = 2,
+  kS = 3,
+};
+
+// LLR2 block codec, stored in the header's reserved u16 (see
+// raw_format.CODEC_NAMES). kFor is delta + frame-of-reference bit packing.
+enum class LlrCodec : uint16_t {
+  kXz = 0,
+  kFor = 1,
+};
+
+constexpr uint32_t kLlrVersion1 = 1;
+constexpr uint32_t kLlrVersion2 = 2;
+constexpr uint32_t kLlrDefaultBlockSamples = 65536;
+constexpr size_t kLlrHistBuckets = 65;
+constexpr size_t kLlrForFrame = 128;
+
+struct LlrHeader {
+  uint32_t version = kLlrVersion2;
+  LlrUnit unit = LlrUnit::kNs;
+  std::string case_name;
+  std::vector<std::string> tags;
+  std::vector<std::string> args;
+  uint64_t iters = 0;
+  uint64_t warmup = 0;
+  int32_t pin_cpu = -1;
+  uint64_t sample_count = 0;
+  // LLR2 only.
+  uint32_t block_samples = kLlrDefaultBlockSamples;
+  LlrCodec codec = LlrCodec::kXz;
+};
+
+uint64_t llr_unit_scale_ns(LlrUnit unit);
+const char* llr_unit_name(LlrUnit unit);
+bool parse_llr_unit(const std::string& text, LlrUnit* unit);
+const char* llr_codec_name(LlrCodec codec);
+bool parse_llr_codec(const std::string& text, LlrCodec* codec);
+// Same thresholds as raw_format.choose_unit_from_min.
+LlrUnit llr_unit_from_min(uint64_t min_ns);
+// Rounds half up, like the Python encoder.
+uint64_t llr_convert(uint64_t value, LlrUnit from, LlrUnit to);
+
+// Reads either version; `values` are in header->unit. LLR2 blocks are
+// decompressed on up to `threads` threads (0 = hardware concurrency).
+bool read_llr_file(const std::string& path,
+                   unsigned threads,
+                   LlrHeader* header,
+                   std::vector<uint64_t>* values,
+                   std::string* error);
+// Writes header.version; `values` are already in header.unit.
+// header.sample_count is taken from values.size().
+bool write_llr_file(const std::string& path,
+                    const LlrHeader& header,
+                    const std::vector<uint64_t>& values,
+                    std::string* error);
+
+// Zigzag varint delta coding, the payload of both versions. The decoder uses
+// an SSE2 terminator scan with BMI2 bit extraction when the CPU has it and a
+// scalar loop otherwise. Returns the number of values decoded (stops at
+// `count` or the end of the input; a truncated varint ends decoding).
+size_t decode_varint_deltas(const uint8_t* data,
+                            size_t size,
+                            size_t count,
+                            uint64_t* out);
+void encode_varint_deltas(const uint64_t* values,
+                          size_t count,
+                          std::vector<uint8_t>* out);
+
+// kFor payload: zigzag deltas in kLlrForFrame-value frames, each a u8 bit
+// width, a varint reference and the frame packed LSB-first into 16 * width
+// bytes. Pack/unpack kernels are specialised per width so the compiler can
+// unroll and vectorise them. Returns the number of values decoded; a
+// truncated or corrupt frame ends decoding early.
+size_t decode_for_frames(const uint8_t* data,
+                         size_t size,
+                         size_t count,
+                         uint64_t* out);
+void encode_for_frames(const uint64_t* values,
+                       size_t count,
+                       std::vector<uint8_t>* out);
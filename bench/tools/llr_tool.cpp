@@ -0,0 +1,415 @@
+// Native counterpart of scripts/raw_format.py for large raw files:
+//   llr_tool encode [--unit U] [--format llr2|llr1|bin] [--codec xz|for]
+//                   [--block N] [--case NAME] [--tag T]... [--arg A]...
+//                   [--iters N] [--warmup N] [--pin-cpu N] raw.csv out
+//   llr_tool decode in out.csv
+//   llr_tool cat [--unit U] [--start I] [--stop I] [--binary] in
+//   llr_tool stats [--unit U] in
+//   llr_tool convert [--format llr2|llr1|bin] [--codec xz|for] [--block N]
+//                    in out
+// Inputs may also be raw.bin files, which are mmapped rather than decoded.
+// Every command accepts --threads N (0 = all CPUs) for LLR2 block decoding.
+// `cat --binary` writes little-endian uint64 values to stdout; results_lib
+// uses it as its fast path.
+#include "llr.h"
+#include "raw_bin.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+// LlrHeader::version for raw.bin input/output.
+constexpr uint32_t kFormatRawBin = 0;
+
+struct Options {
+  std::string command;
+  std::vector<std::string> positional;
+  std::vector<std::string> tags;
+  std::vector<std::string> args;
+  std::string case_name;
+  // Header fields for encode; iters defaults to the sample count.
+  uint64_t iters = std::numeric_limits<uint64_t>::max();
+  uint64_t warmup = 0;
+  int32_t pin_cpu = -1;
+  std::string unit = "auto";
+  uint32_t version = kLlrVersion2;
+  uint32_t block_samples = kLlrDefaultBlockSamples;
+  LlrCodec codec = LlrCodec::kXz;
+  unsigned threads = 0;
+  uint64_t start = 0;
+  uint64_t stop = std::numeric_limits<uint64_t>::max();
+  bool binary = false;
+};
+
+void usage() {
+  std::cerr
+      << "usage: llr_tool <encode|decode|cat|stats|convert> [options] ...\n"
+         "  encode  [--unit U] [--format llr2|llr1|bin] [--codec xz|for]\n"
+         "          [--block N] [--case NAME] [--tag T]... [--arg A]...\n"
+         "          [--iters N] [--warmup N] [--pin-cpu N] raw.csv out\n"
+         "  decode  in out.csv\n"
+         "  cat     [--unit U] [--start I] [--stop I] [--binary] in\n"
+         "  stats   [--unit U] in\n"
+         "  convert [--format llr2|llr1|bin] [--codec xz|for] [--block N] in out\n"
+         "  --threads N  LLR2 decode threads (default 0 = all CPUs)\n";
+}
+
+[[noreturn]] void fail(const std::string& message) {
+  std::cerr << "llr_tool: " << message << "\n";
+  std::exit(1);
+}
+
+uint64_t parse_number(const std::string& flag, const std::string& text) {
+  try {
+    size_t used = 0;
+    const unsigned long long value = std::stoull(text, &used);
+    if (used == text.size()) {
+      return value;
+    }
+  } catch (const std::exception&) {
+  }
+  fail("invalid value for " + flag + ": " + text);
+}
+
+Options parse_options(int argc, char** argv) {
+  if (argc < 2) {
+    usage();
+    std::exit(2);
+  }
+  Options options;
+  options.command = argv[1];
+  for (int i = 2; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        fail("missing value for " + arg);
+      }
+      return argv[++i];
+    };
+    if (arg == "--unit") {
+      options.unit = value();
+    } else if (arg == "--format") {
+      const std::string format = value();
+      if (format == "llr1") {
+        options.version = kLlrVersion1;
+      } else if (format == "llr2") {
+        options.version = kLlrVersion2;
+      } else if (format == "bin") {
+        options.version = kFormatRawBin;
+      } else {
+        fail("--format must be llr2, llr1 or bin");
+      }
+    } else if (arg == "--codec") {
+      if (!parse_llr_codec(value(), &options.codec)) {
+        fail("--codec must be xz or for");
+      }
+    } else if (arg == "--block") {
+      options.block_samples = static_cast<uint32_t>(
+          std::clamp<uint64_t>(parse_number(arg, value()), 1, UINT32_MAX));
+    } else if (arg == "--case") {
+      options.case_name = value();
+    } else if (arg == "--tag") {
+      options.tags.push_back(value());
+    } else if (arg == "--arg") {
+      options.args.push_back(value());
+    } else if (arg == "--iters") {
+      options.iters = parse_number(arg, value());
+    } else if (arg == "--warmup") {
+      options.warmup = parse_number(arg, value());
+    } else if (arg == "--pin-cpu") {
+      const std::string text = value();
+      options.pin_cpu = text == "-1" ? -1
+                                     : static_cast<int32_t>(std::min<uint64_t>(
+                                           parse_number(arg, text), INT32_MAX));
+    } else if (arg == "--threads") {
+      options.threads = static_cast<unsigned>(parse_number(arg, value()));
+    } else if (arg == "--start") {
+      options.start = parse_number(arg, value());
+    } else if (arg == "--stop") {
+      options.stop = parse_number(arg, value());
+    } else if (arg == "--binary") {
+      options.binary = true;
+    } else if (arg == "--help" || arg == "-h") {
+      usage();
+      std::exit(0);
+    } else if (arg.starts_with("--")) {
+      fail("unknown option " + arg);
+    } else {
+      options.positional.push_back(arg);
+    }
+  }
+  return options;
+}
+
+void expect_positional(const Options& options, size_t count) {
+  if (options.positional.size() != count) {
+    usage();
+    std::exit(2);
+  }
+}
+
+void open_bin_or_fail(const std::string& path, MappedRawBin* bin) {
+  std::string error;
+  if (!bin->open(path, &error)) {
+    fail(error);
+  }
+  if (bin->header().unit > static_cast<uint8_t>(LlrUnit::kS)) {
+    fail(path + ": invalid unit enum");
+  }
+}
+
+void read_or_fail(const Options& options,
+                  LlrHeader* header,
+                  std::vector<uint64_t>* values) {
+  if (is_raw_bin_file(options.positional[0])) {
+    MappedRawBin bin;
+    open_bin_or_fail(options.positional[0], &bin);
+    header->version = kFormatRawBin;
+    header->unit = static_cast<LlrUnit>(bin.header().unit);
+    header->case_name = bin.header().case_name;
+    header->iters = bin.header().iters;
+    header->warmup = bin.header().warmup;
+    header->pin_cpu = bin.header().pin_cpu;
+    header->sample_count = bin.size();
+    values->resize(bin.size());
+    for (size_t i = 0; i < bin.size(); ++i) {
+      (*values)[i] = bin[i];
+    }
+    return;
+  }
+  std::string error;
+  if (!read_llr_file(options.positional[0], options.threads, header, values,
+                     &error)) {
+    fail(options.positional[0] + ": " + error);
+  }
+}
+
+// Converts `values` in place to the requested unit ("auto" keeps the stored
+// unit, matching read_llr(unit=None) in Python).
+LlrUnit to_output_unit(const std::string& unit_text,
+                       LlrUnit stored,
+                       std::vector<uint64_t>* values) {
+  if (unit_text == "auto") {
+    return stored;
+  }
+  LlrUnit unit = LlrUnit::kNs;
+  if (!parse_llr_unit(unit_text, &unit)) {
+    fail("--unit must be ns, us, ms, s or auto");
+  }
+  if (unit != stored) {
+    for (uint64_t& value : *values) {
+      value = llr_convert(value, stored, unit);
+    }
+  }
+  return unit;
+}
+
+void write_or_fail(const std::string& path,
+                   const LlrHeader& header,
+                   const std::vector<uint64_t>& values) {
+  std::string error;
+  if (header.version == kFormatRawBin) {
+    RawBinHeader bin_header;
+    bin_header.unit = static_cast<uint8_t>(header.unit);
+    bin_header.case_name = header.case_name;
+    bin_header.iters = header.iters;
+    bin_header.warmup = header.warmup;
+    bin_header.pin_cpu = header.pin_cpu;
+    if (!write_raw_bin(path, bin_header, values, &error)) {
+      fail(path + ": " + error);
+    }
+    return;
+  }
+  if (!write_llr_file(path, header, values, &error)) {
+    fail(error);
+  }
+}
+
+int run_encode(const Options& options) {
+  expect_positional(options, 2);
+  std::ifstream in(options.positional[0]);
+  if (!in) {
+    fail("cannot open " + options.positional[0]);
+  }
+  std::vector<uint64_t> values;
+  std::string line;
+  std::getline(in, line);  // iter,ns
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    const size_t comma = line.find(',');
+    if (comma == std::string::npos) {
+      fail("invalid raw.csv row: " + line);
+    }
+    values.push_back(parse_number("raw.csv", line.substr(comma + 1)));
+  }
+
+  LlrHeader header;
+  header.version = options.version;
+  header.block_samples = options.block_samples;
+  header.codec = options.codec;
+  header.case_name = options.case_name;
+  header.tags = options.tags;
+  header.args = options.args;
+  header.iters = options.iters == std::numeric_limits<uint64_t>::max()
+                     ? values.size()
+                     : options.iters;
+  header.warmup = options.warmup;
+  header.pin_cpu = options.pin_cpu;
+  if (options.unit == "auto") {
+    const uint64_t min_ns =
+        values.empty() ? 0 : *std::min_element(values.begin(), values.end());
+    header.unit = llr_unit_from_min(min_ns);
+  } else if (!parse_llr_unit(options.unit, &header.unit)) {
+    fail("--unit must be ns, us, ms, s or auto");
+  }
+  for (uint64_t& value : values) {
+    value = llr_convert(value, LlrUnit::kNs, header.unit);
+  }
+  write_or_fail(options.positional[1], header, values);
+  return 0;
+}
+
+int run_decode(const Options& options) {
+  expect_positional(options, 2);
+  LlrHeader header;
+  std::vector<uint64_t> values;
+  read_or_fail(options, &header, &values);
+  std::ofstream out(options.positional[1], std::ios::trunc);
+  out << "iter,ns\n";
+  const uint64_t scale = llr_unit_scale_ns(header.unit);
+  for (size_t i = 0; i < values.size(); ++i) {
+    out << i << ',' << values[i] * scale << '\n';
+  }
+  if (!out) {
+    fail("failed to write " + options.positional[1]);
+  }
+  return 0;
+}
+
+// Streams a uint64 raw.bin slice straight from the mapping.
+bool cat_mapped(const Options& options) {
+  MappedRawBin bin;
+  open_bin_or_fail(options.positional[0], &bin);
+  const char* stored = llr_unit_name(static_cast<LlrUnit>(bin.header().unit));
+  if (bin.value_bytes() != 8 ||
+      (options.unit != "auto" && options.unit != stored)) {
+    return false;
+  }
+  const size_t stop = std::min<uint64_t>(options.stop, bin.size());
+  const size_t start = std::min<uint64_t>(options.start, stop);
+  std::fwrite(static_cast<const uint64_t*>(bin.data()) + start,
+              sizeof(uint64_t), stop - start, stdout);
+  return true;
+}
+
+int run_cat(const Options& options) {
+  expect_positional(options, 1);
+  if (options.binary && is_raw_bin_file(options.positional[0]) &&
+      cat_mapped(options)) {
+    return std::fflush(stdout) == 0 ? 0 : 1;
+  }
+  LlrHeader header;
+  std::vector<uint64_t> values;
+  read_or_fail(options, &header, &values);
+  const size_t stop = std::min<uint64_t>(options.stop, values.size());
+  const size_t start = std::min<uint64_t>(options.start, stop);
+  values.erase(values.begin() + stop, values.end());
+  values.erase(values.begin(), values.begin() + start);
+  to_output_unit(options.unit, header.unit, &values);
+  if (options.binary) {
+    // LE hosts only, like the rest of the bench.
+    std::fwrite(values.data(), sizeof(uint64_t), values.size(), stdout);
+  } else {
+    std::string text;
+    for (uint64_t value : values) {
+      text += std::to_string(value);
+      text += '\n';
+    }
+    std::fwrite(text.data(), 1, text.size(), stdout);
+  }
+  return std::fflush(stdout) == 0 ? 0 : 1;
+}
+
+int run_stats(const Options& options) {
+  expect_positional(options, 1);
+  LlrHeader header;
+  std::vector<uint64_t> values;
+  read_or_fail(options, &header, &values);
+  const LlrUnit unit = to_output_unit(options.unit, header.unit, &values);
+  std::cout << "case," << header.case_name << "\n"
+            << "format,"
+            << (header.version == kFormatRawBin
+                    ? std::string("bin")
+                    : "llr" + std::to_string(header.version))
+            << "\n";
+  if (header.version == kLlrVersion2) {
+    std::cout << "codec," << llr_codec_name(header.codec) << "\n";
+  }
+  std::cout << "unit," << llr_unit_name(unit) << "\n"
+            << "count," << values.size() << "\n";
+  if (values.empty()) {
+    return 0;
+  }
+  long double sum = 0;
+  for (uint64_t value : values) {
+    sum += value;
+  }
+  std::sort(values.begin(), values.end());
+  auto quantile = [&](double p) {
+    return values[static_cast<size_t>(p * (values.size() - 1))];
+  };
+  std::cout << "min," << values.front() << "\n"
+            << "p50," << quantile(0.50) << "\n"
+            << "p95," << quantile(0.95) << "\n"
+            << "p99," << quantile(0.99) << "\n"
+            << "p999," << quantile(0.999) << "\n"
+            << "max," << values.back() << "\n"
+            << "mean," << std::fixed << std::setprecision(1)
+            << static_cast<double>(sum / values.size()) << "\n";
+  return 0;
+}
+
+int run_convert(const Options& options) {
+  expect_positional(options, 2);
+  LlrHeader header;
+  std::vector<uint64_t> values;
+  read_or_fail(options, &header, &values);
+  header.version = options.version;
+  header.block_samples = options.block_samples;
+  header.codec = options.codec;
+  write_or_fail(options.positional[1], header, values);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const Options options = parse_options(argc, argv);
+  if (options.command == "encode") {
+    return run_encode(options);
+  }
+  if (options.command == "decode") {
+    return run_decode(options);
+  }
+  if (options.command == "cat") {
+    return run_cat(options);
+  }
+  if (options.command == "stats") {
+    return run_stats(options);
+  }
+  if (options.command == "convert") {
+    return run_convert(options);
+  }
+  usage();
+  return 2;
+}
@@ -15,6 +15,7 @@ PATH_COLUMNS = [
     "stdout_path",
     "raw_csv_path",
     "raw_llr_path",
+    "sketch_path",
     "bench_path",
 ]
 
@@ -528,3 +529,54 @@ def plot_profile(
         plt.title(title)
     plt.tight_layout()
     plt.show()
+
+
+def load_c2c_matrix(path: str | Path, metric: str = "p50") -> pd.DataFrame:
+    """Pivot a c2c_latency matrix.csv into a symmetric cpu x cpu DataFrame.
+
+    matrix.csv stores one row per measured pair (cpu_a < cpu_b); the
+    round trip is symmetric, so each value is mirrored. Unmeasured cells,
+    including the diagonal, are NaN.
+    """
+    df = pd.read_csv(path)
+    if metric not in df.columns:
+        raise ValueError(f"Metric not found: {metric}")
+    cpus = sorted(set(df["cpu_a"]).union(df["cpu_b"]))
+    matrix = pd.DataFrame(float("nan"), index=cpus, columns=cpus)
+    for row in df.itertuples(index=False):
+        value = float(getattr(row, metric))
+        matrix.loc[row.cpu_a, row.cpu_b] = value
+        matrix.loc[row.cpu_b, row.cpu_a] = value
+    matrix.index.name = "cpu_a"
+    matrix.columns.name = "cpu_b"
+    return matrix
+
+
+def plot_c2c_heatmap(
+    matrix: pd.DataFrame,
+    *,
+    metric: str = "p50",
+    unit_label: str = "ns",
+    annotate: bool | None = None,
+    title: str | None = None,
+) -> None:
+    import matplotlib.pyplot as plt
+    import seaborn as sns
+
+    if matrix.empty:
+        return
+    if annotate is None:
+        annotate = len(matrix) <= 16
+    size = max(5, 0.45 * len(matrix) + 3)
+    plt.figure(figsize=(size + 1, size))
+    sns.heatmap(
+        matrix,
+        annot=annotate,
+        fmt=".0f",
+        cmap="viridis",
+        square=True,
+        cbar_kws={"label": f"{metric} round trip ({unit_label})"},
+    )
+    plt.title(title or f"Core-to-core round trip ({metric})")
+    plt.tight_layout()
+    plt.show()
@@ -4,14 +4,60 @@ from __future__ import annotations
 
 import csv
 import lzma
+import mmap
+import os
+import shutil
 import struct
-from dataclasses import dataclass
+import subprocess
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Iterable, Iterator, List, Tuple
+from typing import Iterable, Iterator, List, Optional, Sequence, Tuple
 
 MAGIC = b"LLR1"
 VERSION = 1
 
+# LLR2: an uncompressed header, independently xz-compressed blocks of
+# block_samples samples, a block index and a fixed 16-byte trailer:
+#   header   MAGIC_V2, <BBH version/unit/reserved, the LLR1 fixed fields,
+#            case/tags/args, <I block_samples
+#   blocks   xz stream of zigzag varint deltas; the delta chain restarts at 0
+#            in every block, so each block decodes on its own
+#   index    per block <QIIQQ offset/compressed_len/count/min/max, then
+#            HIST_BUCKETS <I counts, where bucket b holds the values whose
+#            bit_length() is b (all in the header's unit)
+#   trailer  <QI index_offset/block_count, INDEX_MAGIC
+# The header's reserved u16 holds the block codec (CODEC_NAMES index):
+#   xz   zigzag varint deltas in an xz stream (default)
+#   for  zigzag deltas in FOR_FRAME-sample frames, each a u8 bit width, a
+#        varint reference (the frame minimum) and FOR_FRAME values minus the
+#        reference packed LSB-first into 16 * width bytes; the last frame is
+#        padded with the reference. No entropy stage, so it encodes and
+#        decodes at memory speed in the native tool.
+MAGIC_V2 = b"LLR2"
+VERSION_V2 = 2
+INDEX_MAGIC = b"LLRI"
+XZ_MAGIC = b"\xfd7zXZ\x00"
+DEFAULT_BLOCK_SAMPLES = 65536
+HIST_BUCKETS = 65
+LZMA_PRESET = 9 | lzma.PRESET_EXTREME
+CODEC_NAMES = ("xz", "for")
+CODEC_IDS = {name: idx for idx, name in enumerate(CODEC_NAMES)}
+FOR_FRAME = 128
+
+_BLOCK_ENTRY = struct.Struct("<QIIQQ" + "I" * HIST_BUCKETS)
+_TRAILER = struct.Struct("<QI4s")
+
+# raw.bin: uncompressed, memory-mappable samples (see bench/core/raw_bin.h).
+# A RAW_BIN_PAGE-byte header, then a little-endian uint32/uint64 array at
+# data_offset:
+#   <4sBBHQQQQiI magic/version/unit/value_bytes/data_offset/sample_count/
+#                iters/warmup/pin_cpu/case_len, then the case name
+RAW_BIN_MAGIC = b"LLRB"
+RAW_BIN_VERSION = 1
+RAW_BIN_PAGE = 4096
+RAW_BIN_HEADER = struct.Struct("<4sBBHQQQQiI")
+
 UNIT_NAMES = ("ns", "us", "ms", "s")
 UNIT_ENUM = {name: idx for idx, name in enumerate(UNIT_NAMES)}
 UNIT_SCALE_NS = {
@@ -32,6 +78,7 @@ class RawHeader:
     pin_cpu: int
     unit: str
     sample_count: int
+    codec: str = "xz"
 
 
 def choose_unit_from_min(min_ns: int) -> str:
@@ -111,12 +158,15 @@ def _read_varint(data: bytes, offset: int) -> Tuple[int, int]:
             raise ValueError("varint too large")
 
 
-def _write_header(handle, header: RawHeader) -> None:
+def _write_header(
+    handle, header: RawHeader, magic: bytes = MAGIC, version: int = VERSION
+) -> None:
     case_bytes = header.case_name.encode("utf-8")
     tag_bytes = [tag.encode("utf-8") for tag in header.tags]
     arg_bytes = [arg.encode("utf-8") for arg in header.args]
-    handle.write(MAGIC)
-    handle.write(struct.pack("<BBH", VERSION, UNIT_ENUM[header.unit], 0))
+    handle.write(magic)
+    codec_id = CODEC_IDS[header.codec] if version == VERSION_V2 else 0
+    handle.write(struct.pack("<BBH", version, UNIT_ENUM[header.unit], codec_id))
     handle.write(
         struct.pack(
             "<QQQiI",
@@ -138,16 +188,20 @@ def _write_header(handle, header: RawHeader) -> None:
         handle.write(arg)
 
 
-def _read_header(handle) -> RawHeader:
+def _read_header(
+    handle, magic_expected: bytes = MAGIC, version_expected: int = VERSION
+) -> RawHeader:
     magic = handle.read(4)
-    if magic != MAGIC:
+    if magic != magic_expected:
         raise ValueError("invalid raw file magic")
     header_bytes = handle.read(4)
     if len(header_bytes) != 4:
         raise ValueError("truncated raw header")
-    version, unit_enum, _reserved = struct.unpack("<BBH", header_bytes)
-    if version != VERSION:
+    version, unit_enum, codec_id = struct.unpack("<BBH", header_bytes)
+    if version != version_expected:
         raise ValueError(f"unsupported raw version: {version}")
+    if codec_id >= len(CODEC_NAMES):
+        raise ValueError(f"unknown codec id: {codec_id}")
     if unit_enum >= len(UNIT_NAMES):
         raise ValueError(f"invalid unit enum: {unit_enum}")
     unit = UNIT_NAMES[unit_enum]
@@ -197,6 +251,7 @@ def _read_header(handle) -> RawHeader:
         pin_cpu=pin_cpu,
         unit=unit,
         sample_count=sample_count,
+        codec=CODEC_NAMES[codec_id],
     )
 
 
@@ -221,22 +276,42 @@ def _encode_samples(
         handle.write(buffer)
 
 
+def _resolve_unit(unit: str, min_ns: int) -> str:
+    if unit == "auto":
+        unit = choose_unit_from_min(min_ns)
+    if unit not in UNIT_ENUM:
+        raise ValueError(f"unknown unit: {unit}")
+    return unit
+
+
+def _resolve_codec(codec: str, version: int) -> str:
+    if codec not in CODEC_IDS:
+        raise ValueError(f"unknown codec: {codec}")
+    if codec != "xz" and version != VERSION_V2:
+        raise ValueError(f"codec {codec} requires LLR2")
+    return codec
+
+
 def encode_samples_to_llr(
     samples: List[int],
     out_path: Path,
     header: RawHeader,
     unit: str = "auto",
+    version: int = VERSION,
+    block_samples: int = DEFAULT_BLOCK_SAMPLES,
+    codec: str = "xz",
 ) -> RawHeader:
-    if unit == "auto":
-        min_ns = min(samples) if samples else 0
-        unit = choose_unit_from_min(min_ns)
-    if unit not in UNIT_ENUM:
-        raise ValueError(f"unknown unit: {unit}")
+    unit = _resolve_unit(unit, min(samples) if samples else 0)
     header.unit = unit
     header.sample_count = len(samples)
-    preset = 9 | lzma.PRESET_EXTREME
+    header.codec = _resolve_codec(codec, version)
+    if version == VERSION_V2:
+        _write_llr2(samples, out_path, header, block_samples)
+        return header
+    if version != VERSION:
+        raise ValueError(f"unsupported raw version: {version}")
 
-    with lzma.open(out_path, "wb", preset=preset) as handle:
+    with lzma.open(out_path, "wb", preset=LZMA_PRESET) as handle:
         _write_header(handle, header)
         _encode_samples(samples, handle, unit)
 
@@ -248,63 +323,560 @@ def encode_raw_csv_to_llr(
     out_path: Path,
     header: RawHeader,
     unit: str = "auto",
+    version: int = VERSION,
+    block_samples: int = DEFAULT_BLOCK_SAMPLES,
+    codec: str = "xz",
 ) -> RawHeader:
+    if version == VERSION_V2:
+        return encode_samples_to_llr(
+            read_raw_csv_list(raw_csv_path),
+            out_path,
+            header,
+            unit=unit,
+            version=version,
+            block_samples=block_samples,
+            codec=codec,
+        )
+    _resolve_codec(codec, version)
     min_ns, count = _scan_raw_csv(raw_csv_path)
-    if unit == "auto":
-        unit = choose_unit_from_min(min_ns)
-    if unit not in UNIT_ENUM:
-        raise ValueError(f"unknown unit: {unit}")
+    unit = _resolve_unit(unit, min_ns)
     header.unit = unit
     header.sample_count = count
 
-    scale = UNIT_SCALE_NS[unit]
-    preset = 9 | lzma.PRESET_EXTREME
-
-    with lzma.open(out_path, "wb", preset=preset) as handle:
+    with lzma.open(out_path, "wb", preset=LZMA_PRESET) as handle:
         _write_header(handle, header)
         _encode_samples(read_raw_csv_samples(raw_csv_path), handle, unit)
 
     return header
 
 
-def iter_llr_samples(path: Path, unit: str = "ns") -> Iterator[int]:
-    with lzma.open(path, "rb") as handle:
-        header = _read_header(handle)
-        payload = handle.read()
-    if unit not in UNIT_ENUM:
-        raise ValueError(f"unknown unit: {unit}")
-    from_scale = UNIT_SCALE_NS[header.unit]
-    to_scale = UNIT_SCALE_NS[unit]
-    if to_scale == 0:
-        raise ValueError("invalid unit scale")
+def find_llr_tool() -> Optional[str]:
+    """Locate the native llr_tool: $LLR_TOOL (empty disables), the repo's
+    build/ directory, then PATH."""
+    env = os.environ.get("LLR_TOOL")
+    if env is not None:
+        return env or None
+    built = Path(__file__).resolve().parent.parent / "build" / "llr_tool"
+    if built.exists():
+        return str(built)
+    return shutil.which("llr_tool")
+
+
+def encode_raw_csv_native(
+    raw_csv_path: Path,
+    out_path: Path,
+    header: RawHeader,
+    unit: str = "auto",
+    version: int = VERSION,
+    block_samples: int = DEFAULT_BLOCK_SAMPLES,
+    codec: str = "xz",
+) -> Optional[RawHeader]:
+    """encode_raw_csv_to_llr through llr_tool, which writes the same format
+    in a fraction of the time. Returns None (and writes nothing usable) when the
+    tool is missing or fails, so callers fall back to the Python encoder."""
+    tool = find_llr_tool()
+    if tool is None:
+        return None
+    _resolve_codec(codec, version)
+    cmd = [
+        tool,
+        "encode",
+        "--unit",
+        unit,
+        "--format",
+        "llr2" if version == VERSION_V2 else "llr1",
+        "--codec",
+        codec,
+        "--block",
+        str(block_samples),
+        "--case",
+        header.case_name,
+        "--iters",
+        str(header.iters),
+        "--warmup",
+        str(header.warmup),
+        "--pin-cpu",
+        str(header.pin_cpu),
+    ]
+    for tag in header.tags:
+        cmd += ["--tag", tag]
+    for arg in header.args:
+        cmd += ["--arg", arg]
+    cmd += [str(raw_csv_path), str(out_path)]
+    try:
+        subprocess.run(cmd, check=True, capture_output=True)
+        return read_llr_header(out_path)
+    except (OSError, ValueError, subprocess.CalledProcessError):
+        return None
+
+
+@dataclass
+class BlockInfo:
+    """One LLR2 block: where it lives, its sample range and its summary.
+
+    min/max/hist are in the file's stored unit. LLR1 files are presented as a
+    single block with offset -1 (summary computed on load).
+    """
+
+    offset: int
+    compressed_len: int
+    first: int
+    count: int
+    min: int
+    max: int
+    hist: List[int] = field(default_factory=lambda: [0] * HIST_BUCKETS)
+
+
+def _summarize(values: Sequence[int]) -> Tuple[int, int, List[int]]:
+    hist = [0] * HIST_BUCKETS
+    for value in values:
+        hist[min(value.bit_length(), HIST_BUCKETS - 1)] += 1
+    if not values:
+        return 0, 0, hist
+    return min(values), max(values), hist
+
+
+def _zigzag_deltas(values: Sequence[int]) -> List[int]:
+    deltas = []
+    prev = 0
+    for value in values:
+        deltas.append(_zigzag_encode(value - prev))
+        prev = value
+    return deltas
 
+
+def _pack_frames(deltas: Sequence[int]) -> bytes:
+    buffer = bytearray()
+    for first in range(0, len(deltas), FOR_FRAME):
+        frame = deltas[first : first + FOR_FRAME]
+        ref = min(frame)
+        width = (max(frame) - ref).bit_length()
+        buffer.append(width)
+        _write_varint(ref, buffer)
+        if width:
+            packed = 0
+            for i, delta in enumerate(frame):
+                packed |= (delta - ref) << (i * width)
+            buffer += packed.to_bytes(FOR_FRAME * width // 8, "little")
+    return bytes(buffer)
+
+
+def _unpack_frames(payload: bytes, count: int) -> List[int]:
+    values: List[int] = []
     offset = 0
     prev = 0
-    count = 0
-    while offset < len(payload) and count < header.sample_count:
+    while len(values) < count:
+        n = min(FOR_FRAME, count - len(values))
+        if offset >= len(payload):
+            raise ValueError("truncated frame")
+        width = payload[offset]
+        if width > 64:
+            raise ValueError(f"invalid frame width: {width}")
+        ref, offset = _read_varint(payload, offset + 1)
+        if width == 0:
+            delta = _zigzag_decode(ref)
+            for _ in range(n):
+                prev += delta
+                values.append(prev)
+            continue
+        size = FOR_FRAME * width // 8
+        if offset + size > len(payload):
+            raise ValueError("truncated frame")
+        packed = int.from_bytes(payload[offset : offset + size], "little")
+        offset += size
+        mask = (1 << width) - 1
+        for i in range(n):
+            prev += _zigzag_decode(ref + ((packed >> (i * width)) & mask))
+            values.append(prev)
+    return values
+
+
+def _encode_block(values: Sequence[int], codec: str = "xz") -> bytes:
+    if codec == "for":
+        return _pack_frames(_zigzag_deltas(values))
+    buffer = bytearray()
+    for delta in _zigzag_deltas(values):
+        _write_varint(delta, buffer)
+    return lzma.compress(bytes(buffer), preset=LZMA_PRESET)
+
+
+def _decode_block(payload: bytes, count: int, codec: str = "xz") -> List[int]:
+    if codec == "for":
+        return _unpack_frames(payload, count)
+    return _decode_varints(lzma.decompress(payload), count)
+
+
+def _decode_varints(payload: bytes, count: int) -> List[int]:
+    values: List[int] = []
+    offset = 0
+    prev = 0
+    while offset < len(payload) and len(values) < count:
         raw_value, offset = _read_varint(payload, offset)
-        delta = _zigzag_decode(raw_value)
-        prev += delta
-        count += 1
-        ns_value = prev * from_scale
-        yield (ns_value + (to_scale // 2)) // to_scale
+        prev += _zigzag_decode(raw_value)
+        values.append(prev)
+    return values
 
 
-def read_llr(path: Path, unit: str = "ns") -> Tuple[RawHeader, List[int]]:
+def _write_llr2(
+    samples: Sequence[int],
+    out_path: Path,
+    header: RawHeader,
+    block_samples: int,
+) -> None:
+    if block_samples <= 0:
+        raise ValueError("block_samples must be positive")
+    scale = UNIT_SCALE_NS[header.unit]
+    blocks: List[BlockInfo] = []
+    with Path(out_path).open("wb") as handle:
+        _write_header(handle, header, MAGIC_V2, VERSION_V2)
+        handle.write(struct.pack("<I", block_samples))
+        for first in range(0, len(samples), block_samples):
+            scaled = [
+                (value + (scale // 2)) // scale
+                for value in samples[first : first + block_samples]
+            ]
+            payload = _encode_block(scaled, header.codec)
+            low, high, hist = _summarize(scaled)
+            blocks.append(
+                BlockInfo(
+                    offset=handle.tell(),
+                    compressed_len=len(payload),
+                    first=first,
+                    count=len(scaled),
+                    min=low,
+                    max=high,
+                    hist=hist,
+                )
+            )
+            handle.write(payload)
+        index_offset = handle.tell()
+        for block in blocks:
+            handle.write(
+                _BLOCK_ENTRY.pack(
+                    block.offset,
+                    block.compressed_len,
+                    block.count,
+                    block.min,
+                    block.max,
+                    *block.hist,
+                )
+            )
+        handle.write(_TRAILER.pack(index_offset, len(blocks), INDEX_MAGIC))
+
+
+def _convert(value: int, from_scale: int, to_scale: int) -> int:
+    return (value * from_scale + (to_scale // 2)) // to_scale
+
+
+class LlrFile:
+    """Random access over an LLR file.
+
+    LLR2 files are read through their block index: only the blocks a query
+    needs are decompressed, and independent blocks can be decoded on worker
+    threads (lzma releases the GIL). LLR1 files have no index, so they are
+    decoded once on open and served as a single block.
+    """
+
+    def __init__(self, path: Path) -> None:
+        self.path = Path(path)
+        with self.path.open("rb") as handle:
+            magic = handle.read(len(XZ_MAGIC))
+        if magic.startswith(MAGIC_V2):
+            self._open_v2()
+        elif magic == XZ_MAGIC:
+            self._open_v1()
+        else:
+            raise ValueError("invalid raw file magic")
+
+    def _open_v1(self) -> None:
+        with lzma.open(self.path, "rb") as handle:
+            self.header = _read_header(handle)
+            payload = handle.read()
+        self.version = VERSION
+        self.block_samples = self.header.sample_count
+        self._v1_values = _decode_varints(payload, self.header.sample_count)
+        low, high, hist = _summarize(self._v1_values)
+        self.blocks = [
+            BlockInfo(-1, 0, 0, len(self._v1_values), low, high, hist)
+        ]
+
+    def _open_v2(self) -> None:
+        with self.path.open("rb") as handle:
+            self.header = _read_header(handle, MAGIC_V2, VERSION_V2)
+            (self.block_samples,) = struct.unpack("<I", handle.read(4))
+            handle.seek(-_TRAILER.size, 2)
+            index_offset, block_count, magic = _TRAILER.unpack(
+                handle.read(_TRAILER.size)
+            )
+            if magic != INDEX_MAGIC:
+                raise ValueError("missing LLR2 block index")
+            handle.seek(index_offset)
+            index = handle.read(block_count * _BLOCK_ENTRY.size)
+        if len(index) != block_count * _BLOCK_ENTRY.size:
+            raise ValueError("truncated LLR2 block index")
+        self.version = VERSION_V2
+        self.blocks = []
+        first = 0
+        for entry in _BLOCK_ENTRY.iter_unpack(index):
+            offset, compressed_len, count, low, high = entry[:5]
+            self.blocks.append(
+                BlockInfo(
+                    offset, compressed_len, first, count, low, high, list(entry[5:])
+                )
+            )
+            first += count
+
+    def __len__(self) -> int:
+        return sum(block.count for block in self.blocks)
+
+    def _scales(self, unit: str) -> Tuple[int, int]:
+        if unit not in UNIT_ENUM:
+            raise ValueError(f"unknown unit: {unit}")
+        return UNIT_SCALE_NS[self.header.unit], UNIT_SCALE_NS[unit]
+
+    def _stored_block(self, index: int) -> List[int]:
+        if self.version == VERSION:
+            return self._v1_values
+        block = self.blocks[index]
+        with self.path.open("rb") as handle:
+            handle.seek(block.offset)
+            payload = handle.read(block.compressed_len)
+        return _decode_block(payload, block.count, self.header.codec)
+
+    def _stored_blocks(
+        self, indices: Sequence[int], workers: Optional[int]
+    ) -> List[List[int]]:
+        if workers == 1 or len(indices) <= 1:
+            return [self._stored_block(index) for index in indices]
+        with ThreadPoolExecutor(max_workers=workers) as pool:
+            return list(pool.map(self._stored_block, indices))
+
+    def read_block(self, index: int, unit: str = "ns") -> List[int]:
+        from_scale, to_scale = self._scales(unit)
+        return [
+            _convert(value, from_scale, to_scale)
+            for value in self._stored_block(index)
+        ]
+
+    def read(
+        self,
+        start: int = 0,
+        stop: Optional[int] = None,
+        unit: str = "ns",
+        workers: Optional[int] = None,
+    ) -> List[int]:
+        """Samples [start, stop) in `unit`, decoding only covering blocks."""
+        total = len(self)
+        stop = total if stop is None else min(stop, total)
+        start = max(0, start)
+        if start >= stop:
+            return []
+        from_scale, to_scale = self._scales(unit)
+        indices = [
+            i
+            for i, block in enumerate(self.blocks)
+            if block.first < stop and block.first + block.count > start
+        ]
+        out: List[int] = []
+        for index, values in zip(indices, self._stored_blocks(indices, workers)):
+            first = self.blocks[index].first
+            lo = max(start - first, 0)
+            hi = min(stop - first, len(values))
+            out.extend(
+                _convert(value, from_scale, to_scale) for value in values[lo:hi]
+            )
+        return out
+
+    def quantile(self, p: float, unit: str = "ns") -> int:
+        """samples_sorted[int(p * (n - 1))], as run_bench computes it.
+
+        The block histograms locate the bucket holding that rank; only blocks
+        with samples in that bucket are decoded.
+        """
+        total = len(self)
+        if total == 0:
+            return 0
+        rank = int(p * (total - 1))
+        bucket_counts = [0] * HIST_BUCKETS
+        for block in self.blocks:
+            for bucket, count in enumerate(block.hist):
+                bucket_counts[bucket] += count
+        below = 0
+        bucket = 0
+        for bucket, count in enumerate(bucket_counts):
+            if below + count > rank:
+                break
+            below += count
+        indices = [i for i, block in enumerate(self.blocks) if block.hist[bucket]]
+        candidates: List[int] = []
+        for values in self._stored_blocks(indices, None):
+            candidates.extend(
+                value
+                for value in values
+                if min(value.bit_length(), HIST_BUCKETS - 1) == bucket
+            )
+        candidates.sort()
+        from_scale, to_scale = self._scales(unit)
+        return _convert(candidates[rank - below], from_scale, to_scale)
+
+    def count_between(self, low_ns: int, high_ns: int) -> int:
+        """Number of samples with low_ns <= value (in ns) <= high_ns.
+
+        Blocks entirely inside or outside the range are answered from their
+        min/max; only straddling blocks are decoded.
+        """
+        scale = UNIT_SCALE_NS[self.header.unit]
+        total = 0
+        partial = []
+        for i, block in enumerate(self.blocks):
+            if block.count == 0:
+                continue
+            if block.max * scale < low_ns or block.min * scale > high_ns:
+                continue
+            if block.min * scale >= low_ns and block.max * scale <= high_ns:
+                total += block.count
+            else:
+                partial.append(i)
+        for values in self._stored_blocks(partial, None):
+            total += sum(1 for value in values if low_ns <= value * scale <= high_ns)
+        return total
+
+
+def read_llr_header(path: Path) -> RawHeader:
+    """Header only; LLR1 decompresses just enough of the stream to reach it."""
+    with Path(path).open("rb") as handle:
+        magic = handle.read(len(XZ_MAGIC))
+    if magic.startswith(MAGIC_V2):
+        with Path(path).open("rb") as handle:
+            return _read_header(handle, MAGIC_V2, VERSION_V2)
     with lzma.open(path, "rb") as handle:
-        header = _read_header(handle)
-        payload = handle.read()
-    if unit not in UNIT_ENUM:
-        raise ValueError(f"unknown unit: {unit}")
+        return _read_header(handle)
+
+
+def open_llr(path: Path) -> LlrFile:
+    return LlrFile(path)
+
+
+def iter_llr_samples(path: Path, unit: str = "ns") -> Iterator[int]:
+    llr = LlrFile(path)
+    for index in range(len(llr.blocks)):
+        yield from llr.read_block(index, unit=unit)
+
+
+def read_llr(
+    path: Path, unit: str = "ns", workers: Optional[int] = None
+) -> Tuple[RawHeader, List[int]]:
+    llr = LlrFile(path)
+    return llr.header, llr.read(unit=unit, workers=workers)
+
+
+def write_raw_bin(
+    samples: Sequence[int], out_path: Path, header: RawHeader, unit: str = "ns"
+) -> RawHeader:
+    unit = _resolve_unit(unit, min(samples) if samples else 0)
+    scale = UNIT_SCALE_NS[unit]
+    values = [(value + (scale // 2)) // scale for value in samples]
+    value_bytes = 4 if not values or max(values) <= 0xFFFFFFFF else 8
+    header.unit = unit
+    header.sample_count = len(values)
+    case_bytes = header.case_name.encode("utf-8")[
+        : RAW_BIN_PAGE - RAW_BIN_HEADER.size
+    ]
+    page = bytearray(RAW_BIN_PAGE)
+    RAW_BIN_HEADER.pack_into(
+        page,
+        0,
+        RAW_BIN_MAGIC,
+        RAW_BIN_VERSION,
+        UNIT_ENUM[unit],
+        value_bytes,
+        RAW_BIN_PAGE,
+        len(values),
+        header.iters,
+        header.warmup,
+        header.pin_cpu,
+        len(case_bytes),
+    )
+    page[RAW_BIN_HEADER.size : RAW_BIN_HEADER.size + len(case_bytes)] = case_bytes
+    fmt = "<I" if value_bytes == 4 else "<Q"
+    with Path(out_path).open("wb") as handle:
+        handle.write(page)
+        handle.write(b"".join(struct.pack(fmt, value) for value in values))
+    return header
+
+
+def _read_raw_bin_header(data: bytes, path: Path) -> Tuple[RawHeader, int, int]:
+    if len(data) < RAW_BIN_PAGE:
+        raise ValueError(f"truncated raw.bin header: {path}")
+    (
+        magic,
+        version,
+        unit_enum,
+        value_bytes,
+        data_offset,
+        sample_count,
+        iters,
+        warmup,
+        pin_cpu,
+        case_len,
+    ) = RAW_BIN_HEADER.unpack_from(data, 0)
+    if magic != RAW_BIN_MAGIC or version != RAW_BIN_VERSION:
+        raise ValueError(f"invalid raw.bin magic or version: {path}")
+    if unit_enum >= len(UNIT_NAMES) or value_bytes not in (4, 8):
+        raise ValueError(f"corrupt raw.bin header: {path}")
+    case_name = bytes(
+        data[RAW_BIN_HEADER.size : RAW_BIN_HEADER.size + case_len]
+    ).decode("utf-8")
+    header = RawHeader(
+        case_name=case_name,
+        tags=[],
+        args=[],
+        iters=iters,
+        warmup=warmup,
+        pin_cpu=pin_cpu,
+        unit=UNIT_NAMES[unit_enum],
+        sample_count=sample_count,
+    )
+    return header, value_bytes, data_offset
+
+
+def open_raw_bin(path: Path):
+    """Map raw.bin without parsing the samples.
+
+    Returns (header, values) where values is a read-only numpy memmap (or a
+    memoryview over an mmap when numpy is unavailable) in header.unit.
+    """
+    path = Path(path)
+    with path.open("rb") as handle:
+        header, value_bytes, data_offset = _read_raw_bin_header(
+            handle.read(RAW_BIN_PAGE), path
+        )
+        if header.sample_count == 0:
+            return header, memoryview(b"").cast("B")
+        try:
+            import numpy as np  # type: ignore
+
+            dtype = np.dtype("<u4" if value_bytes == 4 else "<u8")
+            values = np.memmap(
+                path,
+                dtype=dtype,
+                mode="r",
+                offset=data_offset,
+                shape=(header.sample_count,),
+            )
+            return header, values
+        except ImportError:
+            mapped = mmap.mmap(handle.fileno(), 0, access=mmap.ACCESS_READ)
+    end = data_offset + header.sample_count * value_bytes
+    view = memoryview(mapped)[data_offset:end]
+    return header, view.cast("I" if value_bytes == 4 else "Q")
+
+
+def read_raw_bin(path: Path, unit: str = "ns") -> Tuple[RawHeader, List[int]]:
+    header, values = open_raw_bin(path)
     from_scale = UNIT_SCALE_NS[header.unit]
     to_scale = UNIT_SCALE_NS[unit]
-    samples: List[int] = []
-    offset = 0
-    prev = 0
-    while offset < len(payload) and len(samples) < header.sample_count:
-        raw_value, offset = _read_varint(payload, offset)
-        delta = _zigzag_decode(raw_value)
-        prev += delta
-        ns_value = prev * from_scale
-        samples.append((ns_value + (to_scale // 2)) // to_scale)
+    samples = values.tolist()
+    if from_scale != to_scale:
+        samples = [_convert(value, from_scale, to_scale) for value in samples]
     return header, samples
@@ -4,12 +4,23 @@ from __future__ import annotations
 
 from __future__ import annotations
 
+import argparse
 import csv
 import json
+import subprocess
+import sys
+from array import array
 from pathlib import Path
-from typing import Any, Iterable, List
+from typing import Any, Iterable, List, Optional, Sequence
 
-from raw_format import read_llr, read_raw_csv_list
+from raw_format import (
+    find_llr_tool,
+    open_raw_bin,
+    read_llr,
+    read_raw_bin,
+    read_raw_csv_list,
+)
+from sketch import SKETCH_FILE_NAME, LogHistogram
 
 
 def _load_csv_rows(path: Path) -> List[dict]:
@@ -97,12 +108,46 @@ def filter_runs(
     return filtered
 
 
+def _load_samples_native(path: Path, unit: str) -> Optional[List[int]]:
+    tool = find_llr_tool()
+    if tool is None or sys.byteorder != "little":
+        return None
+    try:
+        result = subprocess.run(
+            [tool, "cat", "--binary", "--unit", unit, str(path)],
+            check=True,
+            capture_output=True,
+        )
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    values = array("Q")
+    values.frombytes(result.stdout)
+    return values.tolist()
+
+
+def map_samples(run_dir: str | Path) -> Any:
+    """Zero-copy view of a run's raw.bin (written by `bench --raw-bin`).
+
+    Returns a read-only numpy memmap in the file's stored unit (ns when the
+    bench wrote it); nothing is parsed or copied until it is indexed.
+    """
+    _header, values = open_raw_bin(Path(run_dir) / "raw.bin")
+    return values
+
+
 def load_samples(run_dir: str | Path, unit: str = "ns") -> List[int]:
     run_dir = Path(run_dir)
-    raw_llr = run_dir / "raw.llr.xz"
-    if raw_llr.exists():
-        _header, samples = read_llr(raw_llr, unit=unit)
+    raw_bin = run_dir / "raw.bin"
+    if raw_bin.exists():
+        _header, samples = read_raw_bin(raw_bin, unit=unit)
         return samples
+    for name in ("raw.llr", "raw.llr.xz"):
+        raw_llr = run_dir / name
+        if raw_llr.exists():
+            samples = _load_samples_native(raw_llr, unit)
+            if samples is None:
+                _header, samples = read_llr(raw_llr, unit=unit)
+            return samples
     raw_csv = run_dir / "raw.csv"
     if raw_csv.exists():
         return read_raw_csv_list(raw_csv)
@@ -114,3 +159,91 @@ def iter_run_dirs(index_rows: Iterable[dict]) -> Iterable[Path]:
         run_dir = row.get("run_dir")
         if run_dir:
             yield Path(run_dir)
+
+
+def load_sketch(run_dir: str | Path) -> LogHistogram:
+    """The run's sketch.json, or one built from its raw samples for runs
+    recorded before sketches existed."""
+    path = Path(run_dir) / SKETCH_FILE_NAME
+    if path.exists():
+        return LogHistogram.load(path)
+    return LogHistogram.from_samples(load_samples(run_dir))
+
+
+def select_runs(
+    index,
+    case: str | None = None,
+    tag: str | None = None,
+    pinned: bool | None = None,
+    noise_mode: str | None = None,
+    last: int | None = None,
+) -> List[dict]:
+    """Index rows matching the filters, oldest first; `last` keeps the most
+    recent N by started_at."""
+    rows = index.to_dict("records") if hasattr(index, "to_dict") else list(index)
+    selected = []
+    for row in rows:
+        if case is not None and row.get("case") != case:
+            continue
+        if tag is not None and tag not in parse_tags(str(row.get("tags") or "")):
+            continue
+        if pinned is not None and (int(row.get("pin_cpu", -1)) >= 0) != pinned:
+            continue
+        if noise_mode is not None and row.get("noise_mode") != noise_mode:
+            continue
+        selected.append(row)
+    selected.sort(key=lambda row: str(row.get("started_at") or ""))
+    if last is not None:
+        selected = selected[-last:] if last > 0 else []
+    return selected
+
+
+def aggregate_runs(rows: Iterable[dict], base: str | Path = ".") -> LogHistogram:
+    """Merge the sketches of `rows` (relative run_dirs resolve against
+    `base`): O(runs), no raw samples decoded."""
+    merged = LogHistogram()
+    for run_dir in iter_run_dirs(rows):
+        merged.merge(load_sketch(Path(base) / run_dir))
+    return merged
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description="Aggregate quantiles across runs by merging sketches."
+    )
+    parser.add_argument("--index", default="results/index.csv", help="Index CSV")
+    parser.add_argument("--case", help="Case name")
+    parser.add_argument("--tag", help="Tag label")
+    parser.add_argument(
+        "--pinned",
+        action=argparse.BooleanOptionalAction,
+        default=None,
+        help="Only pinned (or, with --no-pinned, unpinned) runs",
+    )
+    parser.add_argument("--noise", dest="noise_mode", help="Noise mode")
+    parser.add_argument("--last", type=int, help="Most recent N matching runs")
+    args = parser.parse_args(argv)
+
+    index_path = Path(args.index)
+    rows = select_runs(
+        _load_csv_rows(index_path) if index_path.exists() else [],
+        case=args.case,
+        tag=args.tag,
+        pinned=args.pinned,
+        noise_mode=args.noise_mode,
+        last=args.last,
+    )
+    if not rows:
+        print("no matching runs", file=sys.stderr)
+        return 1
+    merged = aggregate_runs(rows)
+    writer = csv.writer(sys.stdout)
+    stats = merged.quantiles()
+    writer.writerow(["runs", "samples", *stats])
+    stats["mean"] = f"{stats['mean']:.6f}"
+    writer.writerow([len(rows), merged.count, *stats.values()])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
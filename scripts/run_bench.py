@@ -10,7 +10,40 @@ import subprocess
 import sys
 from pathlib import Path
 
-from raw_format import RawHeader, encode_samples_to_llr, read_raw_csv_list
+from raw_format import (
+    VERSION,
+    VERSION_V2,
+    RawHeader,
+    encode_raw_csv_native,
+    encode_samples_to_llr,
+    read_raw_bin,
+    read_raw_csv_list,
+)
+from sketch import SKETCH_FILE_NAME, LogHistogram
+
+
+RAW_FILE_NAMES = {"llr2": "raw.llr", "llr-xz": "raw.llr.xz"}
+
+
+def encode_raw(
+    raw_csv_path: Path,
+    samples: list[int],
+    out_path: Path,
+    header: RawHeader,
+    unit: str,
+    version: int,
+    codec: str,
+) -> RawHeader:
+    """Archive a run's samples with llr_tool when it is available (tens of
+    ms for millions of samples) and the pure-Python encoder otherwise."""
+    encoded = encode_raw_csv_native(
+        raw_csv_path, out_path, header, unit=unit, version=version, codec=codec
+    )
+    if encoded is not None:
+        return encoded
+    return encode_samples_to_llr(
+        samples, out_path, header, unit=unit, version=version, codec=codec
+    )
 
 
 def repo_root() -> Path:
@@ -76,9 +109,21 @@ def parse_args() -> argparse.Namespace:
     parser.add_argument("--tag", action="append", default=[], help="Tag label")
     parser.add_argument(
         "--raw-format",
-        choices=["llr-xz", "none"],
-        default="llr-xz",
-        help="Store compressed raw samples (default: llr-xz).",
+        choices=["llr2", "llr-xz", "none"],
+        default="llr2",
+        help=(
+            "Store compressed raw samples: llr2 (raw.llr, block-indexed, "
+            "default), llr-xz (raw.llr.xz, LLR1), or none."
+        ),
+    )
+    parser.add_argument(
+        "--raw-codec",
+        choices=["xz", "for"],
+        default="xz",
+        help=(
+            "Block codec for llr2: xz (smallest, slow to write) or for "
+            "(delta + frame-of-reference bit packing, fast)."
+        ),
     )
     parser.add_argument(
         "--raw-unit",
@@ -86,6 +131,11 @@ def parse_args() -> argparse.Namespace:
         default="auto",
         help="Unit for compressed raw samples (default: auto).",
     )
+    parser.add_argument(
+        "--raw-bin",
+        action="store_true",
+        help="Have the bench also write raw.bin (uncompressed, mmap-able).",
+    )
     parser.add_argument(
         "--raw-drop-csv",
         action="store_true",
@@ -186,6 +236,7 @@ INDEX_FIELDS = [
     "raw_csv_path",
     "raw_llr_path",
     "raw_unit",
+    "sketch_path",
     "bench_path",
     "bench_args",
     "started_at",
@@ -313,6 +364,8 @@ def main() -> int:
         cmd += ["--noise", args.noise]
     for tag in args.tag:
         cmd += ["--tag", tag]
+    if args.raw_bin:
+        cmd += ["--raw-bin"]
     if args.bench_args:
         extra = args.bench_args
         if extra and extra[0] == "--":
@@ -337,9 +390,13 @@ def main() -> int:
             print(f"raw.csv not found: {raw_csv_path}", file=sys.stderr)
             return 1
         raw_unit = ""
-        samples = read_raw_csv_list(raw_csv_path)
+        raw_bin_path = run_dir / "raw.bin"
+        if raw_bin_path.exists():
+            _bin_header, samples = read_raw_bin(raw_bin_path)
+        else:
+            samples = read_raw_csv_list(raw_csv_path)
+        raw_out_path = run_dir / RAW_FILE_NAMES.get(args.raw_format, "")
         if args.raw_format != "none":
-            raw_out_path = run_dir / "raw.llr.xz"
             header = RawHeader(
                 case_name=args.case,
                 tags=args.tag,
@@ -351,17 +408,24 @@ def main() -> int:
                 sample_count=0,
             )
             try:
-                encoded_header = encode_samples_to_llr(
+                encoded_header = encode_raw(
+                    raw_csv_path,
                     samples,
                     raw_out_path,
                     header,
                     unit=args.raw_unit,
+                    version=VERSION_V2 if args.raw_format == "llr2" else VERSION,
+                    codec=args.raw_codec if args.raw_format == "llr2" else "xz",
                 )
                 raw_unit = encoded_header.unit
             except Exception as exc:
                 print(f"failed to encode raw data: {exc}", file=sys.stderr)
                 return 1
 
+        # Mergeable summary for cross-run queries (results_lib.aggregate_runs).
+        sketch_path = run_dir / SKETCH_FILE_NAME
+        LogHistogram.from_samples(samples).save(sketch_path)
+
         stats = compute_quantiles(samples)
 
         meta_path = run_dir / "meta.json"
@@ -420,10 +484,11 @@ def main() -> int:
                 "meta_path": rel(run_dir / "meta.json"),
                 "stdout_path": rel(stdout_path),
                 "raw_csv_path": rel(raw_csv_path),
-                "raw_llr_path": rel(run_dir / "raw.llr.xz")
+                "raw_llr_path": rel(raw_out_path)
                 if args.raw_format != "none"
                 else "",
                 "raw_unit": raw_unit,
+                "sketch_path": rel(sketch_path),
                 "bench_path": rel(bench_path),
                 "bench_args": json.dumps(extra_args, separators=(",", ":")),
                 "started_at": start_time,
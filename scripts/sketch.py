@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+
+from __future__ import annotations
+
+import json
+from collections import Counter
+from pathlib import Path
+from typing import Dict, Iterable, Optional
+
+# Log-linear histogram: values below 2 * SUB_BUCKETS get their own bucket;
+# above that each power of two is split into SUB_BUCKETS equal buckets, so a
+# bucket's width is at most 1/SUB_BUCKETS of its lower bound (< 0.8% relative
+# error for SUB_BUCKET_BITS = 7). Buckets are identified by a dense integer
+# index, so merging is adding counts and a run's sketch is O(octaves spanned),
+# independent of sample count.
+SKETCH_KIND = "log_linear"
+SUB_BUCKET_BITS = 7
+SUB_BUCKETS = 1 << SUB_BUCKET_BITS
+SKETCH_FILE_NAME = "sketch.json"
+
+
+def bucket_index(value: int) -> int:
+    shift = value.bit_length() - (SUB_BUCKET_BITS + 1)
+    if shift <= 0:
+        return value
+    return shift * SUB_BUCKETS + (value >> shift)
+
+
+def bucket_bounds(index: int) -> tuple[int, int]:
+    """Inclusive [low, high] of the values that map to `index`."""
+    if index < 2 * SUB_BUCKETS:
+        return index, index
+    shift = index // SUB_BUCKETS - 1
+    low = (index - shift * SUB_BUCKETS) << shift
+    return low, low + (1 << shift) - 1
+
+
+class LogHistogram:
+    """Mergeable quantile summary of one or more runs, in nanoseconds."""
+
+    def __init__(self) -> None:
+        self.buckets: Counter = Counter()
+        self.count = 0
+        self.total = 0
+        self.min: Optional[int] = None
+        self.max: Optional[int] = None
+
+    @classmethod
+    def from_samples(cls, samples: Iterable[int]) -> "LogHistogram":
+        sketch = cls()
+        sketch.update(samples)
+        return sketch
+
+    def update(self, samples: Iterable[int]) -> None:
+        values = list(samples)
+        if not values:
+            return
+        self.buckets.update(bucket_index(value) for value in values)
+        self.count += len(values)
+        self.total += sum(values)
+        low, high = min(values), max(values)
+        self.min = low if self.min is None else min(self.min, low)
+        self.max = high if self.max is None else max(self.max, high)
+
+    def merge(self, other: "LogHistogram") -> "LogHistogram":
+        self.buckets.update(other.buckets)
+        self.count += other.count
+        self.total += other.total
+        for name, pick in (("min", min), ("max", max)):
+            mine, theirs = getattr(self, name), getattr(other, name)
+            if theirs is not None:
+                setattr(self, name, theirs if mine is None else pick(mine, theirs))
+        return self
+
+    @property
+    def mean(self) -> float:
+        return self.total / self.count if self.count else 0.0
+
+    def quantile(self, p: float) -> int:
+        """Same rank rule as compute_quantiles: the int(p * (n - 1))-th value.
+
+        Returns the middle of the bucket holding that rank, clamped to the
+        observed min/max, so p=0 and p=1 are exact.
+        """
+        if not self.count:
+            raise ValueError("empty sketch")
+        if not 0.0 <= p <= 1.0:
+            raise ValueError("quantile must be in [0, 1]")
+        rank = int(p * (self.count - 1))
+        seen = 0
+        for index in sorted(self.buckets):
+            seen += self.buckets[index]
+            if seen > rank:
+                low, high = bucket_bounds(index)
+                return min(max((low + high) // 2, self.min), self.max)
+        return self.max
+
+    def quantiles(self) -> Dict[str, float]:
+        """The summary.csv columns, from the sketch."""
+        return {
+            "min": self.min,
+            "p50": self.quantile(0.50),
+            "p95": self.quantile(0.95),
+            "p99": self.quantile(0.99),
+            "p999": self.quantile(0.999),
+            "max": self.max,
+            "mean": self.mean,
+        }
+
+    def to_dict(self) -> dict:
+        return {
+            "kind": SKETCH_KIND,
+            "sub_bucket_bits": SUB_BUCKET_BITS,
+            "unit": "ns",
+            "count": self.count,
+            "sum": self.total,
+            "min": self.min,
+            "max": self.max,
+            "buckets": [[index, self.buckets[index]] for index in sorted(self.buckets)],
+        }
+
+    @classmethod
+    def from_dict(cls, data: dict) -> "LogHistogram":
+        if (
+            data.get("kind") != SKETCH_KIND
+            or data.get("sub_bucket_bits") != SUB_BUCKET_BITS
+        ):
+            raise ValueError("unsupported sketch layout")
+        sketch = cls()
+        sketch.buckets = Counter({int(index): int(n) for index, n in data["buckets"]})
+        sketch.count = int(data["count"])
+        sketch.total = int(data["sum"])
+        sketch.min = data["min"]
+        sketch.max = data["max"]
+        return sketch
+
+    def save(self, path: Path) -> None:
+        Path(path).write_text(json.dumps(self.to_dict(), separators=(",", ":")))
+
+    @classmethod
+    def load(cls, path: Path) -> "LogHistogram":
+        return cls.from_dict(json.loads(Path(path).read_text()))
@@ -85,6 +85,44 @@ bool test_too_many_positionals(int, char**) {
   return true;
 }
 
+bool test_batch_flag(int, char**) {
+  const auto defaults = parse_args({"bench"});
+  CHECK(defaults.ok);
+  CHECK(defaults.options.batch == 0);
+
+  const auto result = parse_args({"bench", "--batch", "64"});
+  CHECK(result.ok);
+  CHECK(result.options.batch == 64);
+  return true;
+}
+
+bool test_batch_zero(int, char**) {
+  const auto result = parse_args({"bench", "--batch", "0"});
+  CHECK(!result.ok);
+  return true;
+}
+
+bool test_param_flag(int, char**) {
+  const auto result = parse_args(
+      {"bench", "--param", "cpus=0,2-3", "--param", "mode=", "--param", "a=b=c"});
+  CHECK(result.ok);
+  CHECK(result.options.params.size() == 3);
+  CHECK(result.options.params[0].first == "cpus");
+  CHECK(result.options.params[0].second == "0,2-3");
+  CHECK(result.options.params[1].first == "mode");
+  CHECK(result.options.params[1].second.empty());
+  CHECK(result.options.params[2].first == "a");
+  CHECK(result.options.params[2].second == "b=c");
+  return true;
+}
+
+bool test_param_missing_key(int, char**) {
+  CHECK(!parse_args({"bench", "--param", "value"}).ok);
+  CHECK(!parse_args({"bench", "--param", "=value"}).ok);
+  CHECK(!parse_args({"bench", "--param"}).ok);
+  return true;
+}
+
 bool test_summary_format_default(int, char**) {
   const auto result = parse_args({"bench"});
   CHECK(result.ok);
@@ -98,6 +136,12 @@ bool test_summary_format_invalid(int, char**) {
   return true;
 }
 
+bool test_raw_bin_flag(int, char**) {
+  CHECK(!parse_args({"bench"}).options.raw_bin);
+  CHECK(parse_args({"bench", "--raw-bin"}).options.raw_bin);
+  return true;
+}
+
 #undef CHECK
 
 }  // namespace
@@ -111,8 +155,13 @@ int main(int argc, char** argv) {
       {"missing_iters_value", test_missing_iters_value},
       {"negative_pin", test_negative_pin},
       {"too_many_positionals", test_too_many_positionals},
+      {"batch_flag", test_batch_flag},
+      {"batch_zero", test_batch_zero},
+      {"param_flag", test_param_flag},
+      {"param_missing_key", test_param_missing_key},
       {"summary_format_default", test_summary_format_default},
       {"summary_format_invalid", test_summary_format_invalid},
+      {"raw_bin_flag", test_raw_bin_flag},
   };
 
   return run_named_tests(cases, argc, argv);
@@ -0,0 +1,218 @@
+#include "llr.h"
+#include "test_harness.h"
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                                \
+      std::cerr << "check failed at line " << __LINE__ << ": "    \
+                << #cond << "\n";                                \
+      return false;                                               \
+    }                                                            \
+  } while (false)
+
+// Mix of 1-byte, mid-size and 9/10-byte varints so both the BMI2 window
+// path and its scalar fallback are exercised.
+std::vector<uint64_t> mixed_values(size_t count) {
+  std::mt19937_64 rng(7);
+  std::vector<uint64_t> values(count);
+  for (uint64_t& value : values) {
+    switch (rng() % 4) {
+      case 0:
+        value = rng() % 64;
+        break;
+      case 1:
+        value = rng() % 1'000'000;
+        break;
+      case 2:
+        value = rng();
+        break;
+      default:
+        value = 5;
+        break;
+    }
+  }
+  return values;
+}
+
+std::string temp_path(const char* name) {
+  return std::string("/tmp/llr_tests_") + name;
+}
+
+bool test_varint_roundtrip(int, char**) {
+  const std::vector<uint64_t> values = mixed_values(10'000);
+  std::vector<uint8_t> bytes;
+  encode_varint_deltas(values.data(), values.size(), &bytes);
+  std::vector<uint64_t> decoded(values.size());
+  CHECK(decode_varint_deltas(bytes.data(), bytes.size(), decoded.size(),
+                             decoded.data()) == values.size());
+  CHECK(decoded == values);
+  return true;
+}
+
+bool test_varint_truncated(int, char**) {
+  const std::vector<uint64_t> values = {1, 300, 70'000};
+  std::vector<uint8_t> bytes;
+  encode_varint_deltas(values.data(), values.size(), &bytes);
+  bytes.pop_back();
+  std::vector<uint64_t> decoded(values.size());
+  CHECK(decode_varint_deltas(bytes.data(), bytes.size(), decoded.size(),
+                             decoded.data()) == 2);
+  return true;
+}
+
+bool test_varint_long_late(int, char**) {
+  // Long single-byte runs, then 9/10-byte deltas near the end with short
+  // runs between them: each long varint must fall back on its own and the
+  // window path resume after it.
+  std::vector<uint64_t> values(5'000, 3);
+  for (size_t i = 4'000; i < values.size(); i += 7) {
+    values[i] = uint64_t{1} << (56 + i % 8);
+  }
+  std::vector<uint8_t> bytes;
+  encode_varint_deltas(values.data(), values.size(), &bytes);
+  std::vector<uint64_t> decoded(values.size());
+  CHECK(decode_varint_deltas(bytes.data(), bytes.size(), decoded.size(),
+                             decoded.data()) == values.size());
+  CHECK(decoded == values);
+  return true;
+}
+
+bool test_for_roundtrip(int, char**) {
+  // Partial last frame, constant frames (width 0) and full 64-bit deltas.
+  std::vector<uint64_t> values = mixed_values(1'000);
+  values.insert(values.end(), 300, 42);
+  values.push_back(~uint64_t{0});
+  values.push_back(0);
+  std::vector<uint8_t> bytes;
+  encode_for_frames(values.data(), values.size(), &bytes);
+  std::vector<uint64_t> decoded(values.size());
+  CHECK(decode_for_frames(bytes.data(), bytes.size(), decoded.size(),
+                          decoded.data()) == values.size());
+  CHECK(decoded == values);
+  bytes.resize(bytes.size() - 1);
+  CHECK(decode_for_frames(bytes.data(), bytes.size(), decoded.size(),
+                          decoded.data()) < values.size());
+  return true;
+}
+
+bool roundtrip_file(uint32_t version,
+                    unsigned threads,
+                    LlrCodec codec = LlrCodec::kXz) {
+  LlrHeader header;
+  header.version = version;
+  header.codec = codec;
+  header.block_samples = 1000;
+  header.case_name = "noop";
+  header.tags = {"quiet"};
+  header.args = {"--iters", "5"};
+  header.iters = 5;
+  header.pin_cpu = 2;
+  header.unit = LlrUnit::kUs;
+  const std::vector<uint64_t> values = mixed_values(4'321);
+  const std::string path = temp_path(version == kLlrVersion1 ? "v1" : "v2");
+  std::string error;
+  CHECK(write_llr_file(path, header, values, &error));
+
+  LlrHeader read_header;
+  std::vector<uint64_t> read_values;
+  CHECK(read_llr_file(path, threads, &read_header, &read_values, &error));
+  std::remove(path.c_str());
+  CHECK(read_values == values);
+  CHECK(read_header.version == version);
+  CHECK(read_header.codec == codec);
+  CHECK(read_header.unit == LlrUnit::kUs);
+  CHECK(read_header.case_name == "noop");
+  CHECK(read_header.tags == header.tags);
+  CHECK(read_header.args == header.args);
+  CHECK(read_header.pin_cpu == 2);
+  CHECK(read_header.sample_count == values.size());
+  return true;
+}
+
+bool test_file_v1(int, char**) {
+  return roundtrip_file(kLlrVersion1, 1);
+}
+
+bool test_file_v2_threads(int, char**) {
+  return roundtrip_file(kLlrVersion2, 4);
+}
+
+bool test_file_v2_for(int, char**) {
+  return roundtrip_file(kLlrVersion2, 2, LlrCodec::kFor);
+}
+
+bool test_bad_magic(int, char**) {
+  const std::string path = temp_path("bad");
+  FILE* file = std::fopen(path.c_str(), "wb");
+  CHECK(file != nullptr);
+  std::fputs("nope", file);
+  std::fclose(file);
+  LlrHeader header;
+  std::vector<uint64_t> values;
+  std::string error;
+  CHECK(!read_llr_file(path, 1, &header, &values, &error));
+  CHECK(!error.empty());
+  std::remove(path.c_str());
+  return true;
+}
+
+bool test_index_offset_overflow(int, char**) {
+  // An index offset near 2^64 must not wrap past the bounds check.
+  LlrHeader header;
+  header.version = kLlrVersion2;
+  header.case_name = "noop";
+  const std::vector<uint64_t> values = mixed_values(100);
+  const std::string path = temp_path("overflow");
+  std::string error;
+  CHECK(write_llr_file(path, header, values, &error));
+  FILE* file = std::fopen(path.c_str(), "r+b");
+  CHECK(file != nullptr);
+  const uint64_t bad_offset = ~uint64_t{0} - 8;
+  CHECK(std::fseek(file, -16, SEEK_END) == 0);
+  CHECK(std::fwrite(&bad_offset, sizeof(bad_offset), 1, file) == 1);
+  std::fclose(file);
+  LlrHeader read_header;
+  std::vector<uint64_t> read_values;
+  CHECK(!read_llr_file(path, 1, &read_header, &read_values, &error));
+  CHECK(!error.empty());
+  std::remove(path.c_str());
+  return true;
+}
+
+bool test_unit_convert(int, char**) {
+  CHECK(llr_convert(1'499, LlrUnit::kNs, LlrUnit::kUs) == 1);
+  CHECK(llr_convert(1'500, LlrUnit::kNs, LlrUnit::kUs) == 2);
+  CHECK(llr_convert(3, LlrUnit::kMs, LlrUnit::kNs) == 3'000'000);
+  CHECK(llr_unit_from_min(99'999) == LlrUnit::kNs);
+  CHECK(llr_unit_from_min(100'000) == LlrUnit::kUs);
+  return true;
+}
+
+#undef CHECK
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::vector<TestCase> cases = {
+      {"varint_roundtrip", test_varint_roundtrip},
+      {"varint_truncated", test_varint_truncated},
+      {"varint_long_late", test_varint_long_late},
+      {"for_roundtrip", test_for_roundtrip},
+      {"file_v1", test_file_v1},
+      {"file_v2_threads", test_file_v2_threads},
+      {"file_v2_for", test_file_v2_for},
+      {"bad_magic", test_bad_magic},
+      {"index_offset_overflow", test_index_offset_overflow},
+      {"unit_convert", test_unit_convert},
+  };
+
+  return run_named_tests(cases, argc, argv);
+}
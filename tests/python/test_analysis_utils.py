@@ -0,0 +1,33 @@
+from __future__ import annotations
+
+import math
+from pathlib import Path
+
+import pytest
+
+pd = pytest.importorskip("pandas")
+
+from analysis_utils import load_c2c_matrix
+
+
+def test_load_c2c_matrix_mirrors_pairs(tmp_path: Path) -> None:
+    path = tmp_path / "matrix.csv"
+    path.write_text(
+        "cpu_a,cpu_b,samples,min,p50,p95,p99,p999,max,mean\n"
+        "0,1,10,40,50,60,70,80,90,55.00\n"
+        "0,2,10,100,120,130,140,150,160,125.00\n"
+    )
+    matrix = load_c2c_matrix(path, metric="p50")
+    assert list(matrix.index) == [0, 1, 2]
+    assert matrix.loc[0, 1] == 50
+    assert matrix.loc[1, 0] == 50
+    assert matrix.loc[2, 0] == 120
+    assert math.isnan(matrix.loc[1, 2])
+    assert math.isnan(matrix.loc[0, 0])
+
+
+def test_load_c2c_matrix_unknown_metric(tmp_path: Path) -> None:
+    path = tmp_path / "matrix.csv"
+    path.write_text("cpu_a,cpu_b,samples,p50\n0,1,1,5\n")
+    with pytest.raises(ValueError):
+        load_c2c_matrix(path, metric="p42")
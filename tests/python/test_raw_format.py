@@ -2,6 +2,8 @@ from __future__ import annotations
 
 from pathlib import Path
 
+import pytest
+
 import raw_format as rf
 
 
@@ -61,3 +63,116 @@ def test_read_raw_csv_list(tmp_path: Path) -> None:
     raw_path = tmp_path / "raw.csv"
     raw_path.write_text("iter,ns\n0,10\n1,20\n2,30\n")
     assert rf.read_raw_csv_list(raw_path) == [10, 20, 30]
+
+
+def _header() -> rf.RawHeader:
+    return rf.RawHeader(
+        case_name="noop",
+        tags=["quiet"],
+        args=[],
+        iters=0,
+        warmup=0,
+        pin_cpu=-1,
+        unit="ns",
+        sample_count=0,
+    )
+
+
+def test_llr2_roundtrip_across_blocks(tmp_path: Path) -> None:
+    samples = [(i * 7919) % 5000 + 10 for i in range(1000)]
+    out_path = tmp_path / "raw.llr"
+    rf.encode_samples_to_llr(
+        samples, out_path, _header(), unit="ns", version=2, block_samples=64
+    )
+    read_header, decoded = rf.read_llr(out_path, unit="ns", workers=4)
+    assert decoded == samples
+    assert read_header.case_name == "noop"
+    assert read_header.tags == ["quiet"]
+    assert read_header.sample_count == len(samples)
+    assert list(rf.iter_llr_samples(out_path)) == samples
+
+    llr = rf.open_llr(out_path)
+    assert len(llr.blocks) == 16
+    assert llr.blocks[-1].count == 1000 - 15 * 64
+    assert llr.read(990) == samples[990:]
+    assert llr.read(60, 70) == samples[60:70]
+
+
+def test_llr2_summary_queries_match_full_decode(tmp_path: Path) -> None:
+    samples = [(i * 104729) % 100_000 for i in range(3000)]
+    out_path = tmp_path / "raw.llr"
+    rf.encode_samples_to_llr(
+        samples, out_path, _header(), unit="ns", version=2, block_samples=256
+    )
+    llr = rf.open_llr(out_path)
+    ordered = sorted(samples)
+    for p in (0.0, 0.5, 0.99, 0.999, 1.0):
+        assert llr.quantile(p) == ordered[int(p * (len(samples) - 1))]
+    expected = sum(1 for value in samples if 1000 <= value <= 50_000)
+    assert llr.count_between(1000, 50_000) == expected
+    assert llr.count_between(0, 1 << 40) == len(samples)
+
+
+def test_llr_file_reads_llr1(tmp_path: Path) -> None:
+    samples = [5, 3, 9, 1]
+    out_path = tmp_path / "raw.llr.xz"
+    rf.encode_samples_to_llr(samples, out_path, _header(), unit="ns")
+    llr = rf.open_llr(out_path)
+    assert llr.version == 1
+    assert llr.read() == samples
+    assert llr.quantile(0.5) == 3
+    assert llr.count_between(3, 5) == 2
+
+
+def test_raw_bin_roundtrip(tmp_path: Path) -> None:
+    samples = [0, 7, 1_000, 2**33, 5]
+    header = rf.RawHeader(
+        case_name="noop",
+        tags=[],
+        args=[],
+        iters=len(samples),
+        warmup=3,
+        pin_cpu=1,
+        unit="ns",
+        sample_count=0,
+    )
+    path = tmp_path / "raw.bin"
+    rf.write_raw_bin(samples, path, header)
+    assert path.stat().st_size == rf.RAW_BIN_PAGE + 8 * len(samples)
+    loaded_header, values = rf.open_raw_bin(path)
+    assert list(values) == samples
+    assert loaded_header.case_name == "noop"
+    assert loaded_header.warmup == 3
+    assert loaded_header.pin_cpu == 1
+    assert rf.read_raw_bin(path, unit="us")[1] == [0, 0, 1, 8589935, 0]
+
+
+def test_raw_bin_narrow_values(tmp_path: Path) -> None:
+    samples = [10, 20, 30]
+    header = rf.RawHeader("x", [], [], 3, 0, -1, "ns", 0)
+    path = tmp_path / "raw.bin"
+    rf.write_raw_bin(samples, path, header)
+    assert path.stat().st_size == rf.RAW_BIN_PAGE + 4 * len(samples)
+    assert rf.read_raw_bin(path)[1] == samples
+
+
+def test_llr2_for_codec_roundtrip(tmp_path: Path) -> None:
+    samples = [50, 52, 49, 10_000, 51] * 60 + [2**62, 0, 7]
+    header = rf.RawHeader("noop", [], [], len(samples), 0, -1, "ns", 0)
+    path = tmp_path / "raw.llr"
+    rf.encode_samples_to_llr(
+        samples, path, header, unit="ns", version=2, block_samples=100, codec="for"
+    )
+    llr = rf.open_llr(path)
+    assert llr.header.codec == "for"
+    assert llr.read() == samples
+    assert llr.read_block(3) == samples[300:]
+    assert llr.quantile(0.5) == sorted(samples)[(len(samples) - 1) // 2]
+
+
+def test_for_codec_requires_llr2(tmp_path: Path) -> None:
+    header = rf.RawHeader("noop", [], [], 1, 0, -1, "ns", 0)
+    with pytest.raises(ValueError):
+        rf.encode_samples_to_llr(
+            [1], tmp_path / "raw.llr.xz", header, unit="ns", codec="for"
+        )
@@ -1,9 +1,23 @@
 from __future__ import annotations
 
+import random
 from pathlib import Path
 
+import pytest
+
 import raw_format as rf
-from results_lib import filter_runs, load_samples, parse_tags
+from results_lib import (
+    _load_samples_native,
+    aggregate_runs,
+    filter_runs,
+    find_llr_tool,
+    load_samples,
+    load_sketch,
+    map_samples,
+    parse_tags,
+    select_runs,
+)
+from sketch import LogHistogram, bucket_bounds, bucket_index
 
 
 def test_parse_tags() -> None:
@@ -43,3 +57,106 @@ def test_load_samples_prefers_llr(tmp_path: Path) -> None:
     loaded = load_samples(run_dir, unit="ns")
     assert loaded == samples
 
+
+def test_load_samples_reads_llr2(tmp_path: Path) -> None:
+    run_dir = tmp_path / "run"
+    run_dir.mkdir()
+    samples = [1000, 2000, 3000]
+    header = rf.RawHeader(
+        case_name="noop",
+        tags=[],
+        args=[],
+        iters=len(samples),
+        warmup=0,
+        pin_cpu=-1,
+        unit="ns",
+        sample_count=0,
+    )
+    rf.encode_samples_to_llr(
+        samples, run_dir / "raw.llr", header, unit="ns", version=2
+    )
+    assert load_samples(run_dir, unit="ns") == samples
+
+
+def test_load_samples_native_matches_python(tmp_path: Path) -> None:
+    tool = find_llr_tool()
+    if tool is None:
+        pytest.skip("llr_tool not built")
+    run_dir = tmp_path / "run"
+    run_dir.mkdir()
+    samples = [5, 1_000, 3, 2**40, 7] * 50
+    header = rf.RawHeader(
+        case_name="noop",
+        tags=[],
+        args=[],
+        iters=len(samples),
+        warmup=0,
+        pin_cpu=-1,
+        unit="ns",
+        sample_count=0,
+    )
+    rf.encode_samples_to_llr(
+        samples, run_dir / "raw.llr", header, unit="ns", version=2, block_samples=64
+    )
+    assert _load_samples_native(run_dir / "raw.llr", "ns") == samples
+    assert _load_samples_native(run_dir / "raw.llr", "us") == rf.read_llr(
+        run_dir / "raw.llr", unit="us"
+    )[1]
+
+
+def test_load_samples_prefers_raw_bin(tmp_path: Path) -> None:
+    run_dir = tmp_path / "run"
+    run_dir.mkdir()
+    samples = [40, 50, 60]
+    header = rf.RawHeader("noop", [], [], 3, 0, -1, "ns", 0)
+    rf.write_raw_bin(samples, run_dir / "raw.bin", header)
+    (run_dir / "raw.csv").write_text("iter,ns\n0,1\n")
+    assert load_samples(run_dir) == samples
+    assert list(map_samples(run_dir)) == samples
+
+
+def test_sketch_merge_matches_exact_quantiles(tmp_path: Path) -> None:
+    random.seed(5)
+    runs = [[random.randint(40, 5_000) for _ in range(2_000)] for _ in range(3)]
+    rows = []
+    for i, samples in enumerate(runs):
+        run_dir = tmp_path / f"run{i}"
+        run_dir.mkdir()
+        LogHistogram.from_samples(samples).save(run_dir / "sketch.json")
+        rows.append(
+            {
+                "case": "noop",
+                "tags": '["quiet"]',
+                "pin_cpu": "2" if i else "-1",
+                "run_dir": str(run_dir),
+                "started_at": f"2026-01-0{i + 1}T00:00:00",
+            }
+        )
+    selected = select_runs(rows, case="noop", pinned=True, last=5)
+    assert [row["run_dir"] for row in selected] == [rows[1]["run_dir"], rows[2]["run_dir"]]
+    merged = aggregate_runs(selected)
+    exact = sorted(runs[1] + runs[2])
+    assert merged.count == len(exact)
+    assert merged.min == exact[0] and merged.max == exact[-1]
+    for p in (0.5, 0.99, 0.999):
+        value = exact[int(p * (len(exact) - 1))]
+        assert abs(merged.quantile(p) - value) <= value / 128
+    assert select_runs(rows, last=1) == [rows[2]]
+
+
+def test_load_sketch_falls_back_to_samples(tmp_path: Path) -> None:
+    run_dir = tmp_path / "run"
+    run_dir.mkdir()
+    (run_dir / "raw.csv").write_text("iter,ns\n0,10\n1,300\n")
+    sketch = load_sketch(run_dir)
+    assert sketch.count == 2
+    assert sketch.quantile(0.0) == 10
+    assert sketch.quantile(1.0) == 300
+
+
+def test_bucket_bounds_cover_values() -> None:
+    for value in [0, 1, 255, 256, 257, 511, 512, 10**6, 2**63 + 12345]:
+        low, high = bucket_bounds(bucket_index(value))
+        assert low <= value <= high
+        assert high - low <= max(low // 128, 0) + 1
+    assert bucket_index(255) < bucket_index(256) < bucket_index(258)
@@ -3,7 +3,10 @@ from __future__ import annotations
 import csv
 from pathlib import Path
 
-from run_bench import append_index_csv, compute_quantiles, write_summary_csv
+import pytest
+
+import raw_format as rf
+from run_bench import append_index_csv, compute_quantiles, encode_raw, write_summary_csv
 
 
 def test_compute_quantiles_basic() -> None:
@@ -78,3 +81,47 @@ def test_append_index_csv(tmp_path: Path) -> None:
         reader = csv.reader(handle)
         rows = list(reader)
     assert len(rows) == 3
+
+
+def _write_raw_csv(path: Path, samples: list[int]) -> None:
+    path.write_text("iter,ns\n" + "".join(f"{i},{v}\n" for i, v in enumerate(samples)))
+
+
+def _header() -> rf.RawHeader:
+    return rf.RawHeader("noop", ["quiet"], ["--param", "x=1"], 400, 10, 2, "ns", 0)
+
+
+@pytest.mark.parametrize("tool", ["", "/nonexistent/llr_tool"])
+def test_encode_raw_python_fallback(
+    tmp_path: Path, monkeypatch: pytest.MonkeyPatch, tool: str
+) -> None:
+    monkeypatch.setenv("LLR_TOOL", tool)
+    samples = [50, 52, 49, 10_000] * 100
+    _write_raw_csv(tmp_path / "raw.csv", samples)
+    out = tmp_path / "raw.llr"
+    header = encode_raw(tmp_path / "raw.csv", samples, out, _header(), "ns", 2, "for")
+    assert header.codec == "for"
+    assert rf.read_llr(out)[1] == samples
+
+
+def test_encode_raw_native_matches_python(tmp_path: Path) -> None:
+    if rf.find_llr_tool() is None:
+        pytest.skip("llr_tool not built")
+    samples = [50, 52, 49, 10_000] * 100
+    _write_raw_csv(tmp_path / "raw.csv", samples)
+    for codec in ("for", "xz"):
+        native = rf.encode_raw_csv_native(
+            tmp_path / "raw.csv", tmp_path / "native.llr", _header(), version=2, codec=codec
+        )
+        assert native is not None
+        rf.encode_samples_to_llr(
+            samples, tmp_path / "py.llr", _header(), version=2, codec=codec
+        )
+        if codec == "for":
+            assert (tmp_path / "native.llr").read_bytes() == (
+                tmp_path / "py.llr"
+            ).read_bytes()
+        # liblzma's one-shot encoder records block sizes that Python's
+        # streaming encoder omits, so xz payloads decode equal but differ.
+        assert rf.read_llr(tmp_path / "native.llr")[1] == samples
+        assert native.pin_cpu == 2 and native.args == ["--param", "x=1"]
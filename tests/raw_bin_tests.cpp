@@ -0,0 +1,148 @@
+#include "raw_bin.h"
+#include "test_harness.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                                \
+      std::cerr << "check failed at line " << __LINE__ << ": "    \
+                << #cond << "\n";                                \
+      return false;                                               \
+    }                                                            \
+  } while (false)
+
+std::string temp_path(const char* name) {
+  return std::string("/tmp/raw_bin_tests_") + name;
+}
+
+std::vector<uint8_t> read_bytes(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+}
+
+template <typename T>
+T field(const std::vector<uint8_t>& bytes, size_t offset) {
+  T value;
+  std::memcpy(&value, bytes.data() + offset, sizeof(value));
+  return value;
+}
+
+RawBinHeader test_header() {
+  RawBinHeader header;
+  header.unit = 1;
+  header.case_name = "noop";
+  header.iters = 1000;
+  header.warmup = 10;
+  header.pin_cpu = 3;
+  return header;
+}
+
+// Writes `samples`, then checks the on-disk layout and the mapped view.
+bool roundtrip(const char* name,
+               const std::vector<uint64_t>& samples,
+               unsigned value_bytes) {
+  const std::string path = temp_path(name);
+  const RawBinHeader header = test_header();
+  std::string error;
+  CHECK(write_raw_bin(path, header, samples, &error));
+  CHECK(is_raw_bin_file(path));
+
+  const std::vector<uint8_t> bytes = read_bytes(path);
+  CHECK(bytes.size() == kRawBinHeaderBytes + samples.size() * value_bytes);
+  CHECK(std::memcmp(bytes.data(), "LLRB", 4) == 0);
+  CHECK(bytes[4] == kRawBinVersion);
+  CHECK(bytes[5] == header.unit);
+  CHECK(field<uint16_t>(bytes, 6) == value_bytes);
+  CHECK(field<uint64_t>(bytes, 8) == kRawBinHeaderBytes);
+  CHECK(field<uint64_t>(bytes, 16) == samples.size());
+  CHECK(field<uint64_t>(bytes, 24) == header.iters);
+  CHECK(field<uint64_t>(bytes, 32) == header.warmup);
+  CHECK(field<int32_t>(bytes, 40) == header.pin_cpu);
+  CHECK(field<uint32_t>(bytes, 44) == header.case_name.size());
+  CHECK(std::memcmp(bytes.data() + 48, "noop", 4) == 0);
+
+  MappedRawBin mapped;
+  CHECK(mapped.open(path, &error));
+  std::remove(path.c_str());
+  CHECK(mapped.value_bytes() == value_bytes);
+  CHECK(mapped.size() == samples.size());
+  CHECK(reinterpret_cast<uintptr_t>(mapped.data()) % 4096 == 0);
+  CHECK(mapped.header().unit == header.unit);
+  CHECK(mapped.header().case_name == header.case_name);
+  CHECK(mapped.header().iters == header.iters);
+  CHECK(mapped.header().warmup == header.warmup);
+  CHECK(mapped.header().pin_cpu == header.pin_cpu);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    CHECK(mapped[i] == samples[i]);
+  }
+  return true;
+}
+
+bool test_u32_roundtrip(int, char**) {
+  // Crosses the writer's 1024-value narrowing chunks.
+  std::vector<uint64_t> samples(2'500);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = i * 1'000;
+  }
+  samples.back() = UINT32_MAX;
+  return roundtrip("u32", samples, 4);
+}
+
+bool test_u64_roundtrip(int, char**) {
+  std::vector<uint64_t> samples = {7, 0, uint64_t{UINT32_MAX} + 1, 42};
+  return roundtrip("u64", samples, 8);
+}
+
+bool test_empty(int, char**) {
+  return roundtrip("empty", {}, 4);
+}
+
+bool test_truncated(int, char**) {
+  const std::string path = temp_path("truncated");
+  std::string error;
+  CHECK(write_raw_bin(path, test_header(), {1, 2, 3}, &error));
+  std::vector<uint8_t> bytes = read_bytes(path);
+  bytes.resize(kRawBinHeaderBytes - 1);
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      .write(reinterpret_cast<const char*>(bytes.data()),
+             static_cast<std::streamsize>(bytes.size()));
+  MappedRawBin mapped;
+  CHECK(!mapped.open(path, &error));
+  CHECK(!error.empty());
+  std::remove(path.c_str());
+  return true;
+}
+
+bool test_not_raw_bin(int, char**) {
+  const std::string path = temp_path("csv");
+  std::ofstream(path) << "value\n1\n";
+  CHECK(!is_raw_bin_file(path));
+  std::remove(path.c_str());
+  return true;
+}
+
+#undef CHECK
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::vector<TestCase> cases = {
+      {"u32_roundtrip", test_u32_roundtrip},
+      {"u64_roundtrip", test_u64_roundtrip},
+      {"empty", test_empty},
+      {"truncated", test_truncated},
+      {"not_raw_bin", test_not_raw_bin},
+  };
+
+  return run_named_tests(cases, argc, argv);
+}
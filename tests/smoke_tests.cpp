@@ -154,6 +154,9 @@ bool smoke_noop(int argc, char** argv) {
       "\"command_line\"",
       "\"compiler_version\"",
       "\"build_flags\"",
+      "\"cpu_mitigations\"",
+      "\"batch\"",
+      "\"metrics\"",
       "\"pinning\"",
       "\"tags\"",
   };
@@ -188,6 +191,64 @@ bool smoke_noop(int argc, char** argv) {
   return true;
 }
 
+// A case that cannot run on the host (here: c2c_latency with a single CPU)
+// must still exit cleanly and leave the usual outputs, marked as skipped.
+bool smoke_skipped_case(int argc, char** argv) {
+  if (argc < 1) {
+    std::cerr << "smoke test requires bench executable path\n";
+    return false;
+  }
+
+  const std::filesystem::path bench_path(argv[0]);
+  std::filesystem::path out_dir;
+  std::string error;
+  if (!make_out_dir(&out_dir, &error)) {
+    std::cerr << "failed to create temp dir: " << error << "\n";
+    return false;
+  }
+
+  const std::string cmd = "\"" + bench_path.string() +
+                          "\" --case c2c_latency --param cpus=0 --iters 1"
+                          " --warmup 0 --out \"" +
+                          out_dir.string() + "\" > /dev/null";
+  if (std::system(cmd.c_str()) != 0) {
+    std::cerr << "bench invocation failed: " << cmd << "\n";
+    return false;
+  }
+
+  std::string raw_contents;
+  if (!read_file_contents(out_dir / "raw.csv", &raw_contents, &error)) {
+    std::cerr << "missing raw.csv for skipped run\n";
+    return false;
+  }
+  if (raw_contents != "iter,ns\n") {
+    std::cerr << "skipped run should write a header-only raw.csv\n";
+    return false;
+  }
+
+  std::string meta_contents;
+  if (!read_file_contents(out_dir / "meta.json", &meta_contents, &error)) {
+    std::cerr << "missing meta.json for skipped run\n";
+    return false;
+  }
+  if (meta_contents.find("\"skipped\": true") == std::string::npos ||
+      meta_contents.find("\"skip_reason\"") == std::string::npos) {
+    std::cerr << "meta.json does not record the skip\n";
+    return false;
+  }
+
+  std::string stdout_contents;
+  if (!read_file_contents(out_dir / "stdout.txt", &stdout_contents, &error) ||
+      stdout_contents.find("skipped") == std::string::npos) {
+    std::cerr << "stdout.txt does not mention the skip\n";
+    return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(out_dir, ec);
+  return true;
+}
+
 #if defined(__linux__)
 // Pick any allowed CPU from the current affinity mask.
 int first_allowed_cpu(std::string* error) {
@@ -371,6 +432,7 @@ bool smoke_pin_affinity(int argc, char** argv) {
 int main(int argc, char** argv) {
   const std::vector<TestCase> cases = {
       {"noop_smoke", smoke_noop},
+      {"skipped_case", smoke_skipped_case},
       {"pin_affinity", smoke_pin_affinity},
   };
 